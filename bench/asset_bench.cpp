@@ -0,0 +1,115 @@
+// مقارنة بين طريقتين لتحميل نفس ال textures:
+//     files: ملف PPM لكل texture، بيتقري و يتحول RGBA (read_ppm) و بعدين glTexImage2D من الميموري
+//     pack:  asset pack واحد بـ mmap و AssetLoader (loader thread + PBOs)
+// الملفات بتتكتب في directory مؤقت الاول، فغالبا الاتنين بيقروا من ال page cache
+// يعني الفرق هو ال parsing و النسخ، مش الديسك
+//
+//     ./asset_bench [textures] [size] [directory]
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <glad/glad.h>
+
+#include "asset_loader.h"
+#include "asset_pack.h"
+#include "gl_context.h"
+#include "gl_handle.h"
+#include "image_writer.h"
+
+using namespace std;
+
+static double elapsed_ms(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+static void print_result(const char *name, size_t textures, double megabytes, double ms)
+{
+    cout << "  " << name << ": " << textures << " textures, " << megabytes << " MB in " << ms << " ms ("
+         << (ms > 0.0 ? megabytes / (ms / 1000.0) : 0.0) << " MB/s)\n";
+}
+
+int main(int argc, char **argv)
+{
+    size_t texture_count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 64;
+    int size = argc > 2 ? atoi(argv[2]) : 512;
+    string directory = argc > 3 ? argv[3] : "asset_bench_data";
+    if (texture_count < 1)
+        texture_count = 1;
+    if (size < 1)
+        size = 1;
+
+    GLContextOptions options;
+    options.headless = true;
+    GLContext context;
+    if (!context.create(options))
+        return -1;
+
+    // نفس ال textures في ملفات PPM و في pack واحد
+    error_code ec;
+    filesystem::create_directories(directory, ec);
+    AssetPackWriter writer;
+    vector<uint8_t> pixels((size_t)size * size * 4);
+    for (size_t i = 0; i < texture_count; i++)
+    {
+        for (size_t p = 0; p < pixels.size(); p++)
+            pixels[p] = (p % 4 == 3) ? 255 : (uint8_t)(p * 7 + i * 13);
+
+        string name = "texture" + to_string(i);
+        if (!write_ppm(directory + "/" + name + ".ppm", size, size, pixels.data(), false) ||
+            !writer.addTexture(name, size, size, pixels.data()))
+            return -1;
+    }
+    string pack_path = directory + "/textures.pak";
+    if (!writer.write(pack_path))
+        return -1;
+
+    double megabytes = texture_count * pixels.size() / (1024.0 * 1024.0);
+    cout << "Asset loading (" << texture_count << " x " << size << "x" << size << " RGBA8):\n";
+
+    // files: read + parse + upload من الميموري
+    {
+        vector<GLTexture> textures(texture_count);
+        auto start = chrono::steady_clock::now();
+        int width = 0, height = 0;
+        vector<uint8_t> rgba;
+        for (size_t i = 0; i < texture_count; i++)
+        {
+            if (!read_ppm(directory + "/texture" + to_string(i) + ".ppm", width, height, rgba))
+                return -1;
+            textures[i] = GLTexture::create();
+            glBindTexture(GL_TEXTURE_2D, textures[i].get());
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glFinish();
+        print_result("files", texture_count, megabytes, elapsed_ms(start));
+    }
+
+    // pack: mmap + loader thread + PBOs
+    {
+        auto start = chrono::steady_clock::now();
+        AssetPack pack;
+        AssetLoader loader;
+        if (!pack.open(pack_path) || !loader.init(pack))
+            return -1;
+        loader.requestAll();
+        loader.finish();
+        glFinish();
+        print_result("pack ", texture_count, megabytes, elapsed_ms(start));
+        loader.printStats(cout);
+        loader.destroy();
+    }
+
+    // بنمسح الملفات اللي عملناها بس، و ال directory لو بقي فاضي
+    for (size_t i = 0; i < texture_count; i++)
+        filesystem::remove(directory + "/texture" + to_string(i) + ".ppm", ec);
+    filesystem::remove(pack_path, ec);
+    filesystem::remove(directory, ec);
+    context.destroy();
+    return 0;
+}
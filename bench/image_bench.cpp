@@ -0,0 +1,113 @@
+// image kernels (image_kernels.h): السرعة بس، MP/s لكل kernel علي thread واحد و علي كل ال pool
+//     (المقارنة بال scalar في tests/image_kernels_test.cpp)
+//
+//     ./image_bench [size] [threads]
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "image_kernels.h"
+#include "thread_pool.h"
+
+using namespace std;
+
+static double elapsed_ms(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// نفس صورة texture_bench: تدرج + دواير + noise، و alpha متدرج
+static vector<uint8_t> make_image(int width, int height)
+{
+    vector<uint8_t> rgba((size_t)width * height * 4);
+    uint32_t noise = 12345;
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            noise = noise * 1664525u + 1013904223u;
+            float u = (float)x / width, v = (float)y / height;
+            float ring = sinf(sqrtf((u - 0.5f) * (u - 0.5f) + (v - 0.5f) * (v - 0.5f)) * 40.0f);
+            int grain = (int)(noise >> 28) - 8;
+
+            uint8_t *pixel = &rgba[((size_t)y * width + x) * 4];
+            pixel[0] = (uint8_t)min(max((int)(u * 255.0f) + grain, 0), 255);
+            pixel[1] = (uint8_t)min(max((int)(128.0f + ring * 100.0f) + grain, 0), 255);
+            pixel[2] = (uint8_t)min(max((int)(v * 255.0f) + grain, 0), 255);
+            pixel[3] = (uint8_t)(ring > 0.0f ? 255 : (int)(v * 255.0f));
+        }
+    }
+    return rgba;
+}
+
+// كل kernel لوحده، MP/s علي الصورة الكبيرة
+static void measure(const vector<uint8_t> &image, int size, ThreadPool *pool)
+{
+    size_t pixels = (size_t)size * size;
+    double megapixels = pixels / 1e6;
+    vector<float> linear(pixels * 4), resized;
+    vector<uint8_t> encoded(pixels * 4);
+    vector<ImageLevel> levels;
+
+    auto start = chrono::steady_clock::now();
+    srgb_to_linear(image.data(), linear.data(), pixels, pool);
+    double decode_ms = elapsed_ms(start);
+
+    start = chrono::steady_clock::now();
+    premultiply_alpha(linear.data(), pixels, pool);
+    double premultiply_ms = elapsed_ms(start);
+
+    start = chrono::steady_clock::now();
+    linear_to_srgb(linear.data(), encoded.data(), pixels, pool);
+    double encode_ms = elapsed_ms(start);
+
+    // الحالة العادية في ال import: صورة كبيرة بتتصغر لـ 0.3 من مقاسها
+    int small = max(1, size * 3 / 10);
+    resized.resize((size_t)small * small * 4);
+    start = chrono::steady_clock::now();
+    resize_image(linear.data(), size, size, resized.data(), small, small, pool);
+    double resize_ms = elapsed_ms(start);
+
+    start = chrono::steady_clock::now();
+    downsample_image(linear.data(), size, size, resized, pool);
+    double downsample_ms = elapsed_ms(start);
+
+    start = chrono::steady_clock::now();
+    build_image_levels(image.data(), size, size, 0, true, true, levels, pool);
+    double levels_ms = elapsed_ms(start);
+
+    auto rate = [&](double ms) { return megapixels / (ms / 1000.0); };
+    cout << "    " << (pool ? pool->concurrency() : 1) << " thread(s): decode " << rate(decode_ms)
+         << " MP/s, premultiply " << rate(premultiply_ms) << " MP/s, encode " << rate(encode_ms) << " MP/s, resize "
+         << rate(resize_ms) << " MP/s, mip " << rate(downsample_ms) << " MP/s, full chain " << levels_ms << " ms ("
+         << levels.size() << " levels)\n";
+}
+
+int main(int argc, char **argv)
+{
+    int size = argc > 1 ? atoi(argv[1]) : 2048;
+    if (size < 8)
+        size = 8;
+    ThreadPool::setSharedThreads(argc > 2 ? strtoul(argv[2], nullptr, 10) : 0);
+    ThreadPool &pool = ThreadPool::shared();
+
+    SimdLevel best = simd_detect();
+    cout << "Image kernels (" << size << "x" << size << ", " << pool.concurrency() << " threads, best "
+         << simd_level_name(best) << "):\n";
+
+    vector<uint8_t> image = make_image(size, size);
+    for (int level = (int)SimdLevel::Scalar; level <= (int)best; level++)
+    {
+        simd_set_level((SimdLevel)level);
+        cout << "  " << simd_level_name((SimdLevel)level) << ":\n";
+        measure(image, size, nullptr);
+        if (pool.concurrency() > 1)
+            measure(image, size, &pool);
+    }
+    simd_set_level(best);
+    return 0;
+}
@@ -0,0 +1,153 @@
+// مقارنة بين 3 طرق لرسم نفس عدد الاعلام:
+//     one-per-flag: draw call لكل علم
+//     batched:      كل النقط في stream واحد (BatchRenderer)
+//     instanced:    mesh واحد + glDrawElementsInstanced
+//
+//     ./instancing_bench [flags] [frames] [shaders_dir]
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "batch_renderer.h"
+#include "flag.h"
+#include "framebuffer.h"
+#include "gpu_pool.h"
+#include "instanced_renderer.h"
+#include "shader.h"
+#include "shader_preprocessor.h"
+
+using namespace std;
+
+static const int BENCH_WIDTH = 1024;
+static const int BENCH_HEIGHT = 768;
+
+int main(int argc, char **argv)
+{
+    size_t flag_count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 10000;
+    int frames = argc > 2 ? atoi(argv[2]) : 50;
+    string shaders_dir = argc > 3 ? argv[3] : "shaders";
+    if (frames < 1)
+        frames = 1;
+
+    if (!glfwInit())
+    {
+        cerr << "Failed to Initialize GLFW \n";
+        return -1;
+    }
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    GLFWwindow *window = glfwCreateWindow(64, 64, "instancing bench", nullptr, nullptr);
+    if (!window)
+    {
+        cerr << "Failed to Create a window\n";
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0);
+
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        cerr << "Can't Load functions using glad\n";
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        return -1;
+    }
+
+    // بنرسم في framebuffer خاص بينا عشان حجم النافذة ميأثرش علي النتيجة
+    Framebuffer target;
+    if (!target.create(BENCH_WIDTH, BENCH_HEIGHT))
+        return -1;
+    target.bind();
+
+    // batched بالنسخة العادية، و التانيين بنسخة INSTANCED
+    ShaderDefines instanced_defines = {{"INSTANCED", ""}};
+    PreprocessedShader flat_vertex, instanced_vertex, fragment;
+    if (!preprocess_shader(shaders_dir + "/basic.vert", {}, flat_vertex) ||
+        !preprocess_shader(shaders_dir + "/basic.vert", instanced_defines, instanced_vertex) ||
+        !preprocess_shader(shaders_dir + "/basic.frag", {}, fragment))
+        return -1;
+
+    Shader flat_shader, instanced_shader;
+    if (!flat_shader.build(flat_vertex, fragment) || !instanced_shader.build(instanced_vertex, fragment))
+        return -1;
+
+    Flag gabon = make_gabon_flag(0.8f, 0.75f, 0.25f, -0.25f, -0.75f);
+    vector<FlagPlacement> placements = make_flag_grid(gabon, flag_count);
+
+    vector<FlagInstance> instances;
+    for (const FlagPlacement &placement : placements)
+        instances.push_back(make_flag_instance(gabon, placement.x, placement.y, placement.scale));
+
+    BatchRenderer batch;
+    InstancedFlagRenderer instanced;
+    if (!batch.init() || !instanced.init(gabon))
+        return -1;
+
+    const char *mode_names[] = {"one-per-flag", "batched", "instanced"};
+
+    cout << "renderer: " << glGetString(GL_RENDERER) << "\n";
+    cout << "flags: " << flag_count << ", frames: " << frames << "\n";
+
+    for (int mode = 0; mode < 3; mode++)
+    {
+        (mode != 1 ? instanced_shader : flat_shader).use();
+
+        size_t draw_calls = 0;
+        double total_ms = 0.0;
+
+        // frame زيادة في الاول عشان ال buffers تتعمل قبل ما نبدأ نقيس
+        for (int frame = -1; frame < frames; frame++)
+        {
+            auto start = chrono::steady_clock::now();
+
+            glClear(GL_COLOR_BUFFER_BIT);
+            if (mode == 0)
+            {
+                instanced.drawOnePerFlag(instances.data(), instances.size());
+                draw_calls = instanced.drawCalls();
+            }
+            else if (mode == 1)
+            {
+                batch.begin();
+                for (const FlagPlacement &placement : placements)
+                    batch.drawFlag(gabon, placement.x, placement.y, placement.scale);
+                batch.end();
+                draw_calls = batch.drawCalls();
+            }
+            else
+            {
+                instanced.draw(instances.data(), instances.size());
+                draw_calls = instanced.drawCalls();
+            }
+
+            // glFinish عشان نقيس شغل ال GPU كمان مش بس وقت ال submit
+            glFinish();
+
+            if (frame >= 0)
+                total_ms += chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        }
+
+        cout << mode_names[mode] << ": " << draw_calls << " draw calls/frame, "
+             << total_ms / frames << " ms/frame\n";
+    }
+
+    batch.destroy();
+    instanced.destroy();
+    flat_shader.destroy();
+    instanced_shader.destroy();
+    target.destroy();
+    GPUResourcePool::shared().shutdown();
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,449 @@
+// benchmark للرسم من غير شاشة (headless) بأحجام مختلفة:
+//     عدد المستطيلات:  1 و 100 و 10k و 1M
+//     كل ال vertex formats
+//     batched (BatchRenderer) و instanced (InstancedFlagRenderer)
+//     threaded: زي batched بس النقط بتتجهز في ThreadPool و بتترسم من RenderQueue
+//
+// النتيجة JSON (او CSV) فيها frames/sec و vertices/sec لكل مشهد
+// عشان نقارن بين ال commits علي نفس الدرايفر (مثلا Mesa llvmpipe):
+//     ./bench [--scales 1,100,10000,1000000] [--formats all|pos2f_col4u8,...]
+//             [--modes batched,instanced,threaded] [--frames N] [--seconds S]
+//             [--threads N] [--csv] [--output FILE] [--shaders DIR]
+
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <glad/glad.h>
+
+#include "batch_renderer.h"
+#include "flag.h"
+#include "frame_profiler.h"
+#include "framebuffer.h"
+#include "gl_context.h"
+#include "gl_state_cache.h"
+#include "instanced_renderer.h"
+#include "render_queue.h"
+#include "shader.h"
+#include "shader_preprocessor.h"
+#include "thread_pool.h"
+#include "vertex_layout.h"
+
+using namespace std;
+
+#ifndef SHADER_DIR
+#define SHADER_DIR "shaders"
+#endif
+
+static const int BENCH_WIDTH = 1024;
+static const int BENCH_HEIGHT = 768;
+
+enum class BenchMode
+{
+    Batched,
+    Instanced,
+    Threaded,
+};
+
+struct BenchResult
+{
+    size_t quads;
+    VertexFormat format;
+    BenchMode mode;
+    int frames;
+    double seconds;
+    double fps;
+    double vertices_per_sec;
+    double ms_p50;
+    double ms_p99;
+    size_t draw_calls;
+    double state_issued; // state changes وصلت للدرايفر في ال frame (متوسط)
+    double state_elided; // state changes شالها GLStateCache في ال frame (متوسط)
+};
+
+struct Quad
+{
+    float x0, y0, x1, y1;
+    float r, g, b;
+};
+
+static const char *mode_name(BenchMode mode)
+{
+    switch (mode)
+    {
+    case BenchMode::Batched:
+        return "batched";
+    case BenchMode::Instanced:
+        return "instanced";
+    default:
+        return "threaded";
+    }
+}
+
+static vector<string> split_list(const string &list)
+{
+    vector<string> items;
+    stringstream stream(list);
+    string item;
+    while (getline(stream, item, ','))
+    {
+        if (!item.empty())
+            items.push_back(item);
+    }
+    return items;
+}
+
+// count مستطيل في grid بيملي الشاشة، كل واحد بلون مختلف
+static vector<Quad> make_quad_grid(size_t count)
+{
+    vector<Quad> quads(count);
+    size_t side = (size_t)ceil(sqrt((double)count));
+    if (side == 0)
+        side = 1;
+
+    float cell = 2.0f / side;
+    float size = cell * 0.8f;
+    for (size_t i = 0; i < count; i++)
+    {
+        float x = -1.0f + (i % side) * cell + (cell - size) * 0.5f;
+        float y = -1.0f + (i / side) * cell + (cell - size) * 0.5f;
+        quads[i] = {x, y, x + size, y + size,
+                    (i % 7) / 6.0f, (i % 5) / 4.0f, (i % 3) / 2.0f};
+    }
+    return quads;
+}
+
+static BenchResult run_scene(const vector<Quad> &quads, VertexFormat format, BenchMode mode,
+                             const Shader &shader, int max_frames, double max_seconds)
+{
+    BenchResult result = {quads.size(), format, mode, 0, 0.0, 0.0, 0.0, 0.0, 0.0, 0, 0.0, 0.0};
+
+    BatchRenderer batch;
+    InstancedFlagRenderer instanced;
+    vector<FlagInstance> instances;
+    RenderQueue queue;
+    vector<QuadBatch> parts;
+    ThreadPool &pool = ThreadPool::shared();
+
+    if (mode == BenchMode::Batched || mode == BenchMode::Threaded)
+    {
+        if (!batch.init(65536, format))
+            return result;
+
+        // جزء لكل thread، بس مش اقل من 4096 مستطيل في الجزء
+        size_t part_count = (quads.size() + 4095) / 4096;
+        if (part_count > pool.concurrency())
+            part_count = pool.concurrency();
+        parts.resize(part_count > 0 ? part_count : 1);
+        for (QuadBatch &part : parts)
+            batch.initBatch(part);
+    }
+    else
+    {
+        // شريط واحد = مستطيل واحد من (-1,-1) ل (1,1)، و كل instance بيحدد مكانه و لونه
+        Flag unit_quad = {1.0f, {{1.0f, -1.0f, 1.0f, 1.0f, 1.0f}}, {}};
+        if (!instanced.init(unit_quad, format))
+            return result;
+
+        instances.reserve(quads.size());
+        for (const Quad &quad : quads)
+        {
+            Flag colored = {1.0f, {{1.0f, -1.0f, quad.r, quad.g, quad.b}}, {}};
+            FlagInstance instance = make_flag_instance(colored, (quad.x0 + quad.x1) * 0.5f, (quad.y0 + quad.y1) * 0.5f, 1.0f);
+            instance.scale_x = (quad.x1 - quad.x0) * 0.5f;
+            instance.scale_y = (quad.y1 - quad.y0) * 0.5f;
+            instances.push_back(instance);
+        }
+    }
+
+    shader.use();
+
+    RollingPercentiles frame_ms(max_frames > 0 ? max_frames : 1);
+    double total_ms = 0.0;
+
+    // frame زيادة في الاول عشان ال buffers تتعمل قبل ما نبدأ نقيس
+    for (int frame = -1; frame < max_frames; frame++)
+    {
+        if (frame == 0)
+            GLStateCache::shared().resetCounters();
+
+        auto start = chrono::steady_clock::now();
+
+        glClear(GL_COLOR_BUFFER_BIT);
+        if (mode == BenchMode::Batched)
+        {
+            batch.begin();
+            for (const Quad &quad : quads)
+                batch.drawQuad(quad.x0, quad.y0, quad.x1, quad.y1, quad.r, quad.g, quad.b);
+            batch.end();
+            result.draw_calls = batch.drawCalls();
+        }
+        else if (mode == BenchMode::Threaded)
+        {
+            batch.begin(queue, {0, shader.ID, 0});
+            pool.parallelFor(parts.size(), [&](size_t part)
+            {
+                size_t begin = quads.size() * part / parts.size();
+                size_t end = quads.size() * (part + 1) / parts.size();
+                for (size_t i = begin; i < end; i++)
+                {
+                    const Quad &quad = quads[i];
+                    parts[part].drawQuad(quad.x0, quad.y0, quad.x1, quad.y1, quad.r, quad.g, quad.b);
+                }
+            });
+            batch.record(parts.data(), parts.size());
+            batch.end();
+            queue.submit();
+            batch.endFrame();
+            result.draw_calls = batch.drawCalls();
+        }
+        else
+        {
+            instanced.draw(instances.data(), instances.size());
+            result.draw_calls = instanced.drawCalls();
+        }
+
+        // glFinish عشان نقيس شغل ال GPU كمان مش بس وقت ال submit
+        glFinish();
+
+        if (frame < 0)
+            continue;
+
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        frame_ms.add(ms);
+        total_ms += ms;
+        result.frames++;
+
+        // المشاهد الكبيرة علي software GL بطيئة، فبنقف لو عدينا الوقت
+        if (total_ms >= max_seconds * 1000.0)
+            break;
+    }
+
+    batch.destroy();
+    instanced.destroy();
+
+    result.seconds = total_ms / 1000.0;
+    if (result.seconds > 0.0)
+    {
+        result.fps = result.frames / result.seconds;
+        result.vertices_per_sec = result.fps * quads.size() * 4.0;
+    }
+    result.ms_p50 = frame_ms.percentile(50.0);
+    result.ms_p99 = frame_ms.percentile(99.0);
+    if (result.frames > 0)
+    {
+        result.state_issued = (double)GLStateCache::shared().issued() / result.frames;
+        result.state_elided = (double)GLStateCache::shared().elided() / result.frames;
+    }
+    return result;
+}
+
+static void write_json(ostream &out, const vector<BenchResult> &results, int max_frames, double max_seconds)
+{
+    out << "{\n";
+    out << "  \"renderer\": \"" << (const char *)glGetString(GL_RENDERER) << "\",\n";
+    out << "  \"version\": \"" << (const char *)glGetString(GL_VERSION) << "\",\n";
+    out << "  \"width\": " << BENCH_WIDTH << ",\n";
+    out << "  \"height\": " << BENCH_HEIGHT << ",\n";
+    out << "  \"max_frames\": " << max_frames << ",\n";
+    out << "  \"max_seconds\": " << max_seconds << ",\n";
+    out << "  \"threads\": " << ThreadPool::shared().concurrency() << ",\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchResult &r = results[i];
+        out << "    {\"quads\": " << r.quads
+            << ", \"format\": \"" << vertex_format_name(r.format) << "\""
+            << ", \"mode\": \"" << mode_name(r.mode) << "\""
+            << ", \"frames\": " << r.frames
+            << ", \"seconds\": " << r.seconds
+            << ", \"fps\": " << r.fps
+            << ", \"vertices_per_sec\": " << r.vertices_per_sec
+            << ", \"ms_p50\": " << r.ms_p50
+            << ", \"ms_p99\": " << r.ms_p99
+            << ", \"draw_calls\": " << r.draw_calls
+            << ", \"state_issued\": " << r.state_issued
+            << ", \"state_elided\": " << r.state_elided << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+static void write_csv(ostream &out, const vector<BenchResult> &results)
+{
+    out << "quads,format,mode,frames,seconds,fps,vertices_per_sec,ms_p50,ms_p99,draw_calls,state_issued,state_elided\n";
+    for (const BenchResult &r : results)
+    {
+        out << r.quads << "," << vertex_format_name(r.format) << "," << mode_name(r.mode) << ","
+            << r.frames << "," << r.seconds << "," << r.fps << "," << r.vertices_per_sec << ","
+            << r.ms_p50 << "," << r.ms_p99 << "," << r.draw_calls << ","
+            << r.state_issued << "," << r.state_elided << "\n";
+    }
+}
+
+static void usage(const char *program)
+{
+    cerr << "Usage: " << program << " [--scales 1,100,10000,1000000] [--formats all|name,...]"
+         << " [--modes batched,instanced,threaded] [--frames N] [--seconds S] [--threads N]"
+         << " [--csv] [--output FILE] [--shaders DIR]\n";
+}
+
+int main(int argc, char **argv)
+{
+    string scales_arg = "1,100,10000,1000000";
+    string formats_arg = "all";
+    string modes_arg = "batched,instanced,threaded";
+    string output_path;
+    string shaders_dir = SHADER_DIR;
+    int max_frames = 30;
+    double max_seconds = 2.0;
+    bool csv = false;
+    size_t thread_count = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--scales" && i + 1 < argc)
+            scales_arg = argv[++i];
+        else if (arg == "--formats" && i + 1 < argc)
+            formats_arg = argv[++i];
+        else if (arg == "--modes" && i + 1 < argc)
+            modes_arg = argv[++i];
+        else if (arg == "--frames" && i + 1 < argc)
+            max_frames = atoi(argv[++i]);
+        else if (arg == "--seconds" && i + 1 < argc)
+            max_seconds = atof(argv[++i]);
+        else if (arg == "--output" && i + 1 < argc)
+            output_path = argv[++i];
+        else if (arg == "--shaders" && i + 1 < argc)
+            shaders_dir = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc)
+            thread_count = strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--csv")
+            csv = true;
+        else
+        {
+            usage(argv[0]);
+            return -1;
+        }
+    }
+    if (max_frames < 1)
+        max_frames = 1;
+    ThreadPool::setSharedThreads(thread_count);
+
+    vector<size_t> scales;
+    for (const string &scale : split_list(scales_arg))
+        scales.push_back(strtoul(scale.c_str(), nullptr, 10));
+
+    vector<VertexFormat> formats;
+    if (formats_arg == "all")
+    {
+        formats = {VertexFormat::Pos3F_Col3F, VertexFormat::Pos2F_Col4U8,
+                   VertexFormat::Pos2Half_Col4U8, VertexFormat::Pos2Snorm16_Col4U8};
+    }
+    else
+    {
+        for (const string &name : split_list(formats_arg))
+        {
+            VertexFormat format;
+            if (!parse_vertex_format(name.c_str(), format))
+            {
+                cerr << "Unknown vertex format: " << name << "\n";
+                return -1;
+            }
+            formats.push_back(format);
+        }
+    }
+
+    vector<BenchMode> modes;
+    for (const string &name : split_list(modes_arg))
+    {
+        if (name == "batched")
+            modes.push_back(BenchMode::Batched);
+        else if (name == "instanced")
+            modes.push_back(BenchMode::Instanced);
+        else if (name == "threaded")
+            modes.push_back(BenchMode::Threaded);
+        else
+        {
+            cerr << "Unknown mode: " << name << "\n";
+            return -1;
+        }
+    }
+
+    GLContextOptions context_options;
+    context_options.width = BENCH_WIDTH;
+    context_options.height = BENCH_HEIGHT;
+    context_options.title = "bench";
+    context_options.headless = true;
+
+    GLContext context;
+    if (!context.create(context_options))
+        return -1;
+
+    // بنرسم في framebuffer خاص بينا عشان حجم النافذة ميأثرش علي النتيجة
+    Framebuffer target;
+    if (!target.create(BENCH_WIDTH, BENCH_HEIGHT))
+        return -1;
+    target.bind();
+    GLStateCache::shared().clearColor(0.2f, 0.2f, 0.2f, 1.0f);
+
+    ShaderDefines instanced_defines = {{"INSTANCED", ""}};
+    PreprocessedShader flat_vertex, instanced_vertex, fragment;
+    if (!preprocess_shader(shaders_dir + "/basic.vert", {}, flat_vertex) ||
+        !preprocess_shader(shaders_dir + "/basic.vert", instanced_defines, instanced_vertex) ||
+        !preprocess_shader(shaders_dir + "/basic.frag", {}, fragment))
+        return -1;
+
+    Shader flat_shader, instanced_shader;
+    if (!flat_shader.build(flat_vertex, fragment) || !instanced_shader.build(instanced_vertex, fragment))
+        return -1;
+
+    cerr << "renderer: " << glGetString(GL_RENDERER) << " (" << context.backend() << ")\n";
+
+    vector<BenchResult> results;
+    for (size_t scale : scales)
+    {
+        vector<Quad> quads = make_quad_grid(scale);
+        for (VertexFormat format : formats)
+        {
+            for (BenchMode mode : modes)
+            {
+                const Shader &shader = mode == BenchMode::Instanced ? instanced_shader : flat_shader;
+                BenchResult result = run_scene(quads, format, mode, shader, max_frames, max_seconds);
+                cerr << scale << " quads, " << vertex_format_name(format) << ", " << mode_name(mode) << ": "
+                     << result.fps << " fps, " << result.vertices_per_sec / 1e6 << " Mverts/s\n";
+                results.push_back(result);
+            }
+        }
+    }
+
+    // النتيجة نفسها بس علي stdout (او الملف)، و الكلام التاني علي stderr
+    ofstream file;
+    if (!output_path.empty())
+    {
+        file.open(output_path);
+        if (!file)
+        {
+            cerr << "Can't write " << output_path << "\n";
+            return -1;
+        }
+    }
+    ostream &out = output_path.empty() ? cout : file;
+
+    if (csv)
+        write_csv(out, results);
+    else
+        write_json(out, results, max_frames, max_seconds);
+
+    flat_shader.destroy();
+    instanced_shader.destroy();
+    target.destroy();
+    context.destroy();
+    return 0;
+}
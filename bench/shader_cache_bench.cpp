@@ -0,0 +1,129 @@
+// بنقيس الفرق بين اول تشغيلة (cold: compile + link) و التشغيلات اللي بعدها (warm: glProgramBinary)
+// المفروض يتشغل علي Mesa llvmpipe:
+//     LIBGL_ALWAYS_SOFTWARE=1 ./shader_cache_bench [iterations]
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "shader.h"
+
+using namespace std;
+
+static const char *bench_vertex_source = R"(
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aColor;
+out vec3 vColor;
+
+void main()
+{
+    gl_Position = vec4(aPos, 1.0);
+    vColor = aColor;
+}
+)";
+
+// shader تقيل شوية عشان ال compile ياخد وقت يتقاس
+static const char *bench_fragment_source = R"(
+#version 330 core
+out vec4 FragColor;
+in vec3 vColor;
+
+vec3 palette(float t)
+{
+    return 0.5 + 0.5 * cos(6.28318 * (vec3(1.0, 1.0, 1.0) * t + vec3(0.0, 0.33, 0.67)));
+}
+
+void main()
+{
+    vec3 color = vColor;
+    vec2 p = gl_FragCoord.xy / 800.0;
+    for (int i = 0; i < 16; i++)
+    {
+        p = abs(p) / dot(p, p) - 0.8;
+        color += palette(length(p) + float(i) * 0.1) * 0.02;
+    }
+    FragColor = vec4(color, 1.0);
+}
+)";
+
+int main(int argc, char **argv)
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : 20;
+    if (iterations < 1)
+        iterations = 1;
+
+    if (!glfwInit())
+    {
+        cerr << "Failed to Initialize GLFW \n";
+        return -1;
+    }
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    GLFWwindow *window = glfwCreateWindow(64, 64, "shader cache bench", nullptr, nullptr);
+    if (!window)
+    {
+        cerr << "Failed to Create a window\n";
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        cerr << "Can't Load functions using glad\n";
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        return -1;
+    }
+
+    string cache_dir = (filesystem::temp_directory_path() / "opengl_shader_cache_bench").string();
+    Shader::setCacheDirectory(cache_dir);
+
+    double cold_total = 0.0, warm_total = 0.0;
+    int warm_hits = 0;
+
+    // Mesa عنده disk cache خاص بيه و مينفعش نقفله لان glProgramBinary معتمد عليه
+    // فبنضيف comment مختلف في كل لفة عشان ال source يبقي جديد عليه و علينا
+    long long run_id = chrono::steady_clock::now().time_since_epoch().count();
+
+    for (int i = 0; i < iterations; i++)
+    {
+        string fragment_source = string(bench_fragment_source) + "// run " + to_string(run_id) + " " + to_string(i) + "\n";
+
+        // cold: مفيش حاجة في ال cache لل source ده
+        Shader cold;
+        if (!cold.build(bench_vertex_source, fragment_source.c_str()))
+            return -1;
+        cold_total += cold.buildTimeMs();
+
+        // warm: نفس ال sources و ال cache لسه مكتوب
+        Shader warm;
+        if (!warm.build(bench_vertex_source, fragment_source.c_str()))
+            return -1;
+        warm_total += warm.buildTimeMs();
+        warm_hits += warm.loadedFromCache() ? 1 : 0;
+    }
+
+    filesystem::remove_all(cache_dir);
+
+    cout << "renderer: " << glGetString(GL_RENDERER) << "\n";
+    cout << "iterations: " << iterations << "\n";
+    cout << "cold link (ms/program): " << cold_total / iterations << "\n";
+    cout << "warm link (ms/program): " << warm_total / iterations << "\n";
+    cout << "cache hits: " << warm_hits << "/" << iterations << "\n";
+    if (warm_total > 0.0)
+        cout << "speedup: " << cold_total / warm_total << "x\n";
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 0;
+}
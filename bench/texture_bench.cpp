@@ -0,0 +1,190 @@
+// ال formats المضغوطة (texture_compression.h) قدام RGBA8:
+//     encode: thread واحد و كل ال pool، و من ال cache (TextureEncoder)
+//     الجودة: PSNR بين الصورة الاصلية و ال decode بتاعنا علي ال CPU
+//     الحجم و ال upload: glTexImage2D قدام glCompressedTexImage2D لنفس عدد ال textures
+//     و الفرق بين ال decode بتاع ال GPU (glGetTexImage) و بتاعنا
+//
+//     ./texture_bench [size] [textures] [threads]
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <glad/glad.h>
+
+#include "gl_context.h"
+#include "texture_compression.h"
+#include "thread_pool.h"
+
+using namespace std;
+
+static double elapsed_ms(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// صورة شبه الحقيقية: تدرج ناعم + دواير + شوية noise، و alpha متدرج
+static vector<uint8_t> make_image(int size)
+{
+    vector<uint8_t> rgba((size_t)size * size * 4);
+    uint32_t noise = 12345;
+    for (int y = 0; y < size; y++)
+    {
+        for (int x = 0; x < size; x++)
+        {
+            noise = noise * 1664525u + 1013904223u;
+            float u = (float)x / size, v = (float)y / size;
+            float ring = sinf(sqrtf((u - 0.5f) * (u - 0.5f) + (v - 0.5f) * (v - 0.5f)) * 40.0f);
+            int grain = (int)(noise >> 28) - 8;
+
+            uint8_t *pixel = &rgba[((size_t)y * size + x) * 4];
+            pixel[0] = (uint8_t)min(max((int)(u * 255.0f) + grain, 0), 255);
+            pixel[1] = (uint8_t)min(max((int)(128.0f + ring * 100.0f) + grain, 0), 255);
+            pixel[2] = (uint8_t)min(max((int)(v * 255.0f) + grain, 0), 255);
+            pixel[3] = (uint8_t)(ring > 0.0f ? 255 : (int)(v * 255.0f));
+        }
+    }
+    return rgba;
+}
+
+// القنوات اللي ال format بيحفظها بس
+static double psnr(TextureFormat format, const vector<uint8_t> &a, const vector<uint8_t> &b)
+{
+    int channels = format == TextureFormat::RGTC1 ? 1 : format == TextureFormat::RGTC2 ? 2
+                 : format == TextureFormat::BC1 ? 3 : 4;
+    double sum = 0.0;
+    for (size_t i = 0; i < a.size(); i += 4)
+    {
+        for (int c = 0; c < channels; c++)
+        {
+            double d = (double)a[i + c] - b[i + c];
+            sum += d * d;
+        }
+    }
+    double mse = sum / (a.size() / 4 * channels);
+    return mse > 0.0 ? 10.0 * log10(255.0 * 255.0 / mse) : 99.0;
+}
+
+static GLuint upload(TextureFormat format, int size, const vector<uint8_t> &data)
+{
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    if (texture_format_compressed(format))
+        glCompressedTexImage2D(GL_TEXTURE_2D, 0, texture_internal_format(format), size, size, 0, (GLsizei)data.size(),
+                               data.data());
+    else
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, data.data());
+    return texture;
+}
+
+int main(int argc, char **argv)
+{
+    int size = argc > 1 ? atoi(argv[1]) : 1024;
+    size_t texture_count = argc > 2 ? strtoul(argv[2], nullptr, 10) : 16;
+    if (size < 4)
+        size = 4;
+    if (texture_count < 1)
+        texture_count = 1;
+    ThreadPool::setSharedThreads(argc > 3 ? strtoul(argv[3], nullptr, 10) : 0);
+
+    GLContextOptions options;
+    options.headless = true;
+    GLContext context;
+    if (!context.create(options))
+        return -1;
+
+    ThreadPool &pool = ThreadPool::shared();
+    vector<uint8_t> image = make_image(size);
+    double megapixels = (double)size * size / 1e6;
+    cout << "Texture compression (" << size << "x" << size << ", " << pool.concurrency() << " threads, "
+         << texture_count << " uploads):\n";
+
+    // ال cache في directory جديد بنمسحه في الآخر
+    string cache_directory =
+        (filesystem::temp_directory_path() /
+         ("texture_bench_cache_" + to_string(chrono::steady_clock::now().time_since_epoch().count())))
+            .string();
+
+    const TextureFormat formats[] = {TextureFormat::RGBA8, TextureFormat::BC1, TextureFormat::BC3,
+                                     TextureFormat::RGTC1, TextureFormat::RGTC2};
+    int exit_code = 0;
+    for (TextureFormat format : formats)
+    {
+        if (!texture_format_supported(format))
+        {
+            cout << "  " << texture_format_name(format) << ": not supported by this driver\n";
+            continue;
+        }
+
+        vector<uint8_t> encoded, threaded, decoded;
+        auto start = chrono::steady_clock::now();
+        encode_texture(format, size, size, image.data(), encoded);
+        double single_ms = elapsed_ms(start);
+
+        start = chrono::steady_clock::now();
+        encode_texture(format, size, size, image.data(), threaded, &pool);
+        double pool_ms = elapsed_ms(start);
+        if (threaded != encoded)
+        {
+            cerr << texture_format_name(format) << ": threaded encode differs from the single thread one\n";
+            exit_code = -1;
+        }
+
+        TextureEncoder encoder;
+        encoder.setCacheDirectory(cache_directory);
+        encoder.setThreadPool(&pool);
+        vector<uint8_t> cached;
+        encoder.encode(format, size, size, image.data(), cached);
+        start = chrono::steady_clock::now();
+        encoder.encode(format, size, size, image.data(), cached);
+        double cache_ms = elapsed_ms(start);
+        if (cached != encoded || encoder.hits() != 1)
+        {
+            cerr << texture_format_name(format) << ": cached output differs\n";
+            exit_code = -1;
+        }
+
+        decode_texture(format, size, size, encoded.data(), decoded);
+
+        // نفس ال texture كذا مرة، و glFinish عشان ال upload يتحسب كله
+        vector<GLuint> textures;
+        glFinish();
+        start = chrono::steady_clock::now();
+        for (size_t i = 0; i < texture_count; i++)
+            textures.push_back(upload(format, size, encoded));
+        glFinish();
+        double upload_ms = elapsed_ms(start);
+
+        // ال GPU بيعمل decode بقواعد تقريب مختلفة شوية، فبنطبع اكبر فرق
+        vector<uint8_t> gpu((size_t)size * size * 4);
+        glBindTexture(GL_TEXTURE_2D, textures[0]);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, gpu.data());
+        int gpu_difference = 0;
+        for (size_t i = 0; i < gpu.size(); i++)
+            gpu_difference = max(gpu_difference, abs((int)gpu[i] - (int)decoded[i]));
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glDeleteTextures((GLsizei)textures.size(), textures.data());
+
+        cout << "  " << texture_format_name(format) << ": " << encoded.size() / 1024 << " KB ("
+             << (double)image.size() / encoded.size() << "x smaller)";
+        if (texture_format_compressed(format))
+        {
+            cout << ", encode " << single_ms << " ms (" << megapixels / (single_ms / 1000.0) << " MP/s) / "
+                 << pool_ms << " ms on the pool (" << megapixels / (pool_ms / 1000.0) << " MP/s)"
+                 << ", cache " << cache_ms << " ms, PSNR " << psnr(format, image, decoded) << " dB";
+        }
+        cout << ", upload " << upload_ms / texture_count << " ms/texture, GPU decode max diff " << gpu_difference
+             << "\n";
+    }
+
+    error_code ec;
+    filesystem::remove_all(cache_directory, ec);
+    context.destroy();
+    return exit_code;
+}
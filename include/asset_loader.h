@@ -0,0 +1,185 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "asset_pack.h"
+#include "gl_handle.h"
+#include "mesh.h"
+
+// texture اترفعت من ال pack
+struct LoadedTexture
+{
+    GLTexture texture;
+    int width = 0;
+    int height = 0;
+    TextureFormat format = TextureFormat::RGBA8;
+    int levels = 1;
+};
+
+/*
+    AssetLoader:
+        بيحمل assets من AssetPack (mmap) علي ال GPU و ال render loop شغال
+
+        ال staging: كام PBO (افتراضي 3) بيتعملهم map علي thread ال GL
+        و ال pointer بيروح لل loader thread، اللي بينسخ ال asset من ال mapping بتاع الملف فيه علي طول
+        يعني النسخة الوحيدة علي ال CPU هي من ال page cache لل PBO، و ال page faults (قراية الديسك)
+        بتحصل علي ال loader thread مش علي thread ال GL
+        بعد كده thread ال GL بيعمل unmap و بيرفع من ال PBO:
+            Texture: glTexImage2D و ال PBO مربوط GL_PIXEL_UNPACK_BUFFER
+            Mesh:    glCopyBufferSubData لل VBO و ال EBO (Mesh::uploadStaged)
+        و بيحط fence، و ال PBO بيرجع يتعمله map لما ال GPU يخلص منه
+
+        الطلبات في priority queue: الاعلي priority الاول، و نفس ال priority بالترتيب
+        و ال loader thread بيعمل prefetch (madvise) للي بعده و هو بينسخ الحالي
+        فالديسك بيفضل شغال و التحميل بياخد وقت قد حجم البيانات مش اكتر
+
+        asset اكبر من ال PBO: ال loader بيرجعه و thread ال GL بيكبره (glBufferData) و يرجعه تاني
+
+        كل ال public functions علي thread ال GL، و ال pack لازم يفضل مفتوح لحد destroy
+*/
+class AssetLoader
+{
+public:
+    AssetLoader();
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader &) = delete;
+    AssetLoader &operator=(const AssetLoader &) = delete;
+
+    bool init(const AssetPack &pack, size_t staging_slots = 3, size_t staging_bytes = 4 * 1024 * 1024);
+
+    // بيوقف ال loader thread و يمسح ال PBOs و كل اللي اتحمل (قبل ما ال context يتقفل)
+    void destroy();
+
+    // false لو مفيش asset بالاسم ده، و لو اتطلب قبل كده بيترفع لل priority الاعلي بس
+    bool request(const std::string &name, int priority = 0);
+    void requestAll(int priority = 0);
+
+    // كل frame: بيرفع اللي ال loader خلص نسخه و بيرجع ال PBOs اللي ال GPU خلص منها
+    // بيرجع عدد ال assets اللي بقت جاهزة
+    size_t update();
+
+    // بيستني asset واحد (و بيرفع اللي يخلص قبله) او كل اللي اتطلب
+    bool wait(const std::string &name);
+    void finish();
+
+    bool ready(const std::string &name) const;
+    size_t pending() const { return requested_count - ready_count - failed_count; }
+
+    // null لو لسه مش جاهز او من نوع تاني
+    const Mesh *mesh(const std::string &name) const;
+    const LoadedTexture *texture(const std::string &name) const;
+
+    void printStats(std::ostream &out) const;
+
+private:
+    enum class AssetState
+    {
+        Unloaded,
+        Queued,
+        Ready,
+        Failed,
+    };
+
+    struct LoadedAsset
+    {
+        AssetState state = AssetState::Unloaded;
+        int priority = 0;
+        std::unique_ptr<Mesh> mesh;
+        LoadedTexture texture;
+    };
+
+    enum class SlotState
+    {
+        Idle,      // مش متعمله map
+        Armed,     // متعمله map و مع ال loader thread
+        Filled,    // ال loader نسخ فيه asset
+        TooSmall,  // ال asset اكبر منه
+        Uploading, // مستني fence
+    };
+
+    struct StagingSlot
+    {
+        GLBuffer PBO;
+        size_t capacity = 0;
+        void *pointer = nullptr;
+        SlotState state = SlotState::Idle;
+        size_t asset = 0;
+        bool has_asset = false; // لما يتكبر بيرجع للـ loader و معاه ال asset اللي كان اكبر منه
+        GLsync fence = nullptr;
+    };
+
+    struct Request
+    {
+        int priority;
+        uint64_t sequence;
+        size_t asset;
+
+        bool operator<(const Request &other) const
+        {
+            if (priority != other.priority)
+                return priority < other.priority;
+            return sequence > other.sequence;
+        }
+    };
+
+    // ال loader thread خلص من ال slot: اتملا ولا ال asset اكبر منه
+    struct DoneSlot
+    {
+        size_t index;
+        bool too_small;
+    };
+
+    const AssetPack *pack;
+    std::vector<LoadedAsset> assets;
+    std::vector<StagingSlot> slots;
+
+    // بين thread ال GL و ال loader thread
+    std::thread loader;
+    std::mutex queue_mutex;
+    std::condition_variable loader_wake;
+    std::condition_variable slot_done;
+    std::priority_queue<Request> requests;
+    std::vector<char> taken;          // ال asset اتاخد من ال queue (النسخ القديمة بعد رفع ال priority بتتشال)
+    std::deque<size_t> armed_slots;
+    std::deque<DoneSlot> done_slots;
+    uint64_t next_sequence;
+    bool stopping;
+
+    // كام PBO مع ال loader thread دلوقتي (thread ال GL بس)
+    size_t loader_slots;
+
+    size_t requested_count;
+    size_t ready_count;
+    size_t failed_count;
+    size_t uploaded_bytes;
+    size_t staging_grows;
+    size_t fence_waits;
+    std::chrono::steady_clock::time_point first_request;
+    std::chrono::steady_clock::time_point last_ready;
+
+    void run();
+    bool requestIndex(size_t index, int priority);
+    void arm(size_t slot_index);
+    bool finishSlot(size_t slot_index);
+    bool recycleSlots(bool wait);
+    void failQueued();
+    bool upload(StagingSlot &slot);
+    size_t progress(bool wait);
+};
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mapped_file.h"
+#include "mesh.h"
+#include "texture_compression.h"
+#include "vertex_layout.h"
+
+/*
+    asset pack (.pak):
+        كل ال assets (meshes و textures) في ملف واحد، كل asset بالظبط زي ما هيترفع علي ال GPU
+        فالتحميل مفيهوش parsing: الملف بيتعمله mmap و البيانات بتتنسخ منه لل staging buffer علي طول
+        (asset_loader.h)
+
+            AssetPackHeader
+            AssetPackEntry لكل asset
+            البيانات: كل asset بيبدأ علي ASSET_DATA_ALIGNMENT (صفحة)
+                Mesh:    النقط بال VertexFormat و بعدها ال indices (16 او 32 bit) من index_offset
+                Texture: ال pixels صف ورا صف (اول صف فوق)، او blocks 4x4 بنفس الترتيب (texture_compression.h)
+
+        assetpack (tools/) بيعمل الملف من ملفات .flag و صور .ppm
+*/
+enum class AssetType : uint32_t
+{
+    Mesh = 1,
+    Texture = 2,
+};
+
+static const char ASSET_PACK_MAGIC[4] = {'A', 'P', 'A', 'K'};
+static const uint32_t ASSET_PACK_VERSION = 1;
+static const size_t ASSET_NAME_LENGTH = 48;
+
+// كل asset علي صفحة لوحده، فال prefetch (madvise) بتاعه مبيلمسش اللي جنبه
+static const size_t ASSET_DATA_ALIGNMENT = 4096;
+
+struct AssetPackHeader
+{
+    char magic[4];        // "APAK"
+    uint32_t version;
+    uint32_t asset_count;
+    uint32_t reserved;
+    uint64_t data_size;   // مجموع بيانات ال assets (من غير ال padding)
+};
+
+struct AssetPackEntry
+{
+    char name[ASSET_NAME_LENGTH]; // بينتهي بصفر
+    uint32_t type;                // AssetType
+    uint32_t format;              // Mesh: VertexFormat، Texture: TextureFormat
+    uint32_t width;               // Texture
+    uint32_t height;
+    uint32_t vertex_count;        // Mesh
+    uint32_t index_count;
+    uint32_t index_size;          // 2 او 4
+    uint32_t mip_levels;          // Texture: 0 او 1 = level واحد، غير كده ال levels ورا بعض من الاكبر
+    uint64_t offset;              // من اول الملف
+    uint64_t size;
+    uint64_t index_offset;        // Mesh: من اول بيانات ال asset
+};
+
+/*
+    AssetPack:
+        الملف مفتوح بـ mmap بعد ما اتأكدنا من ال header و ان كل asset جوه حدود الملف
+        مبيعملش اي GL، فينفع يتفتح و يتقري من اي thread
+*/
+class AssetPack
+{
+public:
+    AssetPack();
+
+    AssetPack(const AssetPack &) = delete;
+    AssetPack &operator=(const AssetPack &) = delete;
+
+    bool open(const std::string &path);
+    void close();
+
+    bool isOpen() const { return header != nullptr; }
+    size_t count() const { return header ? header->asset_count : 0; }
+    const AssetPackEntry &entry(size_t index) const { return entries[index]; }
+
+    // -1 لو مفيش asset بالاسم ده
+    int find(const std::string &name) const;
+
+    const unsigned char *data(size_t index) const { return file.data() + entries[index].offset; }
+
+    // بيطلب من ال OS يبدأ يقرا صفحات ال asset ده من الديسك (من غير ما يستني)
+    void prefetch(size_t index) const;
+
+    size_t dataSize() const { return header ? (size_t)header->data_size : 0; }
+    bool mapped() const { return file.mapped(); }
+
+private:
+    MappedFile file;
+    const AssetPackHeader *header;
+    const AssetPackEntry *entries;
+
+    bool validate(const std::string &path);
+};
+
+/*
+    AssetPackWriter:
+        بيجمع ال assets في الميموري و write بيكتبهم ملف واحد (ملف مؤقت و بعدين rename)
+*/
+class AssetPackWriter
+{
+public:
+    bool addMesh(const std::string &name, const MeshBuilder &mesh, VertexFormat format = VertexFormat::Pos2F_Col4U8);
+
+    // data بال format نفسه (texture_levels_size بايت)، اول صف فوق
+    // المضغوط بيتعمله encode قبلها (TextureEncoder)، و ال mips من build_image_levels (image_kernels.h)
+    bool addTexture(const std::string &name, int width, int height, const uint8_t *data,
+                    TextureFormat format = TextureFormat::RGBA8, int mip_levels = 1);
+
+    size_t count() const { return entries.size(); }
+    bool write(const std::string &path) const;
+
+private:
+    std::vector<AssetPackEntry> entries;
+    std::vector<std::vector<unsigned char>> payloads;
+
+    bool addEntry(const std::string &name, AssetPackEntry &entry);
+};
+
+const char *asset_type_name(AssetType type);
+
+#endif
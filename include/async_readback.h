@@ -0,0 +1,81 @@
+#ifndef ASYNC_READBACK_H
+#define ASYNC_READBACK_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "framebuffer.h"
+#include "gl_handle.h"
+
+// صورة frame واحد بعد ما رجعت من ال GPU (RGBA، اول صف تحت)
+struct ReadbackFrame
+{
+    size_t index = 0;
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> pixels;
+    bool valid = true; // false لو ال PBO متعملوش map (ال pixels مش بتاعة ال frame ده)
+};
+
+/*
+    AsyncReadback:
+        glReadPixels العادية بتوقف ال CPU لحد ما ال GPU يخلص رسم ال frame
+        هنا بنقرا في PBO (GL_PIXEL_PACK_BUFFER) فال glReadPixels بترجع علي طول
+        و بنحط fence وراها، و بعد frame او اتنين لما ال fence يتحقق
+        بنعمل map لل PBO و ناخد الصورة من غير اي انتظار
+
+        ال PBOs في ring (افتراضي 3) فقراية frame N بتحصل و احنا بنرسم N+1 و N+2
+        لو ال ring اتملي بنستني اقدم واحد بس
+*/
+class AsyncReadback
+{
+public:
+    AsyncReadback();
+    ~AsyncReadback();
+
+    AsyncReadback(const AsyncReadback &) = delete;
+    AsyncReadback &operator=(const AsyncReadback &) = delete;
+
+    bool init(int width, int height, size_t ring_size = 3);
+    void destroy();
+
+    // بيطلب قراية ال framebuffer ده، من غير انتظار
+    void capture(const Framebuffer &framebuffer, size_t frame_index);
+
+    // بياخد اقدم frame خلصت قرايته، بيرجع false لو مفيش
+    // لو wait = true بيستني اقدم frame لسه بيتقري
+    // ال pixels بتاعة out بيتعاد استخدامها لو حجمها مناسب
+    bool readFrame(ReadbackFrame &out, bool wait = false);
+
+    // عدد ال frames اللي لسه مرجعتش
+    size_t pending() const { return in_flight + completed.size(); }
+
+    // عدد المرات اللي ال ring اتملي و اضطرينا نستني
+    size_t stalls() const { return stall_count; }
+
+private:
+    struct Slot
+    {
+        GLBuffer PBO;
+        GLsync fence = nullptr;
+        size_t frame_index = 0;
+    };
+
+    std::vector<Slot> slots;
+    size_t head;
+    size_t in_flight;
+    size_t stall_count;
+    int frame_width;
+    int frame_height;
+
+    // frames خلصت بس اتقرت بدري عشان ال ring كان مليان
+    std::deque<ReadbackFrame> completed;
+
+    bool retire(Slot &slot, ReadbackFrame &out, bool wait);
+};
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef BATCH_RENDERER_H
+#define BATCH_RENDERER_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "flag.h"
+#include "gpu_pool.h"
+#include "render_queue.h"
+#include "stream_buffer.h"
+#include "vertex.h"
+#include "vertex_layout.h"
+
+/*
+    QuadBatch:
+        المستطيلات بالشكل المضغوط (VertexFormat) علي ال CPU بس، من غير GL
+        فكل thread ممكن يملا batch لوحده (زي ThreadPool::parallelFor)
+        النقط متقسمة اجزاء (segments) كل جزء max_quads مستطيل علي الاكتر = draw call واحد
+
+    BatchRenderer:
+        بدل ما كل علم يبقي ليه VAO و VBO و draw call لوحده
+        بنجمع كل المستطيلات في QuadBatch واحد علي ال CPU
+        و في الاخر (flush) بنرفعهم مرة واحدة و نرسمهم بـ draw call واحد
+
+        النقط بتترفع في StreamBuffer (ring متقسم علي 3 frames) بدل glBufferData كل frame
+        فمفيش allocation و لا sync جوه الدرايفر، و كل flush بيرسم من مكانه في ال ring
+        بـ glDrawElementsBaseVertex
+
+        كل مستطيل 4 نقط بس، و ال indices (0 1 2, 3 2 1) ثابتة لكل المستطيلات
+        فبنجهزها مرة واحدة في EBO وقت ال init
+
+        النقط بتتحول للشكل المضغوط (VertexFormat) اول ما تدخل
+        فال stream اللي بيترفع اصغر من غير اي خطوة زيادة
+
+        مع DrawList (begin(list, pass)) مفيش رسم لحد submit:
+            كل flush بيقفل جزء بس، و end بيرفع ال frame كله في map واحد
+            و بيسجل draw لكل جزء بال base vertex بتاعه
+            (map واحد عشان ال ring ميكتبش فوق نقط لسه مترسمتش)
+            و endFrame بيتنادي بعد ال submit
+
+        record بيعمل نفس الحكاية لكذا QuadBatch اتملوا في threads تانية
+        (thread ال GL بس هو اللي بيرفع و يسجل)
+
+        مع Pos2F_Col4U8_Tex3F الشعارات (FlagEmblem) بتدخل نفس ال stream
+        و كلها من TextureAtlas واحد، فمفيش draw call زيادة و لا bind بين الاعلام
+*/
+
+class QuadBatch
+{
+public:
+    struct Segment
+    {
+        size_t first_vertex;
+        size_t vertex_count;
+    };
+
+    QuadBatch();
+
+    void init(VertexFormat format, size_t max_quads);
+    void clear();
+
+    void drawQuad(float x0, float y0, float x1, float y1, float r, float g, float b);
+    void drawTexturedQuad(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, float layer);
+    void drawFlag(const Flag &flag, float x, float y, float scale);
+
+    // بيقفل الجزء الحالي (لو فيه نقط)
+    void closeSegment();
+
+    // عدد النقط في الجزء اللي لسه مفتوح
+    size_t openVertexCount() const { return vertexCount() - open_first; }
+
+    const unsigned char *data() const { return stream.data(); }
+    size_t bytes() const { return stream.size(); }
+    size_t vertexCount() const { return stride ? stream.size() / stride : 0; }
+    const std::vector<Segment> &segments() const { return closed; }
+
+    VertexFormat format() const { return vertex_format; }
+    size_t maxQuads() const { return max_quads; }
+
+private:
+    VertexFormat vertex_format;
+    size_t stride;
+    size_t max_quads;
+
+    std::vector<unsigned char> stream;
+    std::vector<Segment> closed;
+    size_t open_first;
+};
+
+class BatchRenderer
+{
+public:
+    BatchRenderer();
+    ~BatchRenderer();
+
+    BatchRenderer(const BatchRenderer &) = delete;
+    BatchRenderer &operator=(const BatchRenderer &) = delete;
+
+    // max_quads: اكبر عدد مستطيلات في ال draw call الواحد، لو عديناه بنعمل flush
+    bool init(size_t max_quads = 65536, VertexFormat format = VertexFormat::Pos2F_Col4U8);
+    void destroy();
+
+    // بيصفر العدادات بتاعة ال frame
+    void begin();
+
+    // زي begin بس ال draws بتتسجل في ال list بدل ما تترسم
+    void begin(DrawList &list, const DrawPass &pass);
+
+    // مستطيل من (x0, y0) تحت شمال لحد (x1, y1) فوق يمين
+    void drawQuad(float x0, float y0, float x1, float y1, float r, float g, float b);
+
+    // مستطيل ابيض من صورة في ال TextureAtlas: u0, v0 فوق شمال و u1, v1 تحت يمين
+    // ال UV بيتشال لو ال format مفيهوش texture
+    void drawTexturedQuad(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, float layer);
+
+    // بيرسم العلم (و شعاراته لو ال format فيه texture) متمركز عند (x, y) و متكبر بـ scale
+    void drawFlag(const Flag &flag, float x, float y, float scale);
+
+    // بيرفع اللي اتجمع و يرسمه، ال program لازم يكون متفعل قبلها
+    void flush();
+
+    // نهاية ال frame: flush + fence علي بيانات ال frame في ال ring
+    // مع ال list: بيرفع و يسجل بس، و ال fence في endFrame
+    void end();
+
+    // batches اتملت برا (مثلا في ThreadPool): بيرفعهم كلهم في map واحد
+    // و بيسجل draw لكل جزء بالترتيب، لازم يبقوا بنفس ال format و max_quads
+    // بين begin(list, pass) و end، و ال batches بتتفضي دايما حتي لو حصل غلط و مترسمتش
+    void record(QuadBatch *batches, size_t count);
+
+    // بعد queue.submit (لو الفريم اتسجل في list)
+    void endFrame();
+
+    // QuadBatch فاضي بنفس ال format و max_quads
+    void initBatch(QuadBatch &batch) const;
+
+    // احصائيات آخر frame
+    size_t drawCalls() const { return draw_calls; }
+    size_t vertexCount() const { return vertices_drawn; }
+    size_t bytesUploaded() const { return bytes_uploaded; }
+
+private:
+    PooledVertexArray vertex_array;
+    PooledBuffer quad_indices;
+    StreamBuffer vertex_stream;
+    GLenum index_type;
+    size_t max_quads;
+    VertexFormat vertex_format;
+    size_t stride;
+
+    // النقط متخزنة بالشكل المضغوط علي طول
+    QuadBatch pending;
+
+    // وضع ال list: pending فيه ال frame كله و كل flush بيقفل جزء
+    DrawList *list;
+    DrawPass pass;
+
+    size_t draw_calls;
+    size_t vertices_drawn;
+    size_t bytes_uploaded;
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef FILE_WATCHER_H
+#define FILE_WATCHER_H
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+/*
+    FileWatcher:
+        بيقول لو ملف من اللي بنراقبهم اتغير علي الديسك
+
+        علي Linux بـ inotify علي ال directory (مش الملف نفسه)
+        لان اغلب ال editors بيكتبوا ملف جديد و يعملوه rename مكان القديم
+        فالملف القديم بيتمسح و ال watch بتاعه كان هيضيع
+
+        ال fd مش blocking فـ poll بيتنادي كل frame من غير ما يوقف حاجة
+
+        ال editor ممكن يبعت كذا event ورا بعض للحفظ الواحد
+        فبنستني لحد ما ال events تهدي (settle) قبل ما نقول ان فيه تغيير
+
+        من غير inotify بنقارن وقت آخر تعديل لكل ملف كل شوية
+*/
+class FileWatcher
+{
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher &) = delete;
+    FileWatcher &operator=(const FileWatcher &) = delete;
+
+    bool watch(const std::string &path);
+    void stop();
+
+    // true مرة واحدة بعد ما ملف (او اكتر) اتغير و ال events هديت
+    bool poll();
+
+    // الملفات اللي اتغيرت من آخر poll رجع true
+    const std::vector<std::string> &changed() const { return changed_files; }
+
+    // "inotify" او "polling"
+    const char *backend() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct WatchedFile
+    {
+        std::string path;
+        std::string directory;
+        std::string name;
+        std::filesystem::file_time_type modified;
+    };
+
+    std::vector<WatchedFile> files;
+    std::map<int, std::string> directories; // inotify watch -> directory
+
+    int inotify_fd;
+    bool dirty;
+    Clock::time_point dirty_since;
+    Clock::time_point last_scan;
+    std::vector<std::string> pending_files;
+    std::vector<std::string> changed_files;
+
+    void markChanged(const std::string &path);
+    void readEvents();
+    void scanTimes();
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef FLAG_H
+#define FLAG_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*
+    Flag:
+        وصف بسيط للعلم: مجموعة شرايط افقية كل شريط ليه حدود و لون
+        الاحداثيات هنا local يعني العلم متمركز حوالين (0, 0)
+        و عرضه من -width لحد width
+*/
+struct FlagStripe
+{
+    float top;
+    float bottom;
+    float r, g, b;
+};
+
+// صورة فوق الشرايط (شعار) من TextureAtlas، الاحداثيات local زي الشرايط
+// ال UV من 0 لـ 1 علي الصورة نفسها (0, 0 فوق شمال) لحد ما TextureAtlas::rewriteUVs يحطها في ال atlas
+// و قبلها layer = -1 و الشعار مبيترسمش
+struct FlagEmblem
+{
+    std::string image;
+    float x0, y0, x1, y1;
+    float u0 = 0.0f, v0 = 0.0f, u1 = 1.0f, v1 = 1.0f;
+    float layer = -1.0f;
+};
+
+struct Flag
+{
+    float width;
+    std::vector<FlagStripe> stripes;
+    std::vector<FlagEmblem> emblems;
+};
+
+// مكان علم واحد علي الشاشة (المركز و ال scale)
+struct FlagPlacement
+{
+    float x, y;
+    float scale;
+};
+
+// بيوزع count علم في grid بيملي الشاشة كلها (من -1 ل 1)
+std::vector<FlagPlacement> make_flag_grid(const Flag &flag, size_t count);
+
+// علم الغابون: 3 شرايط (اخضر، اصفر، ازرق)
+Flag make_gabon_flag(float width, float height_top, float height_middle1, float height_middle2, float height_bottom);
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef FLAG_FORMAT_H
+#define FLAG_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mesh.h"
+#include "vertex_layout.h"
+
+/*
+    ملفات .flag (assets/flags):
+        وصف العلم نص، سطر لكل شكل، و الاشكال بتترسم بالترتيب (اللي بعد فوق اللي قبل)
+        الاحداثيات local: العلم من -w لـ w و من -h لـ h حوالين (0, 0)
+
+            # تعليق (لآخر السطر، و #RRGGBB لون مش تعليق)
+            flag NAME                       اول علم جديد (الملف ممكن يبقي فيه اكتر من علم)
+            size W H                        نص العرض و نص الارتفاع
+            stripe TOP BOTTOM COLOR         شريط افقي بعرض العلم كله
+            band LEFT RIGHT COLOR           شريط رأسي بطول العلم كله
+            rect X0 Y0 X1 Y1 COLOR
+            cross X Y THICKNESS COLOR       شريط افقي عند Y و رأسي عند X (زي علم السويد)
+            polygon COLOR X Y X Y ...       شكل مقفول (شعار، نجمة ...) بيتقسم مثلثات (ear clipping)
+
+        COLOR يا #RRGGBB يا R G B من 0 لـ 1
+
+    flag blob (الملف المترجم):
+        كل الاعلام في ملف واحد جاهز يترفع علي ال GPU زي ما هو:
+            FlagBlobHeader
+            FlagBlobEntry لكل علم
+            النقط بال VertexFormat اللي في ال header (نفس شكل ال VBO بالظبط)
+            ال indices (16 bit)، كل علم بيبدأ من صفر و base_vertex بيوديه لنقطه
+        كل جزء بيبدأ علي 4 byte، فالملف بيتقري بـ mmap من غير اي parsing (flag_library.h)
+*/
+struct FlagDescription
+{
+    std::string name;
+    float half_width = 0.0f;
+    float half_height = 0.0f;
+
+    // المثلثات بعد ال welding
+    MeshBuilder mesh;
+};
+
+static const char FLAG_BLOB_MAGIC[4] = {'F', 'L', 'G', 'B'};
+static const uint32_t FLAG_BLOB_VERSION = 1;
+static const size_t FLAG_NAME_LENGTH = 32;
+
+struct FlagBlobHeader
+{
+    char magic[4];          // "FLGB"
+    uint32_t version;       // لو غيرنا شكل الملف نزود الرقم
+    uint32_t vertex_format; // VertexFormat
+    uint32_t flag_count;
+    uint32_t vertex_count;  // لكل الاعلام
+    uint32_t index_count;
+    uint64_t source_key;    // flag_sources_key للملفات اللي اتترجمت (للـ cache)
+    uint64_t vertex_offset; // من اول الملف بالبايت
+    uint64_t index_offset;
+};
+
+struct FlagBlobEntry
+{
+    char name[FLAG_NAME_LENGTH]; // بينتهي بصفر
+    float half_width;
+    float half_height;
+    uint32_t first_index;
+    uint32_t index_count;
+    uint32_t base_vertex;
+    uint32_t vertex_count;
+};
+
+// بيضيف الاعلام اللي في الملف علي out، و بيطبع "path:line: ..." لو فيه غلط
+bool parse_flag_file(const std::string &path, std::vector<FlagDescription> &out);
+
+// ملفات .flag اللي في directory مترتبة بالاسم
+std::vector<std::string> list_flag_files(const std::string &directory);
+
+// بيتغير لو اي ملف اتضاف او اتمسح او اتعدل (الاسم و الحجم و وقت التعديل)
+uint64_t flag_sources_key(const std::vector<std::string> &paths);
+
+// بيكتب في ملف مؤقت و بعدين rename، فاللي فاتح النسخة القديمة بـ mmap مبيتأثرش
+bool write_flag_blob(const std::string &path, const std::vector<FlagDescription> &flags,
+                     VertexFormat format, uint64_t source_key);
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef FLAG_LIBRARY_H
+#define FLAG_LIBRARY_H
+
+#include <cstddef>
+#include <string>
+
+#include "flag_format.h"
+#include "mapped_file.h"
+#include "mesh.h"
+#include "render_queue.h"
+#include "vertex_layout.h"
+
+/*
+    FlagLibrary:
+        بيقرا flag blob (flag_format.h) بـ mmap، فمفيش parsing وقت التشغيل خالص:
+        بنتأكد من ال header و الاحجام بس و ال pointers بتشاور جوه الملف نفسه
+        و upload بيرفع النقط و ال indices من ال mapping علي ال GPU علي طول
+
+        load هو ال cache: لو ال blob اتترجم من نفس ملفات .flag (flag_sources_key)
+        بيتفتح زي ما هو، غير كده بيترجم الملفات الاول و يكتب blob جديد
+        (flagc بيعمل نفس الترجمة offline)
+
+        open و load مش محتاجين GL، فينفعوا علي اي thread، اما upload فعلي thread ال GL
+*/
+class FlagLibrary
+{
+public:
+    FlagLibrary();
+
+    FlagLibrary(const FlagLibrary &) = delete;
+    FlagLibrary &operator=(const FlagLibrary &) = delete;
+
+    bool open(const std::string &blob_path);
+    bool load(const std::string &source_dir, const std::string &cache_path,
+              VertexFormat format = VertexFormat::Pos2F_Col4U8);
+    void close();
+
+    size_t count() const { return header ? header->flag_count : 0; }
+    const FlagBlobEntry &entry(size_t index) const { return entries[index]; }
+
+    // -1 لو مفيش علم بالاسم ده
+    int find(const std::string &name) const;
+
+    VertexFormat format() const { return (VertexFormat)header->vertex_format; }
+
+    // كل الاعلام في Mesh واحد: VBO واحد و EBO واحد
+    bool upload(Mesh &mesh) const;
+
+    // علم واحد من ال mesh اللي اترفع بـ upload
+    void record(const Mesh &mesh, DrawList &list, const DrawPass &pass, size_t index) const;
+
+    // هل آخر load اضطر يترجم ملفات .flag ولا لقي ال blob جاهز
+    bool compiled() const { return was_compiled; }
+
+private:
+    MappedFile file;
+    const FlagBlobHeader *header;
+    const FlagBlobEntry *entries;
+    bool was_compiled;
+
+    bool validate(const std::string &path);
+};
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "gl_handle.h"
+
+/*
+    RollingPercentiles:
+        بيحتفظ بآخر N قيمة بس (ring) و بيحسب منهم p50 و p99
+        عشان الارقام تعبر عن الحالة الحالية مش عن اول البرنامج
+*/
+class RollingPercentiles
+{
+public:
+    explicit RollingPercentiles(size_t window = 1024);
+
+    void add(double value);
+
+    // p من 0 لـ 100، علي القيم اللي في ال window بس
+    double percentile(double p) const;
+    double mean() const;
+    double min() const;
+    double max() const;
+
+    size_t count() const { return samples.size(); }
+
+private:
+    std::vector<double> samples;
+    size_t capacity;
+    size_t next;
+};
+
+/*
+    FrameProfiler:
+        بيقيس كل frame:
+            frame: من beginFrame لحد endFrame
+            cpu:   نفس الوقت من غير ال swap
+            swap:  الوقت جوه glfwSwapBuffers (بيبان فيه انتظار ال vsync او ال GPU)
+            gpu:   لكل pass بـ GL_TIME_ELAPSED query
+
+        ال GPU بيخلص متأخر عن ال CPU، فلو سألنا علي ال query في نفس ال frame
+        هنوقف ال CPU لحد ما ال GPU يخلص، فبنعمل لكل pass ring من queries (افتراضي 2)
+        و نتيجة frame N بنقراها في frame N+2 لما ال query بتاعه يرجع علينا الدور
+
+        GL_TIME_ELAPSED مينفعش يبقي فيه اكتر من واحد شغال، فال passes مينفعش تتداخل
+
+        الميموري ثابتة: ال windows و ال queries بس، و الصف لكل frame (لل CSV) بيتحفظ لو keep_history
+        عشان البرنامج ممكن يفضل شغال من غير --stats بآلاف ال frames في الثانية
+*/
+class FrameProfiler
+{
+public:
+    explicit FrameProfiler(size_t window = 1024);
+    ~FrameProfiler();
+
+    FrameProfiler(const FrameProfiler &) = delete;
+    FrameProfiler &operator=(const FrameProfiler &) = delete;
+
+    // query_frames: عدد ال frames اللي نستناها قبل ما نقرا ال GPU time
+    // keep_history: صف لكل frame لـ writeCSV (بيكبر مع كل frame)
+    void init(size_t query_frames = 2, bool keep_history = false);
+    void destroy();
+
+    // بيرجع رقم ال pass (بيعمله لو مش موجود)، نستخدمه في beginGpu
+    size_t pass(const std::string &name);
+
+    void beginFrame();
+    void endFrame();
+
+    void beginSwap();
+    void endSwap();
+
+    void beginGpu(size_t pass_index);
+    void endGpu();
+
+    // بيستني كل ال queries اللي لسه مرجعتش، قبل ما نطبع او نصدر
+    void finish();
+
+    size_t frames() const { return frame_count; }
+
+    // عدد المرات اللي query مكانش جاهز و اضطرينا نستناه
+    size_t gpuStalls() const { return gpu_stalls; }
+
+    void printSummary(std::ostream &out) const;
+
+    // صف لكل frame (لازم keep_history)
+    bool writeCSV(const std::string &path) const;
+
+    // p50/p99/mean/min/max لكل قياس
+    bool writeJSON(const std::string &path) const;
+
+    // بيختار CSV او JSON من امتداد الملف
+    bool write(const std::string &path) const;
+
+    // هل write(path) محتاج keep_history (يعني CSV)
+    static bool needsHistory(const std::string &path);
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    struct FrameRecord
+    {
+        double frame_ms = 0.0;
+        double cpu_ms = 0.0;
+        double swap_ms = 0.0;
+        std::vector<double> gpu_ms; // -1 لو القياس مرجعش
+    };
+
+    struct GpuPass
+    {
+        std::string name;
+        std::vector<GLQuery> queries;
+        std::vector<size_t> query_frame; // انهي frame مستني في ال query ده
+        std::vector<bool> query_pending;
+        RollingPercentiles stats;
+    };
+
+    size_t window_size;
+    size_t query_depth;
+    bool keep_history;
+    bool frame_open;
+    int active_pass;
+    size_t gpu_stalls;
+    size_t frame_count;
+
+    clock::time_point frame_start;
+    clock::time_point swap_start;
+    double swap_ms;
+
+    RollingPercentiles frame_stats;
+    RollingPercentiles cpu_stats;
+    RollingPercentiles swap_stats;
+    std::vector<GpuPass> passes;
+    std::vector<FrameRecord> history; // فاضي لو مش keep_history
+
+    void collect(GpuPass &pass, size_t pass_index, size_t slot, bool wait);
+};
+
+#endif
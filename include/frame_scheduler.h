@@ -0,0 +1,93 @@
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+
+/*
+    FrameScheduler:
+        بيفصل ال update (الفيزيا / الحركة) عن الرسم:
+            ال update بيمشي بخطوة ثابتة (fixed timestep) مهما كان ال fps
+            كل frame بيشغل عدد الخطوات اللي الوقت الحقيقي يستاهلها (update في loop)
+            و alpha هو الكسر اللي فاضل لحد الخطوة الجاية (للـ interpolation)
+
+        لو frame اتأخر جامد مبنشغلش خطوات لا نهائية (spiral of death)
+        بنشغل max_steps بس و الباقي بيترمي
+
+        deterministic: كل frame خطوة واحدة بالظبط مهما كان الوقت
+        (لل headless و ال frame dumps عشان النتيجة تبقي هي هي كل مرة)
+
+        frame limit (اختياري): endFrame بينام لحد معاد ال frame الجاي
+            sleep_until لوحده بيصحي متأخر شوية، فبنصحي بدري بمتوسط التأخير اللي شفناه
+            و الحتة الصغيرة اللي فاضلة بنعديها بـ yield، فمفيش spin علي ال CPU طول ال frame
+
+        ال vsync (swap interval) في GLContext، و مع interval = 0 ال loop مش متربط بالشاشة
+*/
+class FrameScheduler
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    FrameScheduler();
+
+    // طول خطوة ال update بالثواني (افتراضيا 1/60)
+    void setFixedStep(double seconds);
+
+    // fps = 0 يعني من غير limit
+    void setFrameLimit(double fps);
+
+    void setMaxStepsPerFrame(int steps);
+    void setDeterministic(bool enabled);
+
+    // بيبدأ العد من دلوقتي
+    void start();
+
+    // اول ال frame: بيحسب الوقت اللي عدي و يضيفه للخطوات المستنية
+    void beginFrame();
+
+    // true لو فيه خطوة update مستنية، و بيحسبها اتعملت
+    //     while (scheduler.update())
+    //         simulate(scheduler.step());
+    bool update();
+
+    // آخر ال frame: لو فيه limit بينام لحد معاد ال frame الجاي
+    void endFrame();
+
+    double step() const { return fixed_step; }
+
+    // وقت ال simulation (عدد الخطوات * step)
+    double time() const { return steps_done * fixed_step; }
+
+    // 0..1: قد ايه عدينا من الخطوة الجاية
+    double alpha() const;
+
+    size_t updates() const { return steps_done; }
+    size_t droppedSteps() const { return dropped_steps; }
+    size_t limiterSleeps() const { return sleep_count; }
+
+    // متوسط التأخير بعد ما sleep_until يصحي (بالملي ثانية)
+    double oversleepMs() const { return oversleep_estimate * 1000.0; }
+
+    void printStats(std::ostream &out) const;
+
+private:
+    double fixed_step;
+    double frame_interval; // 0 = من غير limit
+    int max_steps;
+    bool deterministic;
+
+    Clock::time_point last_frame;
+    Clock::time_point next_deadline;
+    double accumulator;
+    int steps_this_frame;
+
+    size_t steps_done;
+    size_t dropped_steps;
+    size_t sleep_count;
+    double oversleep_estimate; // بالثواني
+
+    void sleepUntil(Clock::time_point deadline);
+};
+
+#endif
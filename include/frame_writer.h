@@ -0,0 +1,63 @@
+#ifndef FRAME_WRITER_H
+#define FRAME_WRITER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "async_readback.h"
+
+/*
+    FrameWriter:
+        thread لوحده بيكتب ال frames علي الديسك (PPM)
+        عشان ال render loop ميستناش ال encode و ال fwrite
+
+        ال queue ليها حد اقصي، لو الديسك ابطأ من الرسم push بتستني
+        بدل ما الميموري تكبر من غير حدود
+
+        ال buffers اللي اتكتبت بترجع تاني لل push الجاي فمفيش allocation كل frame
+*/
+class FrameWriter
+{
+public:
+    FrameWriter();
+    ~FrameWriter();
+
+    FrameWriter(const FrameWriter &) = delete;
+    FrameWriter &operator=(const FrameWriter &) = delete;
+
+    // الملفات بتتكتب في directory/frame_NNNN.ppm
+    bool start(const std::string &directory, size_t max_queued = 8);
+
+    // بيستني لحد ما كل اللي في ال queue يتكتب و بيقفل ال thread
+    void stop();
+
+    // بياخد ال frame و بيرجع مكانه buffer قديم (او فاضي) نستخدمه في القراية الجاية
+    void push(ReadbackFrame &frame);
+
+    size_t written() const;
+    // اللي الكتابة فشلت فيه او ال readback بتاعه مكانش valid
+    size_t failed() const;
+
+private:
+    std::string output_directory;
+    size_t queue_limit;
+
+    std::thread worker;
+    mutable std::mutex queue_mutex;
+    std::condition_variable queue_changed;
+    std::deque<ReadbackFrame> queue;
+    std::vector<std::vector<uint8_t>> free_buffers;
+    bool stopping;
+    size_t written_count;
+    size_t failed_count;
+
+    void run();
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "gl_handle.h"
+
+/*
+    Framebuffer:
+        FBO فيه color renderbuffer (RGBA8) بنرسم فيه بدل الشاشة
+        في ال headless mode ده المكان الوحيد اللي ينفع نرسم فيه
+*/
+class Framebuffer
+{
+public:
+    Framebuffer();
+    ~Framebuffer();
+
+    Framebuffer(const Framebuffer &) = delete;
+    Framebuffer &operator=(const Framebuffer &) = delete;
+
+    bool create(int width, int height);
+    void destroy();
+
+    // بيفعل ال FBO و بيظبط ال viewport علي مقاسه
+    void bind() const;
+
+    // بيرجع للشاشة (framebuffer رقم 0)
+    static void bindDefault();
+
+    // بيقرا الصورة كلها RGBA، اول صف هو اللي تحت (زي OpenGL)
+    void readPixels(std::vector<uint8_t> &rgba) const;
+
+    GLuint id() const { return FBO.get(); }
+    int width() const { return fb_width; }
+    int height() const { return fb_height; }
+
+private:
+    GLFramebuffer FBO;
+    GLRenderbuffer color_buffer;
+    int fb_width;
+    int fb_height;
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef GL_CONTEXT_H
+#define GL_CONTEXT_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <string>
+
+/*
+    GLContext:
+        مسئول عن انشاء ال OpenGL context و تحميل الوظائف بال glad
+
+        فيه طريقتين:
+            window:   نافذة GLFW عادية زي ما كنا بنعمل في main
+            headless: من غير شاشة خالص، عشان السيرفرات اللي مفيهاش display
+                      بنجرب الاول EGL surfaceless (Mesa llvmpipe مثلا)
+                      و لو مش متاح بنعمل نافذة GLFW مخفية
+
+        في ال headless مفيش default framebuffer، فالرسم لازم يبقي في Framebuffer (framebuffer.h)
+
+        GPUResourcePool::shared بيتفتح مع ال context و بيتقفل (و يتمسح اللي فيه) قبل ما يتمسح
+
+        كل خطوة في create (glfwInit، النافذة، glad ...) بتتسجل في StartupTrace::shared
+*/
+struct GLContextOptions
+{
+    int width = 800;
+    int height = 600;
+    std::string title = "Project Name";
+    bool headless = false;
+
+    // عدد ال vblanks بين كل swap: 1 = vsync، 0 = من غير انتظار (للقياس)
+    // مالوش لازمة في ال headless
+    int swap_interval = 1;
+};
+
+class GLContext
+{
+public:
+    GLContext();
+    ~GLContext();
+
+    GLContext(const GLContext &) = delete;
+    GLContext &operator=(const GLContext &) = delete;
+
+    // بيعمل ال context و يخليه current و يحمل ال glad
+    bool create(const GLContextOptions &options);
+    void destroy();
+
+    bool shouldClose() const;
+    void requestClose();
+
+    void swapBuffers();
+    void pollEvents();
+
+    // بيتنفذ في وضع النافذة بس (glfwSwapInterval)
+    void setSwapInterval(int interval);
+    int swapInterval() const { return swap_interval; }
+
+    bool headless() const { return is_headless; }
+
+    // "egl"، "glfw-hidden" او "glfw"
+    const char *backend() const;
+
+    // null في حالة EGL
+    GLFWwindow *window() const { return glfw_window; }
+
+private:
+    bool is_headless;
+    bool close_requested;
+    bool glfw_initialized;
+    int swap_interval;
+    GLFWwindow *glfw_window;
+
+    // EGLDisplay و EGLContext، متخزنين void* عشان الهيدر ميحتاجش EGL
+    void *egl_display;
+    void *egl_context;
+
+    bool createEGL(const GLContextOptions &options);
+    bool createGLFW(const GLContextOptions &options, bool visible);
+};
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef GL_HANDLE_H
+#define GL_HANDLE_H
+
+#include "gl_state_cache.h"
+
+#include <glad/glad.h>
+
+#include <utility>
+
+/*
+    GLHandle:
+        رقم object عند ال OpenGL (buffer, VAO, ...) بيتمسح لوحده لما ال handle يخرج من ال scope
+        بيتنقل (move) بس و مبيتنسخش، عشان منمسحش نفس ال object مرتين
+
+        Traits بيقول ازاي نعمل و نمسح النوع ده:
+            static GLuint create();
+            static void destroy(GLuint id);
+
+        زي Shader: لازم يتمسح (reset) قبل ما ال context يتقفل
+        ال destroy بيقول ل GLStateCache عشان الدرايفر بيفك ال binding بتاع اللي اتمسح
+*/
+template <typename Traits>
+class GLHandle
+{
+public:
+    GLHandle() : handle(0) {}
+    explicit GLHandle(GLuint id) : handle(id) {}
+    ~GLHandle() { reset(); }
+
+    GLHandle(const GLHandle &) = delete;
+    GLHandle &operator=(const GLHandle &) = delete;
+
+    GLHandle(GLHandle &&other) noexcept : handle(other.release()) {}
+    GLHandle &operator=(GLHandle &&other) noexcept
+    {
+        if (this != &other)
+            reset(other.release());
+        return *this;
+    }
+
+    // بيعمل object جديد (و بيمسح القديم لو موجود)
+    static GLHandle create() { return GLHandle(Traits::create()); }
+
+    GLuint get() const { return handle; }
+    explicit operator bool() const { return handle != 0; }
+
+    // بيسيب ال object من غير ما يمسحه
+    GLuint release()
+    {
+        GLuint id = handle;
+        handle = 0;
+        return id;
+    }
+
+    void reset(GLuint id = 0)
+    {
+        if (handle && handle != id)
+            Traits::destroy(handle);
+        handle = id;
+    }
+
+private:
+    GLuint handle;
+};
+
+struct GLBufferTraits
+{
+    static GLuint create()
+    {
+        GLuint id = 0;
+        glGenBuffers(1, &id);
+        return id;
+    }
+    static void destroy(GLuint id)
+    {
+        glDeleteBuffers(1, &id);
+        GLStateCache::shared().forgetBuffer(id);
+    }
+};
+
+struct GLVertexArrayTraits
+{
+    static GLuint create()
+    {
+        GLuint id = 0;
+        glGenVertexArrays(1, &id);
+        return id;
+    }
+    static void destroy(GLuint id)
+    {
+        glDeleteVertexArrays(1, &id);
+        GLStateCache::shared().forgetVertexArray(id);
+    }
+};
+
+struct GLFramebufferTraits
+{
+    static GLuint create()
+    {
+        GLuint id = 0;
+        glGenFramebuffers(1, &id);
+        return id;
+    }
+    static void destroy(GLuint id)
+    {
+        glDeleteFramebuffers(1, &id);
+        GLStateCache::shared().forgetFramebuffer(id);
+    }
+};
+
+struct GLRenderbufferTraits
+{
+    static GLuint create()
+    {
+        GLuint id = 0;
+        glGenRenderbuffers(1, &id);
+        return id;
+    }
+    static void destroy(GLuint id) { glDeleteRenderbuffers(1, &id); }
+};
+
+struct GLQueryTraits
+{
+    static GLuint create()
+    {
+        GLuint id = 0;
+        glGenQueries(1, &id);
+        return id;
+    }
+    static void destroy(GLuint id) { glDeleteQueries(1, &id); }
+};
+
+struct GLTextureTraits
+{
+    static GLuint create()
+    {
+        GLuint id = 0;
+        glGenTextures(1, &id);
+        return id;
+    }
+    static void destroy(GLuint id) { glDeleteTextures(1, &id); }
+};
+
+typedef GLHandle<GLBufferTraits> GLBuffer;
+typedef GLHandle<GLVertexArrayTraits> GLVertexArray;
+typedef GLHandle<GLFramebufferTraits> GLFramebuffer;
+typedef GLHandle<GLRenderbufferTraits> GLRenderbuffer;
+typedef GLHandle<GLQueryTraits> GLQuery;
+typedef GLHandle<GLTextureTraits> GLTexture;
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef GL_STATE_CACHE_H
+#define GL_STATE_CACHE_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <ostream>
+
+/*
+    GLStateCache:
+        بيحتفظ بنسخة من ال state اللي متفعل عند ال OpenGL (program, VAO, buffers,
+        framebuffers, viewport, blend, clear color)
+        و لو حد طلب نفس القيمة اللي متفعلة اصلا منبعتش ال call للدرايفر خالص
+
+        عشان ده يبقي صح لازم كل تغيير لل state ده يعدي من هنا
+        و لو حاجة غيرت ال state من برا (مكتبة تانية مثلا) نعمل invalidate
+
+        لما object يتمسح الدرايفر بيفك ال binding بتاعه، و ممكن يدي نفس الرقم لobject جديد
+        فال delete لازم يقول لل cache (forgetBuffer ...) عشان مينساش ان ال binding اتغير
+
+        ال counters بتعد كام call اتبعت و كام call اتشال، لكل نوع state
+        فيه cache واحد مشترك (shared) لل context، و GLContext بيعمله invalidate لما يتعمل
+*/
+class GLStateCache
+{
+public:
+    enum StateKind
+    {
+        Program,
+        VertexArray,
+        Buffer,
+        Framebuffer,
+        Viewport,
+        Blend,
+        BlendFunc,
+        ClearColor,
+        StateKindCount
+    };
+
+    struct Counter
+    {
+        size_t issued;
+        size_t elided;
+    };
+
+    GLStateCache();
+
+    static GLStateCache &shared();
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vertex_array);
+    void bindBuffer(GLenum target, GLuint buffer);
+
+    // GL_FRAMEBUFFER بيغير ال read و ال draw مع بعض
+    void bindFramebuffer(GLenum target, GLuint framebuffer);
+
+    void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+    void setBlend(bool enabled);
+    void blendFunc(GLenum source, GLenum destination);
+    void clearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a);
+
+    GLuint program() const { return current_program; }
+    GLuint vertexArray() const { return current_vertex_array; }
+
+    // بعد delete: لو كان متربط يبقي الدرايفر فكه
+    void forgetProgram(GLuint program);
+    void forgetVertexArray(GLuint vertex_array);
+    void forgetBuffer(GLuint buffer);
+    void forgetFramebuffer(GLuint framebuffer);
+
+    // كل حاجة بقت مش معروفة، اول call لكل state هيتبعت
+    void invalidate();
+
+    const Counter &counter(StateKind kind) const { return counters[kind]; }
+    size_t issued() const;
+    size_t elided() const;
+    void resetCounters();
+
+    void printStats(std::ostream &out) const;
+
+    static const char *stateName(StateKind kind);
+
+private:
+    // targets اللي بنتابعها في bindBuffer
+    enum BufferSlot
+    {
+        ArrayBuffer,
+        ElementArrayBuffer, // جزء من ال VAO، بيبقي مش معروف لما ال VAO يتغير
+        CopyReadBuffer,
+        CopyWriteBuffer,
+        PixelPackBuffer,
+        PixelUnpackBuffer,
+        UniformBuffer,
+        BufferSlotCount
+    };
+
+    GLuint current_program;
+    GLuint current_vertex_array;
+    GLuint current_buffers[BufferSlotCount];
+    GLuint current_read_framebuffer;
+    GLuint current_draw_framebuffer;
+    GLint current_viewport[4];
+    int current_blend; // -1 مش معروف
+    GLenum current_blend_func[2];
+    GLfloat current_clear_color[4];
+    bool clear_color_known;
+
+    Counter counters[StateKindCount];
+
+    bool changed(StateKind kind, bool differs);
+    static int bufferSlot(GLenum target);
+};
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef GPU_POOL_H
+#define GPU_POOL_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+class GPUResourcePool;
+
+/*
+    PooledBuffer / PooledVertexArray:
+        زي GLHandle بس لما يخرج من ال scope بيرجع لل pool بدل ما يتمسح
+*/
+class PooledBuffer
+{
+public:
+    PooledBuffer() : pool(nullptr), handle(0), buffer_capacity(0) {}
+    ~PooledBuffer() { reset(); }
+
+    PooledBuffer(const PooledBuffer &) = delete;
+    PooledBuffer &operator=(const PooledBuffer &) = delete;
+    PooledBuffer(PooledBuffer &&other) noexcept;
+    PooledBuffer &operator=(PooledBuffer &&other) noexcept;
+
+    GLuint get() const { return handle; }
+    explicit operator bool() const { return handle != 0; }
+
+    // الحجم الحقيقي للـ buffer (حجم ال size class) و ممكن يبقي اكبر من اللي اتطلب
+    size_t capacity() const { return buffer_capacity; }
+
+    // بيرجعه لل pool
+    void reset();
+
+private:
+    friend class GPUResourcePool;
+
+    GPUResourcePool *pool;
+    GLuint handle;
+    size_t buffer_capacity;
+};
+
+class PooledVertexArray
+{
+public:
+    PooledVertexArray() : pool(nullptr), handle(0) {}
+    ~PooledVertexArray() { reset(); }
+
+    PooledVertexArray(const PooledVertexArray &) = delete;
+    PooledVertexArray &operator=(const PooledVertexArray &) = delete;
+    PooledVertexArray(PooledVertexArray &&other) noexcept;
+    PooledVertexArray &operator=(PooledVertexArray &&other) noexcept;
+
+    GLuint get() const { return handle; }
+    explicit operator bool() const { return handle != 0; }
+
+    void reset();
+
+private:
+    friend class GPUResourcePool;
+
+    GPUResourcePool *pool;
+    GLuint handle;
+};
+
+/*
+    GPUResourcePool:
+        بدل glGenBuffers / glDeleteBuffers كل مرة مشهد يتحمل او يتشال
+        (و ده بيبان stutter لان الدرايفر بيعمل allocate و free)
+        بنحتفظ بال buffers و ال VAOs اللي خلصنا منها و نديها للي بعده
+
+        ال buffers متقسمة size classes: قوي 2 من 256 byte لفوق
+        فطلب 300 byte بياخد buffer حجمه 512، و اي buffer 512 راجع ينفع اي طلب بعد كده
+        ال storage بيتعمل مرة واحدة (glBufferData) و المستخدم بيكتب بـ glBufferSubData
+
+        ال VAO اللي راجع بيتنضف (attributes متقفلة و مفيش EBO) قبل ما يتدي لحد تاني
+
+        فيه pool واحد مشترك (shared) و GLContext بيقفله قبل ما ال context يتمسح
+*/
+class GPUResourcePool
+{
+public:
+    struct ClassStats
+    {
+        size_t size;          // حجم ال buffer في ال class ده (صفر لل VAOs)
+        size_t live;          // مع حد دلوقتي
+        size_t free;          // مستني في ال pool
+        size_t created;       // اتعمله glGen
+        size_t reused;        // اتاخد من ال pool بدل glGen
+        size_t live_bytes;
+        size_t free_bytes;
+    };
+
+    GPUResourcePool();
+    ~GPUResourcePool();
+
+    GPUResourcePool(const GPUResourcePool &) = delete;
+    GPUResourcePool &operator=(const GPUResourcePool &) = delete;
+
+    static GPUResourcePool &shared();
+
+    // buffer حجمه >= bytes، لو data مش null بيتكتب فيه
+    PooledBuffer acquireBuffer(size_t bytes, const void *data = nullptr);
+    PooledVertexArray acquireVertexArray();
+
+    // بيمسح اللي مستني في ال pool (مش اللي مع حد)
+    void trim();
+
+    // بيمسح كل حاجة، و اي حاجة ترجع بعد كده بتتساب من غير GL calls
+    // (ال context هيتقفل و الدرايفر هيمسحها معاه)
+    void shutdown();
+    void open();
+
+    // اكبر حجم نسيبه مستني في ال pool، اللي يزيد بيتمسح علي طول
+    void setFreeLimit(size_t bytes) { free_limit = bytes; }
+
+    std::vector<ClassStats> bufferStats() const;
+    ClassStats vertexArrayStats() const;
+    void printStats(std::ostream &out) const;
+
+private:
+    friend class PooledBuffer;
+    friend class PooledVertexArray;
+
+    struct BufferClass
+    {
+        std::vector<GLuint> free;
+        size_t live = 0;
+        size_t created = 0;
+        size_t reused = 0;
+    };
+
+    std::vector<BufferClass> buffer_classes;
+    std::vector<GLuint> free_vertex_arrays;
+    size_t live_vertex_arrays;
+    size_t created_vertex_arrays;
+    size_t reused_vertex_arrays;
+    size_t free_bytes;
+    size_t free_limit;
+    bool closed;
+
+    void releaseBuffer(GLuint id, size_t capacity);
+    void releaseVertexArray(GLuint id);
+};
+
+#endif
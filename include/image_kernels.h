@@ -0,0 +1,73 @@
+#ifndef IMAGE_KERNELS_H
+#define IMAGE_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+/*
+    image kernels: تجهيز الصور وقت ال import (tools/assetpack)
+        sRGB8 -> linear float -> premultiplied alpha -> resize / mips -> sRGB8
+    الشغل كله في linear light عشان المتوسطات (resize و mips) تطلع صح
+    و ال pixel RGBA float (16 byte) = __m128 واحد
+
+    كل kernel ليه 3 نسخ: scalar و SSE2 و AVX2، و بنختار وقت التشغيل علي حسب ال CPU
+    النسخ بتعمل نفس العمليات بنفس الترتيب (من غير FMA) فالنتيجة بالظبط زي ال scalar
+    (image_bench بيتأكد من ده و بيقيس السرعة)
+
+    الصورة بتتقسم صفوف (tiles) علي ال ThreadPool لو اتبعت، و من غيره الشغل علي ال thread الحالي
+
+    sRGB8 -> linear: table (256 قيمة). SSE2 مفيهوش gather فبيستخدم نسخة ال scalar
+    linear -> sRGB8: table من 104 خط (3 bits من ال mantissa لكل exponent من 2^-13 لـ 1)
+                     و ال 8 bits اللي بعدهم بيتعملهم interpolation، غلطه اقل من 0.1 من درجة
+                     و كل قيمة sRGB8 بترجع هي نفسها بعد decode و encode
+*/
+
+enum class SimdLevel
+{
+    Scalar,
+    SSE2,
+    AVX2,
+};
+
+// احسن level ال CPU بيدعمه
+SimdLevel simd_detect();
+
+// لل bench: level اقل من اللي ال CPU بيدعمه (اعلي منه بيتقص)
+void simd_set_level(SimdLevel level);
+SimdLevel simd_level();
+const char *simd_level_name(SimdLevel level);
+
+// pixels = عدد ال pixels (RGBA)، ال alpha linear دايما
+void srgb_to_linear(const uint8_t *srgb, float *linear, size_t pixels, ThreadPool *pool = nullptr);
+void linear_to_srgb(const float *linear, uint8_t *srgb, size_t pixels, ThreadPool *pool = nullptr);
+void premultiply_alpha(float *rgba, size_t pixels, ThreadPool *pool = nullptr);
+
+// tent filter منفصل (افقي و بعدين رأسي)، و في التصغير عرضه بيكبر عشان كل pixel يدخل في الحساب
+void resize_image(const float *in, int in_width, int in_height, float *out, int out_width, int out_height,
+                  ThreadPool *pool = nullptr);
+
+// level واحد لتحت: 2x2 box لو المقاس زوجي، و resize_image لو لأ
+// المقاس الجديد max(1, width / 2) x max(1, height / 2)
+void downsample_image(const float *in, int width, int height, std::vector<float> &out, ThreadPool *pool = nullptr);
+
+struct ImageLevel
+{
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> rgba; // sRGB8
+};
+
+/*
+    ال import كله لصورة sRGB8:
+        max_size > 0: لو اكبر ضلع اكبر منه بتتصغر بنفس النسبة
+        mips: كل ال levels لحد 1x1، غير كده level واحد
+        premultiply: ال RGB بيتضرب في ال alpha (في linear) قبل اي resize
+    لو مفيش ولا واحدة منهم الصورة بترجع زي ما هي من غير تحويل
+*/
+void build_image_levels(const uint8_t *srgb, int width, int height, int max_size, bool mips, bool premultiply,
+                        std::vector<ImageLevel> &levels, ThreadPool *pool = nullptr);
+
+#endif
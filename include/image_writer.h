@@ -0,0 +1,16 @@
+#ifndef IMAGE_WRITER_H
+#define IMAGE_WRITER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// بيكتب الصورة PPM (P6) من غير اي مكتبة خارجية
+// rgba: width * height * 4 بايت، و ال alpha بيتشال
+// flip_y = true لو الصورة جاية من glReadPixels (اول صف تحت)
+bool write_ppm(const std::string &path, int width, int height, const uint8_t *rgba, bool flip_y = true);
+
+// العكس: PPM (P6، 8 bit) لـ RGBA و ال alpha بـ 255، اول صف فوق زي الملف
+bool read_ppm(const std::string &path, int &width, int &height, std::vector<uint8_t> &rgba);
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef INSTANCED_RENDERER_H
+#define INSTANCED_RENDERER_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "flag.h"
+#include "mesh.h"
+#include "render_queue.h"
+#include "stream_buffer.h"
+
+/*
+    InstancedFlagRenderer:
+        كل الاعلام نفس الشكل (3 شرايط) و بيفرقوا في المكان و الحجم و الالوان بس
+        فبدل ما نرفع نقط كل علم، بنرفع mesh واحد للعلم
+        و buffer فيه لكل علم: مكانه + ال scale + الوان الشرايط
+        و نرسمهم كلهم بـ glDrawElementsInstanced واحد
+
+        بيانات ال instances بتتغير كل frame فبتتكتب في StreamBuffer (ring)
+        و ال attributes بتتوجه علي مكانها في ال ring قبل ال draw
+
+        ال shader (shaders/basic.vert) لازم يتبني بـ #define INSTANCED
+
+        مع RenderQueue ال attributes بتتوجه وقت التسجيل (مفيش base instance في GL 3.3)
+        فمرة واحدة بس في ال frame، و endFrame بعد ال submit
+*/
+struct FlagInstance
+{
+    float x, y;             // مركز العلم
+    float scale_x, scale_y; // الحجم
+    uint8_t palette[3][4];  // RGBA لكل شريط
+};
+
+// بيملي ال palette من الوان شرايط العلم
+FlagInstance make_flag_instance(const Flag &flag, float x, float y, float scale);
+
+class InstancedFlagRenderer
+{
+public:
+    InstancedFlagRenderer();
+    ~InstancedFlagRenderer();
+
+    InstancedFlagRenderer(const InstancedFlagRenderer &) = delete;
+    InstancedFlagRenderer &operator=(const InstancedFlagRenderer &) = delete;
+
+    // shape: شكل العلم (اول 3 شرايط بس)، الالوان بتيجي من ال instances
+    bool init(const Flag &shape, VertexFormat format = VertexFormat::Pos2F_Col4U8);
+    void destroy();
+
+    void draw(const FlagInstance *instances, size_t count);
+
+    // بيرفع ال instances و بيسجل ال draw في ال queue
+    void draw(DrawList &list, const DrawPass &pass, const FlagInstance *instances, size_t count);
+
+    // بعد queue.submit
+    void endFrame();
+
+    // للمقارنة بس: نفس البيانات بس draw call لكل علم
+    // (زي ما كنا هنعمل من غير instancing)
+    void drawOnePerFlag(const FlagInstance *instances, size_t count);
+
+    size_t drawCalls() const { return draw_calls; }
+
+private:
+    Mesh base_mesh;
+    StreamBuffer instance_stream;
+    size_t draw_calls;
+
+    // بيكتب ال instances في ال ring و بيرجع رقم اول واحد فيهم جوه ال buffer
+    bool upload(const FlagInstance *instances, size_t count, size_t &first_instance);
+
+    // بيوجه attributes ال instance علي اول instance في ال buffer نبدأ منه
+    void pointInstanceAttributes(size_t first_instance);
+};
+
+#endif
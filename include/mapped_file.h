@@ -0,0 +1,49 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*
+    MappedFile:
+        بيفتح ملف للقراية بس بـ mmap، فالبيانات بتتقري من ال page cache علي طول
+        من غير read و من غير نسخة في الذاكرة بتاعتنا
+        الصفحات بتتحمل من الديسك اول ما حد يلمسها بس
+
+        من غير mmap (مثلا Windows) بيقرا الملف كله في buffer عادي و ال API هو هو
+
+        ال pointer اللي راجع من data صالح لحد close، و الملف مينفعش يتعدل و هو مفتوح
+        (اللي بيكتب الملفات دي بيكتب ملف جديد و يعمل rename، فالمفتوح مبيتأثرش)
+*/
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool open(const std::string &path);
+    void close();
+
+    bool isOpen() const { return bytes != nullptr; }
+    const unsigned char *data() const { return bytes; }
+    size_t size() const { return length; }
+
+    // هل اتعمل mmap فعلا ولا اتقري في buffer
+    bool mapped() const { return is_mapped; }
+
+    // بيقول لل OS ان الجزء ده هيتقري قريب فيبدأ يجيبه من الديسك في الخلفية (madvise)
+    // مبيستناش، و من غير mmap مبيعملش حاجة (الملف كله في الميموري اصلا)
+    void prefetch(size_t offset, size_t count) const;
+
+private:
+    const unsigned char *bytes;
+    size_t length;
+    bool is_mapped;
+    std::vector<unsigned char> fallback;
+};
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "flag.h"
+#include "gpu_pool.h"
+#include "render_queue.h"
+#include "vertex.h"
+#include "vertex_layout.h"
+
+/*
+    MeshBuilder:
+        بيستقبل مثلثات عادية (3 نقط لكل مثلث) و بيدمج النقط المتكررة (welding)
+        كل نقطة مميزة بتتخزن مرة واحدة و المثلثات بتبقي indices عليها
+        مثلا المستطيل كان 6 نقط بقي 4 نقط + 6 indices
+
+    Mesh:
+        النسخة اللي علي ال GPU: VAO + VBO + EBO و بيترسم بـ glDrawElements
+        النقط بتترفع بال VertexFormat اللي نختاره (الافتراضي 12 byte للنقطة)
+*/
+class MeshBuilder
+{
+public:
+    void addTriangle(const Vertex &a, const Vertex &b, const Vertex &c);
+
+    // بيقرا triangle list (كل 3 نقط مثلث) زي ال arrays اللي بنكتبها بايدينا
+    void addTriangles(const Vertex *triangle_vertices, size_t count);
+
+    // نفس ترتيب المثلثات اللي في main: BL, BR, TL و TR, TL, BR
+    void addQuad(float x0, float y0, float x1, float y1, float r, float g, float b);
+
+    void addFlag(const Flag &flag, float x, float y, float scale);
+
+    void clear();
+
+    const std::vector<Vertex> &vertices() const { return unique_vertices; }
+    const std::vector<uint32_t> &indices() const { return triangle_indices; }
+
+    // عدد النقط اللي دخلت قبل ال welding
+    size_t inputVertexCount() const { return triangle_indices.size(); }
+
+private:
+    struct VertexHash
+    {
+        size_t operator()(const Vertex &v) const;
+    };
+    struct VertexEqual
+    {
+        bool operator()(const Vertex &a, const Vertex &b) const;
+    };
+
+    std::vector<Vertex> unique_vertices;
+    std::vector<uint32_t> triangle_indices;
+    std::unordered_map<Vertex, uint32_t, VertexHash, VertexEqual> lookup;
+
+    uint32_t weld(const Vertex &v);
+};
+
+class Mesh
+{
+public:
+    Mesh();
+    ~Mesh();
+
+    Mesh(const Mesh &) = delete;
+    Mesh &operator=(const Mesh &) = delete;
+
+    bool upload(const MeshBuilder &builder, VertexFormat format = VertexFormat::Pos2F_Col4U8);
+
+    // نقط جاهزة بال format المطلوب (مثلا من flag blob متعمله mmap) بتترفع زي ما هي
+    // index_type: GL_UNSIGNED_SHORT او GL_UNSIGNED_INT
+    bool uploadPacked(VertexFormat format, const void *vertices, size_t vertex_count,
+                      const void *indices, size_t indices_count, GLenum indices_type);
+
+    // نفس uploadPacked بس البيانات علي ال GPU اصلا في buffer تاني (staging)
+    // فبتتنسخ buffer لـ buffer بـ glCopyBufferSubData من غير ما تعدي علي ال CPU
+    bool uploadStaged(VertexFormat format, GLuint staging, size_t vertex_offset, size_t vertex_count,
+                      size_t index_offset, size_t indices_count, GLenum indices_type);
+
+    void draw() const;
+
+    // بيسجل نفس ال draw في ال queue بدل ما يرسمه
+    void record(DrawList &list, const DrawPass &pass) const;
+
+    // جزء من ال indices بس (مثلا علم واحد من mesh فيه كذا علم)
+    void recordRange(DrawList &list, const DrawPass &pass, GLsizei count, size_t first_index, GLint base_vertex) const;
+
+    // بيفعل ال VAO بس، عشان نضيف عليه attributes تانية (زي بيانات ال instances)
+    void bind() const;
+    void destroy();
+
+    GLuint vao() const { return vertex_array.get(); }
+    GLsizei indexCount() const { return index_count; }
+    GLenum indexType() const { return index_type; }
+    VertexFormat format() const { return vertex_format; }
+
+private:
+    // من ال GPUResourcePool، بيرجعوا له في destroy
+    PooledVertexArray vertex_array;
+    PooledBuffer vertex_buffer;
+    PooledBuffer index_buffer;
+    GLsizei index_count;
+    GLenum index_type;
+    VertexFormat vertex_format;
+
+    // بيربط ال VBO و ال EBO بال VAO و يعمل ال attributes
+    void setupVertexArray();
+};
+
+#endif
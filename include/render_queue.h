@@ -0,0 +1,132 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <vector>
+
+/*
+    RenderQueue:
+        بدل ما كل حتة في الكود تنادي glDraw علي طول، بتسجل DrawCommand في ال queue
+        و في آخر ال frame (submit) بنرتبهم و نرسمهم مرة واحدة
+
+        كل command ليه مفتاح 64 bit:
+            [63..56] layer          اللي رقمه اصغر يترسم الاول
+            [55..40] program        عشان ال draws اللي بنفس ال program يبقوا ورا بعض
+            [39..24] vertex array
+            [23..0 ] material
+
+        ال program و ال VAO بناخد اول 16 bit من رقمهم بس، ده للتجميع بس
+        (الرقم الكامل موجود في ال command نفسه)
+
+        الترتيب radix sort (LSD، byte في كل pass) و هو stable
+        فال commands اللي ليهم نفس المفتاح بيترسموا بنفس ترتيب التسجيل
+        و النتيجة ثابتة من frame للتاني
+
+        ال material: function بتحط ال uniforms، بتتنادي لما ال material او ال program يتغير
+        (ال uniforms بتاعة كل program لوحده)
+
+        ال state كله بيعدي من GLStateCache، فال draws اللي ورا بعض بنفس ال state
+        مبيبعتوش ولا bind
+
+    DrawList:
+        ال commands و المفاتيح بس من غير GL خالص، فكل thread ممكن يسجل في واحد لوحده
+        و thread ال GL بيجمعهم (append) في ال RenderQueue بترتيب ثابت و يعمل submit
+        RenderQueue نفسه DrawList فاي حاجة بتسجل بتقبل الاتنين
+*/
+
+// مكان ال draws في ال queue: كل ال draws اللي بتطلع من renderer واحد بتاخد نفس القيم
+struct DrawPass
+{
+    uint32_t layer;
+    GLuint program;
+    uint32_t material;
+};
+
+struct DrawCommand
+{
+    GLuint program;
+    GLuint vertex_array;
+    uint32_t material;
+
+    GLenum primitive;
+    GLsizei count;
+    GLenum index_type;  // صفر: glDrawArrays من غير indices
+    size_t first;       // اول vertex (arrays) او offset بالبايت في ال EBO
+    GLint base_vertex;
+    GLsizei instances;  // صفر: draw عادي من غير instancing
+};
+
+class DrawList
+{
+public:
+    static const uint32_t MAX_LAYER = 0xFF;
+    static const uint32_t MAX_MATERIAL = 0xFFFFFF;
+
+    static uint64_t makeKey(uint32_t layer, GLuint program, GLuint vertex_array, uint32_t material);
+
+    void push(uint32_t layer, const DrawCommand &command);
+
+    // glDrawElements عادي من VAO جاهز (زي Mesh)
+    void pushElements(const DrawPass &pass, GLuint vertex_array, GLsizei count, GLenum index_type,
+                      size_t offset = 0, GLint base_vertex = 0, GLsizei instances = 0);
+
+    // بيضيف commands اتسجلت في DrawList تاني (مثلا من thread تاني) و بيفضيه
+    void append(DrawList &list);
+
+    // بيرمي اللي اتسجل من غير رسم
+    void clear();
+
+    size_t size() const { return commands.size(); }
+
+protected:
+    std::vector<DrawCommand> commands;
+    std::vector<uint64_t> keys;
+};
+
+class RenderQueue : public DrawList
+{
+public:
+    typedef std::function<void(GLuint program)> MaterialApply;
+
+    RenderQueue();
+
+    // بيرجع رقم ال material اللي بيتحط في DrawPass / DrawCommand
+    // material رقم 0 موجود دايما و مبيعملش حاجة
+    uint32_t addMaterial(const MaterialApply &apply);
+
+    // بيرتب و يرسم كل اللي اتسجل و بيفضي ال queue
+    void submit();
+
+    // احصائيات آخر submit
+    size_t drawCount() const { return draw_count; }
+    size_t programChanges() const { return program_changes; }
+    size_t vertexArrayChanges() const { return vertex_array_changes; }
+    size_t materialChanges() const { return material_changes; }
+    double sortMs() const { return sort_ms; }
+
+    void printStats(std::ostream &out) const;
+
+private:
+    // ال radix sort بيرتب ارقام ال commands، و ال buffers دي بتفضل عشان منعملش allocation كل frame
+    std::vector<uint64_t> sort_keys[2];
+    std::vector<uint32_t> sort_order[2];
+
+    std::vector<MaterialApply> materials;
+
+    size_t draw_count;
+    size_t program_changes;
+    size_t vertex_array_changes;
+    size_t material_changes;
+    double sort_ms;
+
+    // بيرجع ترتيب ال commands بعد ال sort
+    const std::vector<uint32_t> &sort();
+    void execute(const DrawCommand &command) const;
+};
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef SHADER_H
+#define SHADER_H
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "shader_preprocessor.h"
+
+/*
+    Shader:
+        بيجمع ال vertex shader و ال fragment shader في program واحد
+
+    program cache:
+        بعد ما ال program يتعمله link بنسحب ال binary بتاعه من الدرايفر
+        (glGetProgramBinary) و نحفظه علي الديسك
+        المرة الجاية لو نفس ال source و نفس الدرايفر بنحمله علي طول بـ glProgramBinary
+        من غير ما نعمل compile تاني
+
+    submit / poll:
+        submit بيبعت ال compile و ال link للدرايفر من غير ما يسأل عن النتيجة
+        poll بيسأل بعدين، و لو الدرايفر بيدعم GL_KHR_parallel_shader_compile
+        بيرجع علي طول من غير ما يوقف ال thread لحد ما ال compile يخلص
+
+    رسايل الغلط:
+        ال log بيتقري كله (GL_INFO_LOG_LENGTH) و ال link بيتشيك كمان
+        لو ال source جاي من preprocess_shader رقم الملف في ال log بيتبدل باسمه
+        و بيتطبع تحته السطر نفسه من الملف، فالغلط بيبان من غير ما تفتح الملف
+
+    fail fast (setFailFast):
+        لتشخيص ال builds البطيئة: كل مرحلة (vertex, fragment, link) بتتعمل و نستناها
+        قبل اللي بعدها، فبنعرف كل واحدة خدت قد ايه (timings)، و اول مرحلة تفشل بتوقف الباقي
+        ال build بيبقي متزامن، فده للتشخيص مش للشغل العادي
+*/
+class Shader
+{
+public:
+    enum BuildStatus
+    {
+        NotBuilt,
+        Building,
+        Ready,
+        Failed
+    };
+
+    // بالملي ثانية، بتتملي بس في fail fast (ما عدا store)
+    struct BuildTimings
+    {
+        double cache_load_ms = 0.0; // قراية ال binary من الديسك لحد ما الدرايفر قبله
+        double vertex_ms = 0.0;
+        double fragment_ms = 0.0;
+        double link_ms = 0.0;
+        double store_ms = 0.0;      // كتابة ال binary في ال cache
+    };
+
+    // رقم ال program عند ال OpenGL (صفر معناه مفيش program)
+    GLuint ID;
+
+    Shader();
+    ~Shader();
+
+    Shader(const Shader &) = delete;
+    Shader &operator=(const Shader &) = delete;
+
+    // بيعمل compile + link (او بيحمل من ال cache لو موجود) و بيستني النتيجة
+    // بيرجع false لو حصل خطأ و بيطبع رسالة الخطأ
+    bool build(const char *vertex_source, const char *fragment_source);
+
+    // نفس build بس من غير انتظار، النتيجة بتيجي من poll
+    void submit(const char *vertex_source, const char *fragment_source);
+
+    // نفس اللي فوق بس اسماء الملفات بتظهر في رسايل الغلط بدل ارقامها
+    bool build(const PreprocessedShader &vertex, const PreprocessedShader &fragment);
+    void submit(const PreprocessedShader &vertex, const PreprocessedShader &fragment);
+
+    // بيرجع الحالة الحالية، لو wait = true بيستني لحد ما ال build يخلص
+    BuildStatus poll(bool wait = false);
+
+    BuildStatus status() const { return build_status; }
+    bool ready() const { return build_status == Ready; }
+
+    void use() const;
+
+    // ال program لازم يكون متفعل (use) قبلها
+    void setBool(const std::string &name, bool value) const;
+    void setInt(const std::string &name, int value) const;
+
+    // بيمسح ال program من الدرايفر، لازم يتنادي قبل ما ال context يتقفل
+    void destroy();
+
+    // هل آخر build اتحمل من ال cache ولا اتعمله compile من الاول
+    bool loadedFromCache() const { return from_cache; }
+
+    // الوقت من submit لحد ما ال program بقي جاهز بالملي ثانية
+    double buildTimeMs() const { return build_ms; }
+    const BuildTimings &timings() const { return build_timings; }
+
+    // مكان ال cache علي الديسك، لو فاضي يبقي ال cache مقفول
+    static void setCacheDirectory(const std::string &dir);
+    static const std::string &cacheDirectory();
+
+    // هل الدرايفر بيقدر يرد علي poll من غير ما يستني
+    static bool parallelCompileSupported();
+
+    // لكل ال shaders اللي هتتبني بعد كده
+    static void setFailFast(bool enabled);
+    static bool failFast();
+
+private:
+    BuildStatus build_status;
+    bool from_cache;
+    double build_ms;
+    std::chrono::steady_clock::time_point build_start;
+    BuildTimings build_timings;
+    const char *failed_stage; // "vertex" / "fragment" / "link" لو فشل
+
+    // الحاجات دي محتاجينها بس و ال build شغال
+    GLuint vertex_shader;
+    GLuint fragment_shader;
+    std::string cache_path;
+    std::string vertex_source;
+    std::string fragment_source;
+    std::vector<std::string> vertex_files;
+    std::vector<std::string> fragment_files;
+
+    void start(const char *vertex_source, const char *fragment_source);
+    void submitCompile();
+    void compileStaged();
+    bool finishCompile();
+    void finish(BuildStatus result);
+    void printTimings() const;
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef SHADER_BUILDER_H
+#define SHADER_BUILDER_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "shader.h"
+
+/*
+    ShaderBuilder:
+        بنبعت كل ال shaders للدرايفر الاول (submit) و بعدين نسأل عليهم كل frame (poll)
+        بدل ما نعمل compile و نستني كل واحد لوحده
+        لو الدرايفر بيدعم GL_KHR_parallel_shader_compile ال compile بيحصل في threads
+        تبع الدرايفر و ال render loop بيفضل شغال بال fallback program لحد ما يخلصوا
+*/
+class ShaderBuilder
+{
+public:
+    // بنقول للدرايفر يستخدم اي عدد threads هو شايفه مناسب
+    static void enableParallelCompile(GLuint max_threads = 0xFFFFFFFFu);
+
+    // ال shader لازم يفضل موجود لحد ما يخلص (ready او failed)
+    void submit(Shader &shader, const char *vertex_source, const char *fragment_source);
+
+    // بيعدي علي كل اللي لسه بيتبني و بيرجع عددهم
+    size_t poll();
+
+    // بيستني لحد ما كل حاجة تخلص
+    void waitAll();
+
+    size_t pending() const { return building.size(); }
+
+private:
+    std::vector<Shader *> building;
+};
+
+#endif
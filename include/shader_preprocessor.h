@@ -0,0 +1,39 @@
+#ifndef SHADER_PREPROCESSOR_H
+#define SHADER_PREPROCESSOR_H
+
+#include <string>
+#include <vector>
+
+/*
+    shader preprocessor:
+        GLSL معندوش #include، فبنحلها احنا قبل ما ال source يروح للدرايفر:
+            #include "common.glsl" بيتبدل بمحتوي الملف (المكان نسبة للملف اللي فيه ال include)
+            #pragma once في الملف بيخليه يتضاف مرة واحدة بس
+
+        ال defines (مثلا INSTANCED) بتتحط بعد #version علي طول
+        لان #version لازم يبقي اول سطر، فال shader نفسه بيستخدم #ifdef INSTANCED
+
+        بعد كل حتة بنضيفها بنحط #line عشان ارقام السطور في رسايل الدرايفر
+        تفضل زي الملف الاصلي: "#line سطر رقم_الملف"
+        و رقم الملف هو مكانه في files (0 = الملف الاساسي)
+*/
+struct ShaderDefine
+{
+    std::string name;
+    std::string value; // فاضي = #define NAME بس
+};
+
+typedef std::vector<ShaderDefine> ShaderDefines;
+
+struct PreprocessedShader
+{
+    std::string source;
+    std::vector<std::string> files;
+};
+
+bool preprocess_shader(const std::string &path, const ShaderDefines &defines, PreprocessedShader &out);
+
+// مفتاح ثابت لمجموعة defines مهما كان ترتيبها، مثلا "COLOR=2;INSTANCED"
+std::string shader_defines_key(const ShaderDefines &defines);
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef SHADER_RELOADER_H
+#define SHADER_RELOADER_H
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include "file_watcher.h"
+#include "shader.h"
+#include "shader_preprocessor.h"
+
+/*
+    ShaderReloader:
+        بيحمل ال shader من ملفات (shaders/basic.vert و basic.frag) بدل strings جوه الكود
+        و بيراقب الملفات (FileWatcher)، فلو اتعدلت بيبنيها تاني و البرنامج شغال
+
+        permutations:
+            نفس الملفات بتتبني بـ defines مختلفة (مثلا INSTANCED) عن طريق preprocess_shader
+            كل مجموعة defines ليها program لوحدها في cache بمفتاح ال defines
+            و مبتتبنيش غير اول مرة حد يطلبها (program(defines))، فاللي مش مستخدم مبيتعملوش compile خالص
+
+        ال build الجديد بيتبعت في Shader تاني (pending) من غير انتظار (submit / poll)
+        و ال program القديم بيفضل يرسم لحد ما الجديد يبقي جاهز
+        ساعتها بنبدلهم مرة واحدة بين frame و التاني (ال render loop بياخد program() اول ال frame)
+
+        لو ال compile فشل بنطبع الغلط و نفضل علي القديم، و نستني التعديل الجاي
+        الملفات اللي اتعملها #include بتتراقب هي كمان
+
+        update و program لازم يتنادوا من thread ال GL (كل frame)
+*/
+class ShaderReloader
+{
+public:
+    ShaderReloader();
+    ~ShaderReloader();
+
+    ShaderReloader(const ShaderReloader &) = delete;
+    ShaderReloader &operator=(const ShaderReloader &) = delete;
+
+    // بيتأكد ان الملفات موجودة و بيبدأ يراقبها لو watch، من غير ما يبني حاجة
+    // بيرجع false لو الملفات مش موجودة او فيها include غلط
+    bool load(const std::string &vertex_path, const std::string &fragment_path, bool watch = true);
+
+    // كل frame: بيشوف لو ملف اتغير، و لو فيه build جديد خلص بيبدله
+    void update();
+
+    // ال program بال defines دي، null لحد ما اول build ليها يخلص
+    // اول مرة بيتطلب بيتبعت ال build بتاعه
+    const Shader *program(const ShaderDefines &defines = ShaderDefines());
+
+    // يبدأ build ل permutation من غير ما يستخدمها لسه (مثلا قبل ما نحتاجها بشوية)
+    void prepare(const ShaderDefines &defines);
+
+    // زي program بس بيستني ال build يخلص (poll(true))، null لو فشل
+    // لل headless و --output: كل ال frames لازم تترسم بنفس ال program مش بال fallback
+    const Shader *wait(const ShaderDefines &defines = ShaderDefines());
+
+    // فيه build لسه شغال
+    bool building() const;
+
+    // اول build ل permutation فشل فمفيش program ليها خالص
+    // (في Shader::failFast اي build فاشل حتي لو reload)
+    bool failed() const;
+
+    size_t permutations() const { return cache.size(); }
+    size_t reloads() const { return reload_count; }
+    size_t reloadFailures() const { return reload_failures; }
+
+    void printStats(std::ostream &out) const;
+
+    // لازم قبل ما ال context يتقفل
+    void destroy();
+
+private:
+    struct Permutation
+    {
+        ShaderDefines defines;
+        std::unique_ptr<Shader> active;
+        std::unique_ptr<Shader> pending;
+        bool failed = false;
+    };
+
+    std::string vertex_path;
+    std::string fragment_path;
+
+    // المفتاح shader_defines_key
+    std::map<std::string, Permutation> cache;
+
+    FileWatcher watcher;
+    bool watching;
+    size_t reload_count;
+    size_t reload_failures;
+
+    Permutation &find(const ShaderDefines &defines);
+    bool submit(Permutation &permutation);
+    void watchSources(const PreprocessedShader &source);
+};
+
+#endif
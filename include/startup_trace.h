@@ -0,0 +1,76 @@
+#ifndef STARTUP_TRACE_H
+#define STARTUP_TRACE_H
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+    StartupTrace:
+        بيسجل مراحل بداية البرنامج (glfwInit، النافذة، glad، ال shaders، الاعلام ...)
+        كل مرحلة ليها وقت بداية و مدة و ال thread اللي اتعملت عليه
+
+        writeJSON بيكتبهم Chrome trace (افتحه في chrome://tracing او ui.perfetto.dev)
+        فالمراحل اللي شغالة مع بعض بتبان فوق بعض علي threads مختلفة
+        و اللي لسه بتستني بعض بتبان ورا بعض علي نفس ال thread
+
+        الوقت بيتحسب من اول مرة shared() اتنادت (اول main)
+        begin / end ينفعوا من اي thread
+*/
+class StartupTrace
+{
+public:
+    StartupTrace();
+
+    static StartupTrace &shared();
+
+    // بيرجع رقم المرحلة عشان end
+    size_t begin(const std::string &name);
+    void end(size_t phase);
+
+    // مرحلة بتتقفل لوحدها في آخر ال scope
+    class Scope
+    {
+    public:
+        explicit Scope(const std::string &name, StartupTrace &trace = StartupTrace::shared());
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        StartupTrace &trace;
+        size_t phase;
+    };
+
+    // الوقت من البداية بالملي ثانية
+    double elapsedMs() const;
+
+    void printSummary(std::ostream &out) const;
+    bool writeJSON(const std::string &path) const;
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    struct Phase
+    {
+        std::string name;
+        size_t thread = 0;        // رقم صغير بترتيب ظهور ال threads (0 = main)
+        double start_us = 0.0;
+        double duration_us = -1.0; // -1 لسه مفتوحة
+    };
+
+    clock::time_point origin;
+    mutable std::mutex phases_mutex;
+    std::vector<Phase> phases;
+    std::map<std::thread::id, size_t> threads;
+
+    size_t threadIndex();
+};
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <deque>
+
+#include "gl_handle.h"
+
+/*
+    StreamBuffer:
+        buffer واحد كبير بنكتب فيه بيانات كل frame ورا بعض (ring)
+        بدل glBufferData كل frame (allocation جديدة + sync جوه الدرايفر)
+
+        الكتابة بـ glMapBufferRange و GL_MAP_UNSYNCHRONIZED_BIT
+        يعني الدرايفر مش هيستني ال GPU قبل ما يدينا ال pointer
+        فاحنا المسئولين اننا منكتبش فوق بيانات ال GPU لسه بيقراها:
+            كل frame بنحط fence علي الجزء اللي استخدمه (endFrame)
+            و قبل ما نرجع نكتب في نفس المكان بعد ما ال ring يلف بنستني ال fence ده
+
+        الحجم افتراضيا 3 frames (triple buffering) فغالبا ال fence بيكون خلص
+        و لو frame طلب اكتر من حجمه بنكبر ال buffer مرة واحدة في آخر ال frame
+
+        GL 3.3 بس (من غير ARB_buffer_storage) فمفيش persistent mapping
+        بنعمل map و unmap لكل كتابة، و ده رخيص مع UNSYNCHRONIZED
+
+        ال target لازم يبقي GL_ARRAY_BUFFER (او اي target مش جزء من ال VAO)
+        عشان map بيعمل bind لل buffer
+*/
+class StreamBuffer
+{
+public:
+    StreamBuffer();
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer &) = delete;
+    StreamBuffer &operator=(const StreamBuffer &) = delete;
+
+    bool init(GLenum target, size_t bytes_per_frame, size_t frames = 3);
+    void destroy();
+
+    // بيحجز bytes و بيرجع pointer للكتابة، offset مكانهم جوه ال buffer
+    // alignment مش لازم يبقي power of two (مثلا stride ال vertex)
+    void *map(size_t bytes, size_t alignment, size_t &offset);
+    void unmap();
+
+    // map + memcpy + unmap
+    bool write(const void *data, size_t bytes, size_t alignment, size_t &offset);
+
+    // بعد آخر draw بيستخدم بيانات ال frame ده
+    void endFrame();
+
+    GLuint id() const { return buffer.get(); }
+    size_t capacity() const { return buffer_capacity; }
+
+    // احصائيات: كام مرة استنينا fence، كام مرة ال ring لف، و كام مرة كبرناه
+    size_t waits() const { return wait_count; }
+    size_t wraps() const { return wrap_count; }
+    size_t reallocations() const { return reallocation_count; }
+
+private:
+    // جزء من ال buffer مستني ال GPU يخلص منه
+    struct Region
+    {
+        GLsync fence;
+        size_t begin;
+        size_t end;
+    };
+
+    GLenum target;
+    GLBuffer buffer;
+    size_t buffer_capacity;
+    size_t ring_frames;
+    size_t head;
+    size_t region_begin;
+    size_t frame_bytes;
+    std::deque<Region> regions;
+
+    size_t wait_count;
+    size_t wrap_count;
+    size_t reallocation_count;
+
+    void fenceRegion();
+    void waitForRange(size_t begin, size_t end);
+    void reallocate(size_t new_capacity);
+};
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "flag.h"
+#include "gl_handle.h"
+
+// صورة واحدة قبل ما تدخل ال atlas (RGBA، اول صف فوق)
+struct AtlasImage
+{
+    std::string name;
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> rgba;
+};
+
+// مكان الصورة جوه ال atlas
+// u0, v0 عند اول صف و اول عمود في الصورة (فوق شمال) و u1, v1 عند آخرهم (تحت يمين)
+struct AtlasRegion
+{
+    std::string name;
+    int layer = 0;
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+    float u0 = 0.0f, v0 = 0.0f, u1 = 0.0f, v1 = 0.0f;
+};
+
+/*
+    SkylinePacker:
+        بيرص مستطيلات في مساحة واحدة (bottom-left skyline):
+            بنحتفظ بخط "السما" اللي فوق آخر حاجة اترصت (x, y, width لكل جزء)
+            و كل مستطيل بيتحط في المكان اللي اعلاه يبقي اوطي حاجة
+            و لو فيه اكتر من مكان بنفس الارتفاع ناخد اللي بيسيب فراغ اقل
+        اسرع من MaxRects بكتير و قريب منه في الصور اللي احجامها متقاربة
+*/
+class SkylinePacker
+{
+public:
+    SkylinePacker();
+
+    void init(int width, int height);
+
+    // false لو مفيش مكان
+    bool insert(int width, int height, int &x, int &y);
+
+    // نسبة المساحة المستخدمة
+    float occupancy() const;
+
+private:
+    struct Node
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    int area_width;
+    int area_height;
+    size_t used_area;
+    std::vector<Node> skyline;
+
+    // ارتفاع المستطيل لو اتحط عند node ده، -1 لو مينفعش
+    int fit(size_t index, int width, int height) const;
+};
+
+/*
+    TextureAtlas:
+        صور كتير صغيرة (شعارات الاعلام، patterns ...) في GL_TEXTURE_2D_ARRAY واحد
+        فكل الاعلام بتترسم بـ bind واحد و ال batching مبيتكسرش
+
+        pack: علي ال CPU (من غير GL)، الصور بتترص layer ورا layer بال SkylinePacker
+              و حوالين كل صورة padding متملي بأطرافها عشان ال linear filtering ميجيبش لون الجيران
+        upload: glTexImage3D مرة واحدة لكل ال layers
+
+        offline (tools/atlaspack): write بيكتب ملف .atlas (نص: مكان كل صورة)
+        و PPM لكل layer جنبه، و read بيقراهم تاني من غير ما يرص اي حاجة
+            atlas LAYER_SIZE LAYERS
+            region NAME LAYER X Y WIDTH HEIGHT
+        (PPM مفيهوش alpha فال alpha بيرجع 255)
+*/
+class TextureAtlas
+{
+public:
+    TextureAtlas();
+    ~TextureAtlas();
+
+    TextureAtlas(const TextureAtlas &) = delete;
+    TextureAtlas &operator=(const TextureAtlas &) = delete;
+
+    bool pack(const std::vector<AtlasImage> &images, int layer_size = 1024, int padding = 2);
+
+    // كل ملفات .ppm في directory
+    bool packDirectory(const std::string &directory, int layer_size = 1024, int padding = 2);
+
+    bool write(const std::string &atlas_path) const;
+    bool read(const std::string &atlas_path);
+
+    // بيرفع ال layers و بيمسح نسختها من الميموري
+    bool upload();
+    void bind(GLuint unit = 0) const;
+    void destroy();
+
+    // null لو مفيش صورة بالاسم ده
+    const AtlasRegion *find(const std::string &name) const;
+
+    // UVs الشعارات بتبقي علي الصورة نفسها (0 لـ 1)، و هنا بتتحول لمكانها في ال atlas
+    // و layer بيتحط، مرة واحدة بس لكل علم
+    bool rewriteUVs(Flag &flag) const;
+
+    const std::vector<AtlasRegion> &regions() const { return atlas_regions; }
+    int layerSize() const { return layer_size; }
+    int layerCount() const { return layer_count; }
+    float occupancy() const { return fill; }
+    GLuint id() const { return texture.get(); }
+
+private:
+    GLTexture texture;
+    std::vector<AtlasRegion> atlas_regions;
+    std::vector<uint8_t> layers; // layer_count * layer_size * layer_size * 4 لحد upload
+    int layer_size;
+    int layer_count;
+    float fill;
+
+    void computeUVs(AtlasRegion &region) const;
+};
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef TEXTURE_COMPRESSION_H
+#define TEXTURE_COMPRESSION_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// S3TC مش core في 3.3 (extension موجود في كل درايفرات ال desktop تقريبا)
+// و ال glad المولد ممكن ميكونش فيه ال enums بتوعه
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+/*
+    TextureFormat: شكل ال pixels في ال asset pack و علي ال GPU
+
+        RGBA8   4 byte لكل pixel
+        BC1     8 byte لكل 4x4 (RGB، من غير alpha)             1/8 من RGBA8
+        BC3    16 byte لكل 4x4 (BC1 للون + block لل alpha)     1/4
+        RGTC1   8 byte لكل 4x4 (R بس: masks، height maps)      1/8
+        RGTC2  16 byte لكل 4x4 (R و G: normal maps)            1/4
+
+    ال formats المضغوطة بتترفع بـ glCompressedTexImage2D زي ما هي، و الدرايفر مبيعملش اي تحويل
+    الصورة اللي مقاسها مش مضاعفات 4 بتتملي من آخر صف و عمود (و ال GPU مبيقراش الزيادة)
+*/
+enum class TextureFormat : uint32_t
+{
+    RGBA8 = 0,
+    BC1 = 1,
+    BC3 = 2,
+    RGTC1 = 3,
+    RGTC2 = 4,
+};
+
+// للتأكد من قيمة جاية من ملف
+static const unsigned TEXTURE_FORMAT_COUNT = (unsigned)TextureFormat::RGTC2 + 1;
+
+const char *texture_format_name(TextureFormat format);
+bool parse_texture_format(const char *name, TextureFormat &format);
+
+bool texture_format_compressed(TextureFormat format);
+
+// حجم level واحد بالبايت
+size_t texture_data_size(TextureFormat format, int width, int height);
+
+// عدد ال mip levels لحد 1x1، و حجم اول levels منهم ورا بعض (كل level نص اللي قبله، اقله 1)
+int texture_max_levels(int width, int height);
+size_t texture_levels_size(TextureFormat format, int width, int height, int levels);
+
+// ال internal format بتاع glTexImage2D / glCompressedTexImage2D
+GLenum texture_internal_format(TextureFormat format);
+
+// هل الدرايفر بيقبل ال format ده (محتاج context)
+bool texture_format_supported(TextureFormat format);
+
+// block واحد: rgba فيه 4x4 pixels (64 byte، صف ورا صف)
+void encode_bc1_block(const uint8_t *rgba, uint8_t *out);
+void encode_bc3_block(const uint8_t *rgba, uint8_t *out);
+
+// BC4 (نص RGTC): قناة واحدة (0 = R ... 3 = A) في 8 byte
+void encode_bc4_block(const uint8_t *rgba, int channel, uint8_t *out);
+
+// الصورة كلها من RGBA8 (اول صف فوق)، صفوف ال blocks بتتقسم علي ال pool لو موجود
+// RGBA8 بيتنسخ زي ما هو
+void encode_texture(TextureFormat format, int width, int height, const uint8_t *rgba, std::vector<uint8_t> &out,
+                    ThreadPool *pool = nullptr);
+
+// العكس (علي ال CPU): للمقارنة و لقياس الغلط في ال bench
+void decode_texture(TextureFormat format, int width, int height, const uint8_t *data, std::vector<uint8_t> &rgba);
+
+/*
+    TextureEncoder:
+        encode_texture + cache علي الديسك، عشان ال encoding اغلي بكتير من ال upload
+        المفتاح FNV-1a علي ال format و المقاس و ال pixels نفسها، فاي تعديل في الصورة بيعمل encoding من جديد
+        الملف: TextureCacheHeader و بعده البيانات، و بيتكتب في ملف مؤقت و بعدين rename
+        زي shader_cache و flag_cache: الملفات القديمة مبتتمسحش، امسح ال directory لو كبر
+*/
+class TextureEncoder
+{
+public:
+    TextureEncoder();
+
+    // فاضي = من غير cache
+    void setCacheDirectory(const std::string &directory) { cache_directory = directory; }
+    void setThreadPool(ThreadPool *pool) { this->pool = pool; }
+
+    bool encode(TextureFormat format, int width, int height, const uint8_t *rgba, std::vector<uint8_t> &out);
+
+    size_t hits() const { return cache_hits; }
+    size_t misses() const { return cache_misses; }
+
+    void printStats(std::ostream &out) const;
+
+private:
+    std::string cache_directory;
+    ThreadPool *pool;
+
+    size_t cache_hits;
+    size_t cache_misses;
+    size_t pixels_encoded;
+    double encode_ms;
+    double load_ms;
+
+    std::string cachePath(TextureFormat format, int width, int height, const uint8_t *rgba) const;
+};
+
+#endif
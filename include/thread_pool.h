@@ -0,0 +1,118 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+    ThreadPool:
+        threads بتشتغل علي tasks صغيرة (work stealing):
+            كل thread ليه deque لوحده، بيحط فيه و بياخد من آخره
+            و لو فضي بيسرق من اول deque thread تاني
+        فال thread اللي عنده شغل كتير بيتساعد من غير queue واحد عليه lock لكل الناس
+
+        ال thread اللي بينادي parallelFor (زي thread ال GL) بيشتغل معاهم
+        لحد ما كل ال tasks تخلص، فمع thread واحد بس الشغل كله بيحصل عنده
+
+        ال tasks مينفعش تنادي OpenGL: ال context بتاع thread واحد بس
+*/
+class ThreadPool
+{
+public:
+    typedef std::function<void()> Task;
+
+    // threads: عدد ال threads كلها مع اللي بينادي (workers = threads - 1)
+    // 0 يعني عدد ال cores
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // pool مشترك بيتعمل اول مرة يتطلب
+    static ThreadPool &shared();
+
+    // عدد ال threads اللي shared هيبدأ بيه (0 = عدد ال cores)
+    // لازم قبل اول shared()، عشان ال workers ميتعملوش مرتين (مرة بالافتراضي و مرة بـ start)
+    static void setSharedThreads(size_t threads);
+
+    void start(size_t threads = 0);
+    void stop();
+
+    size_t workerCount() const { return workers.size(); }
+
+    // عدد ال threads اللي ممكن تشتغل في parallelFor (ال workers + اللي بينادي)
+    size_t concurrency() const { return workers.size() + 1; }
+
+    void submit(Task task);
+
+    // body(index) لكل index من 0 لحد count، و بيرجع لما الكل يخلص
+    // ال indices بتتقسم chunks كل واحد فيه grain علي الاقل
+    void parallelFor(size_t count, const std::function<void(size_t index)> &body, size_t grain = 1);
+
+    // بيشغل tasks من ال queues لحد ما remaining يبقي صفر
+    // (اللي بيستني بيساعد بدل ما يقعد فاضي، و من غير workers الشغل كله بيحصل هنا)
+    // و لو مفيش tasks يساعد فيها بينام لحد ما task تخلص او تتبعت، مش بيلف علي ال CPU
+    void wait(const std::atomic<size_t> &remaining);
+
+    // كام task اتسرقت من thread تاني (لل stats)
+    size_t steals() const { return steal_count.load(); }
+
+private:
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // queue لكل worker + واحد للي بيبعت من برا ال pool
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    std::condition_variable task_done; // لل wait، مع sleep_mutex
+    size_t waiters;                    // كام thread نايم في wait (تحت sleep_mutex)
+    std::atomic<size_t> queued;
+    std::atomic<size_t> steal_count;
+    std::atomic<size_t> next_queue;
+    bool stopping;
+
+    void run(size_t self);
+    bool runOne(size_t self);
+    size_t currentQueue();
+};
+
+/*
+    TaskGroup:
+        tasks بتتبعت لل pool و ال thread اللي بعتها يكمل في حاجة تانية
+        (مثلا thread ال GL بيعمل ال context و ال tasks بتقرا الملفات و تجهز الاعلام)
+        و بعدين wait بيستني الكل، و ال destructor بيستني برضه لو محدش نادي wait
+
+        لو ال pool مفيهوش workers ال tasks بتتعمل جوه wait
+*/
+class TaskGroup
+{
+public:
+    explicit TaskGroup(ThreadPool &pool = ThreadPool::shared());
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    void run(ThreadPool::Task task);
+    void wait();
+
+private:
+    ThreadPool &pool;
+    std::atomic<size_t> remaining;
+};
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef VERTEX_H
+#define VERTEX_H
+
+// النقطة زي ما بنجهزها علي ال CPU
+// الاعلام 2D فمفيش Z (ال shader بيحطها صفر لوحده)
+// الترتيب: X, Y (Position) | R, G, B, A (Color) | U, V, Layer (TextureAtlas)
+// layer < 0 يعني من غير texture، و ال UV بيترفع في ال formats اللي فيها texture بس
+// الشكل اللي بيترفع علي ال GPU بيتحدد من ال VertexLayout (vertex_layout.h)
+struct Vertex
+{
+    float x, y;
+    float r, g, b, a;
+    float u = 0.0f, v = 0.0f;
+    float layer = -1.0f;
+};
+
+#endif
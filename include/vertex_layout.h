@@ -0,0 +1,71 @@
+#ifndef VERTEX_LAYOUT_H
+#define VERTEX_LAYOUT_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "vertex.h"
+
+/*
+    VertexLayout:
+        بيوصف شكل النقطة في ال VBO: كل attribute مكانه و نوعه و حجمه
+        و منه بنطلع نداءات glVertexAttribPointer بدل ما نكتبها بايدينا في كل مكان
+
+    الاشكال المتاحة (الحجم لكل نقطة):
+        Pos3F_Col3F        24 byte  الشكل القديم: float لكل حاجة
+        Pos2F_Col4U8       12 byte  X, Y float + لون RGBA بايت لكل قناة
+        Pos2Half_Col4U8     8 byte  X, Y half float + لون RGBA
+        Pos2Snorm16_Col4U8  8 byte  X, Y short متعمله normalize من [-1, 1] + لون RGBA
+                                    (اي مكان برا [-1, 1] بيتقص)
+        Pos2F_Col4U8_Tex3F 24 byte  زي Pos2F_Col4U8 + U, V, layer في ال TextureAtlas (location 6)
+*/
+enum class VertexFormat
+{
+    Pos3F_Col3F,
+    Pos2F_Col4U8,
+    Pos2Half_Col4U8,
+    Pos2Snorm16_Col4U8,
+    Pos2F_Col4U8_Tex3F,
+};
+
+// للتأكد من قيمة جاية من ملف
+static const unsigned VERTEX_FORMAT_COUNT = (unsigned)VertexFormat::Pos2F_Col4U8_Tex3F + 1;
+
+struct VertexAttribute
+{
+    GLuint index;         // ال location في ال shader
+    GLint size;           // عدد المكونات
+    GLenum type;          // GL_FLOAT, GL_HALF_FLOAT, ...
+    GLboolean normalized; // هل القيمة تتحول ل [0, 1] او [-1, 1]
+    GLuint offset;        // مكانه جوه النقطة بالبايت
+};
+
+struct VertexLayout
+{
+    VertexFormat format;
+    GLsizei stride;
+    int attribute_count;
+    VertexAttribute attributes[3];
+
+    // بيعمل glVertexAttribPointer و glEnableVertexAttribArray لكل attribute
+    // ال VAO و ال GL_ARRAY_BUFFER لازم يكونوا متربطين قبلها
+    void apply(size_t base_offset = 0) const;
+
+    static const VertexLayout &get(VertexFormat format);
+};
+
+const char *vertex_format_name(VertexFormat format);
+bool parse_vertex_format(const char *name, VertexFormat &format);
+
+// هل ال format فيه U, V, layer (location 6)
+bool vertex_format_has_texture(VertexFormat format);
+
+// بيحول النقط من الشكل بتاع ال CPU للشكل المطلوب
+// out لازم يكون فيه مكان count * stride بايت
+void pack_vertices(VertexFormat format, const Vertex *vertices, size_t count, void *out);
+
+uint16_t float_to_half(float value);
+
+#endif
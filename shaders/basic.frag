@@ -0,0 +1,17 @@
+#version 330 core
+out vec4 FragColor;
+in vec3 vColor;
+
+#ifdef TEXTURED
+uniform sampler2DArray uAtlas;
+in vec3 vTexCoord;
+#endif
+
+void main()
+{
+    FragColor = vec4(vColor, 1.0);
+#ifdef TEXTURED
+    if (vTexCoord.z >= 0.0)
+        FragColor *= texture(uAtlas, vTexCoord);
+#endif
+}
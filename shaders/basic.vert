@@ -0,0 +1,35 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aColor;
+
+// بيانات كل علم في ال instanced mode (glVertexAttribDivisor = 1)
+// iTransform: xy = مكان العلم، zw = ال scale
+// iColor0..2: الوان الشرايط التلاتة
+layout (location = 2) in vec4 iTransform;
+layout (location = 3) in vec3 iColor0;
+layout (location = 4) in vec3 iColor1;
+layout (location = 5) in vec3 iColor2;
+
+out vec3 vColor;
+
+#ifdef TEXTURED
+// مكان النقطة في ال TextureAtlas: xy = UV، z = ال layer (سالب = من غير texture)
+layout (location = 6) in vec3 aTexCoord;
+out vec3 vTexCoord;
+#endif
+
+void main()
+{
+#ifdef INSTANCED
+    // ال mesh الاساسي علم واحد متمركز عند (0, 0)
+    // و aColor فيه وزن كل شريط (1,0,0) او (0,1,0) او (0,0,1)
+    gl_Position = vec4(aPos.xy * iTransform.zw + iTransform.xy, 0.0, 1.0);
+    vColor = mat3(iColor0, iColor1, iColor2) * aColor;
+#else
+    gl_Position = vec4(aPos, 1.0);
+    vColor = aColor;
+#endif
+#ifdef TEXTURED
+    vTexCoord = aTexCoord;
+#endif
+}
@@ -0,0 +1,496 @@
+#include "asset_loader.h"
+
+#include "gl_state_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+AssetLoader::AssetLoader()
+    : pack(nullptr), next_sequence(0), stopping(false), loader_slots(0), requested_count(0), ready_count(0),
+      failed_count(0), uploaded_bytes(0), staging_grows(0), fence_waits(0)
+{
+}
+
+AssetLoader::~AssetLoader()
+{
+    destroy();
+}
+
+bool AssetLoader::init(const AssetPack &pack, size_t staging_slots, size_t staging_bytes)
+{
+    destroy();
+    if (!pack.isOpen())
+        return false;
+
+    // الدرايفر لازم يقبل كل formats ال textures قبل ما نبدأ (S3TC extension)
+    for (size_t i = 0; i < pack.count(); i++)
+    {
+        const AssetPackEntry &entry = pack.entry(i);
+        if (entry.type == (uint32_t)AssetType::Texture && !texture_format_supported((TextureFormat)entry.format))
+        {
+            cerr << "Texture " << entry.name << " is " << texture_format_name((TextureFormat)entry.format)
+                 << ", which this driver doesn't support\n";
+            return false;
+        }
+    }
+
+    this->pack = &pack;
+    assets.resize(pack.count());
+    taken.assign(pack.count(), 0);
+
+    slots.resize(staging_slots > 0 ? staging_slots : 1);
+    for (StagingSlot &slot : slots)
+    {
+        slot.PBO = GLBuffer::create();
+        slot.capacity = staging_bytes > 0 ? staging_bytes : ASSET_DATA_ALIGNMENT;
+        GLStateCache::shared().bindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.PBO.get());
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, slot.capacity, nullptr, GL_STREAM_DRAW);
+    }
+    GLStateCache::shared().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    stopping = false;
+    loader = thread(&AssetLoader::run, this);
+
+    for (size_t i = 0; i < slots.size(); i++)
+        arm(i);
+    return true;
+}
+
+void AssetLoader::destroy()
+{
+    if (loader.joinable())
+    {
+        {
+            lock_guard<mutex> lock(queue_mutex);
+            stopping = true;
+        }
+        loader_wake.notify_all();
+        loader.join();
+    }
+
+    for (StagingSlot &slot : slots)
+    {
+        if (slot.pointer)
+        {
+            GLStateCache::shared().bindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.PBO.get());
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        }
+        if (slot.fence)
+            glDeleteSync(slot.fence);
+    }
+    if (!slots.empty())
+        GLStateCache::shared().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    slots.clear();
+
+    for (LoadedAsset &asset : assets)
+    {
+        if (asset.mesh)
+            asset.mesh->destroy();
+    }
+    assets.clear();
+
+    requests = priority_queue<Request>();
+    taken.clear();
+    armed_slots.clear();
+    done_slots.clear();
+    next_sequence = 0;
+    loader_slots = 0;
+    requested_count = 0;
+    ready_count = 0;
+    failed_count = 0;
+    uploaded_bytes = 0;
+    staging_grows = 0;
+    fence_waits = 0;
+    pack = nullptr;
+}
+
+bool AssetLoader::request(const string &name, int priority)
+{
+    int index = pack ? pack->find(name) : -1;
+    if (index < 0)
+        return false;
+    return requestIndex((size_t)index, priority);
+}
+
+void AssetLoader::requestAll(int priority)
+{
+    for (size_t i = 0; i < assets.size(); i++)
+        requestIndex(i, priority);
+}
+
+bool AssetLoader::requestIndex(size_t index, int priority)
+{
+    LoadedAsset &asset = assets[index];
+    if (asset.state == AssetState::Ready || asset.state == AssetState::Failed)
+        return true;
+    if (asset.state == AssetState::Queued && priority <= asset.priority)
+        return true;
+
+    if (asset.state == AssetState::Unloaded)
+    {
+        if (requested_count == ready_count + failed_count)
+            first_request = chrono::steady_clock::now();
+        requested_count++;
+    }
+    asset.state = AssetState::Queued;
+    asset.priority = priority;
+
+    // لو كان في ال queue بالفعل بنحط نسخة بال priority الجديد، و القديمة بتتشال لما توصل (taken)
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        requests.push({priority, next_sequence++, index});
+    }
+    loader_wake.notify_one();
+    return true;
+}
+
+void AssetLoader::arm(size_t slot_index)
+{
+    StagingSlot &slot = slots[slot_index];
+
+    // ال GPU خلص من ال PBO (fence) فمفيش داعي الدرايفر يستني حاجة
+    GLStateCache::shared().bindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.PBO.get());
+    slot.pointer = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, slot.capacity,
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    GLStateCache::shared().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (!slot.pointer)
+    {
+        cerr << "Failed to map an asset staging buffer\n";
+        slot.state = SlotState::Idle;
+        return;
+    }
+
+    slot.state = SlotState::Armed;
+    loader_slots++;
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        armed_slots.push_back(slot_index);
+    }
+    loader_wake.notify_one();
+}
+
+void AssetLoader::run()
+{
+    unique_lock<mutex> lock(queue_mutex);
+    for (;;)
+    {
+        // نسخ الطلبات القديمة (اتطلبت تاني بـ priority اعلي و اتاخدت خلاص) بتتشال
+        auto drop_taken = [this]
+        {
+            while (!requests.empty() && taken[requests.top().asset])
+                requests.pop();
+        };
+
+        // PBO اتكبر عشان asset معين ليه الاولوية علي اي طلب جديد
+        auto find_returning = [this]
+        {
+            for (size_t i = 0; i < armed_slots.size(); i++)
+            {
+                if (slots[armed_slots[i]].has_asset)
+                    return i;
+            }
+            return armed_slots.size();
+        };
+
+        loader_wake.wait(lock, [&]
+        {
+            drop_taken();
+            return stopping || (!armed_slots.empty() && (!requests.empty() || find_returning() < armed_slots.size()));
+        });
+        if (stopping)
+            return;
+
+        size_t position = find_returning();
+        if (position == armed_slots.size())
+            position = 0;
+        size_t slot_index = armed_slots[position];
+        armed_slots.erase(armed_slots.begin() + position);
+
+        StagingSlot &slot = slots[slot_index];
+        if (!slot.has_asset)
+        {
+            slot.asset = requests.top().asset;
+            requests.pop();
+            taken[slot.asset] = 1;
+        }
+        slot.has_asset = false;
+
+        drop_taken();
+        int next = requests.empty() ? -1 : (int)requests.top().asset;
+        lock.unlock();
+
+        // الديسك يبدأ يجيب اللي بعده و احنا بننسخ ده
+        if (next >= 0)
+            pack->prefetch((size_t)next);
+
+        // ال state بيكتبه thread ال GL بس (recycleSlots بيقراه من غير lock)، فالنتيجة بترجع مع ال slot
+        const AssetPackEntry &entry = pack->entry(slot.asset);
+        bool too_small = entry.size > slot.capacity;
+        if (!too_small)
+            memcpy(slot.pointer, pack->data(slot.asset), (size_t)entry.size);
+
+        lock.lock();
+        done_slots.push_back({slot_index, too_small});
+        slot_done.notify_all();
+    }
+}
+
+bool AssetLoader::upload(StagingSlot &slot)
+{
+    const AssetPackEntry &entry = pack->entry(slot.asset);
+    LoadedAsset &asset = assets[slot.asset];
+    GLStateCache &state = GLStateCache::shared();
+
+    state.bindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.PBO.get());
+    bool ok = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;
+    slot.pointer = nullptr;
+    if (!ok)
+    {
+        // الدرايفر ضيع محتوي ال mapping (نادر، مثلا تغيير شاشة)
+        cerr << "Asset staging buffer lost its contents while loading " << entry.name << "\n";
+        state.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return false;
+    }
+
+    if (entry.type == (uint32_t)AssetType::Texture)
+    {
+        // ال PBO مربوط UNPACK فال pointer الاخير ده offset جواه مش عنوان في الميموري
+        // المضغوط بيتنسخ زي ما هو، من غير اي تحويل في الدرايفر
+        // ال mips ورا بعض في نفس ال asset، كل level من ال offset بتاعه
+        TextureFormat format = (TextureFormat)entry.format;
+        int levels = (int)max(entry.mip_levels, 1u);
+        asset.texture.texture = GLTexture::create();
+        asset.texture.width = (int)entry.width;
+        asset.texture.height = (int)entry.height;
+        asset.texture.format = format;
+        asset.texture.levels = levels;
+        glBindTexture(GL_TEXTURE_2D, asset.texture.texture.get());
+        int width = (int)entry.width, height = (int)entry.height;
+        size_t offset = 0;
+        for (int level = 0; level < levels; level++)
+        {
+            size_t level_size = texture_data_size(format, width, height);
+            if (texture_format_compressed(format))
+                glCompressedTexImage2D(GL_TEXTURE_2D, level, texture_internal_format(format), width, height, 0,
+                                       (GLsizei)level_size, (const void *)offset);
+            else
+                glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                             (const void *)offset);
+            offset += level_size;
+            width = max(1, width / 2);
+            height = max(1, height / 2);
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        state.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+    else
+    {
+        state.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        asset.mesh.reset(new Mesh());
+        ok = asset.mesh->uploadStaged((VertexFormat)entry.format, slot.PBO.get(), 0, entry.vertex_count,
+                                      (size_t)entry.index_offset, entry.index_count,
+                                      entry.index_size == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT);
+    }
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.state = SlotState::Uploading;
+    return ok;
+}
+
+bool AssetLoader::finishSlot(size_t slot_index)
+{
+    StagingSlot &slot = slots[slot_index];
+    loader_slots--;
+
+    if (slot.state == SlotState::TooSmall)
+    {
+        // storage جديد اكبر، و ال PBO بيرجع لل loader و معاه نفس ال asset
+        const AssetPackEntry &entry = pack->entry(slot.asset);
+        GLStateCache::shared().bindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.PBO.get());
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        slot.pointer = nullptr;
+        slot.capacity = (size_t)entry.size;
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, slot.capacity, nullptr, GL_STREAM_DRAW);
+        staging_grows++;
+
+        slot.has_asset = true;
+        arm(slot_index);
+        return false;
+    }
+
+    LoadedAsset &asset = assets[slot.asset];
+    if (upload(slot))
+    {
+        asset.state = AssetState::Ready;
+        ready_count++;
+        uploaded_bytes += (size_t)pack->entry(slot.asset).size;
+    }
+    else
+    {
+        asset.state = AssetState::Failed;
+        failed_count++;
+    }
+    last_ready = chrono::steady_clock::now();
+
+    // لو ال unmap فشل مفيش fence، فيرجع لل loader علي طول
+    if (!slot.fence)
+        arm(slot_index);
+    return asset.state == AssetState::Ready;
+}
+
+bool AssetLoader::recycleSlots(bool wait)
+{
+    bool in_flight = false;
+    for (size_t i = 0; i < slots.size(); i++)
+    {
+        StagingSlot &slot = slots[i];
+        if (slot.state != SlotState::Uploading)
+            continue;
+        in_flight = true;
+
+        GLenum result = glClientWaitSync(slot.fence, 0, 0);
+        if (result == GL_TIMEOUT_EXPIRED && wait)
+        {
+            fence_waits++;
+            result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+            wait = false;
+        }
+        if (result == GL_TIMEOUT_EXPIRED)
+            continue;
+        if (result == GL_WAIT_FAILED)
+            cerr << "glClientWaitSync failed in the asset loader\n";
+
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+        arm(i);
+    }
+    return in_flight;
+}
+
+size_t AssetLoader::progress(bool wait)
+{
+    recycleSlots(false);
+
+    deque<DoneSlot> done;
+    {
+        unique_lock<mutex> lock(queue_mutex);
+        if (wait && done_slots.empty())
+        {
+            if (loader_slots == 0)
+            {
+                // كل ال PBOs مستنية ال GPU: نستني اقدمهم يخلص و نرجعه لل loader
+                lock.unlock();
+                if (!recycleSlots(true))
+                    failQueued();
+                return 0;
+            }
+            slot_done.wait(lock, [this] { return !done_slots.empty(); });
+        }
+        done.swap(done_slots);
+    }
+
+    size_t became_ready = 0;
+    for (const DoneSlot &slot : done)
+    {
+        slots[slot.index].state = slot.too_small ? SlotState::TooSmall : SlotState::Filled;
+        if (finishSlot(slot.index))
+            became_ready++;
+    }
+    return became_ready;
+}
+
+void AssetLoader::failQueued()
+{
+    // مفيش ولا PBO اتعمله map، فمفيش حاجة هتتحمل تاني
+    cerr << "No asset staging buffers left, " << pending() << " assets not loaded\n";
+    for (LoadedAsset &asset : assets)
+    {
+        if (asset.state == AssetState::Queued)
+        {
+            asset.state = AssetState::Failed;
+            failed_count++;
+        }
+    }
+}
+
+size_t AssetLoader::update()
+{
+    if (!pack)
+        return 0;
+    return progress(false);
+}
+
+bool AssetLoader::wait(const string &name)
+{
+    int index = pack ? pack->find(name) : -1;
+    if (index < 0)
+        return false;
+
+    LoadedAsset &asset = assets[(size_t)index];
+    if (asset.state == AssetState::Unloaded)
+        requestIndex((size_t)index, asset.priority);
+    while (asset.state == AssetState::Queued)
+        progress(true);
+    return asset.state == AssetState::Ready;
+}
+
+void AssetLoader::finish()
+{
+    while (pack && pending() > 0)
+        progress(true);
+}
+
+bool AssetLoader::ready(const string &name) const
+{
+    int index = pack ? pack->find(name) : -1;
+    return index >= 0 && assets[(size_t)index].state == AssetState::Ready;
+}
+
+const Mesh *AssetLoader::mesh(const string &name) const
+{
+    int index = pack ? pack->find(name) : -1;
+    if (index < 0 || assets[(size_t)index].state != AssetState::Ready)
+        return nullptr;
+    return assets[(size_t)index].mesh.get();
+}
+
+const LoadedTexture *AssetLoader::texture(const string &name) const
+{
+    int index = pack ? pack->find(name) : -1;
+    if (index < 0 || assets[(size_t)index].state != AssetState::Ready ||
+        pack->entry((size_t)index).type != (uint32_t)AssetType::Texture)
+        return nullptr;
+    return &assets[(size_t)index].texture;
+}
+
+void AssetLoader::printStats(ostream &out) const
+{
+    if (!pack)
+        return;
+
+    double ms = ready_count + failed_count > 0
+                    ? chrono::duration<double, milli>(last_ready - first_request).count()
+                    : 0.0;
+    double megabytes = uploaded_bytes / (1024.0 * 1024.0);
+    size_t staging_bytes = 0;
+    for (const StagingSlot &slot : slots)
+        staging_bytes += slot.capacity;
+
+    out << "Asset loader: " << ready_count << "/" << pack->count() << " assets";
+    if (failed_count > 0)
+        out << " (" << failed_count << " failed)";
+    out << ", " << megabytes << " MB in " << ms << " ms";
+    if (ms > 0.0)
+        out << " (" << megabytes / (ms / 1000.0) << " MB/s)";
+    out << ", staging " << slots.size() << " PBOs / " << staging_bytes / 1024 << " KB (" << staging_grows
+        << " grows, " << fence_waits << " fence waits)" << (pack->mapped() ? "" : ", pack read without mmap")
+        << "\n";
+}
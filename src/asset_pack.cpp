@@ -0,0 +1,289 @@
+#include "asset_pack.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+static uint64_t align_up(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+const char *asset_type_name(AssetType type)
+{
+    switch (type)
+    {
+    case AssetType::Mesh:
+        return "mesh";
+    case AssetType::Texture:
+        return "texture";
+    }
+    return "unknown";
+}
+
+AssetPack::AssetPack()
+    : header(nullptr), entries(nullptr)
+{
+}
+
+bool AssetPack::open(const string &path)
+{
+    close();
+    if (!file.open(path))
+        return false;
+
+    if (!validate(path))
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+// زي FlagLibrary: الملف ممكن يبقي ناقص او بايظ، فكل offset لازم يبقي جوه الملف
+bool AssetPack::validate(const string &path)
+{
+    const unsigned char *bytes = file.data();
+    size_t size = file.size();
+
+    if (size < sizeof(AssetPackHeader))
+    {
+        cerr << path << ": not an asset pack\n";
+        return false;
+    }
+
+    const AssetPackHeader *pack = (const AssetPackHeader *)bytes;
+    if (memcmp(pack->magic, ASSET_PACK_MAGIC, 4) != 0 || pack->version != ASSET_PACK_VERSION)
+    {
+        cerr << path << ": not an asset pack or an older version\n";
+        return false;
+    }
+
+    uint64_t entries_end = sizeof(AssetPackHeader) + (uint64_t)pack->asset_count * sizeof(AssetPackEntry);
+    if (entries_end > size)
+    {
+        cerr << path << ": truncated asset pack\n";
+        return false;
+    }
+
+    const AssetPackEntry *pack_entries = (const AssetPackEntry *)(bytes + sizeof(AssetPackHeader));
+    for (uint32_t i = 0; i < pack->asset_count; i++)
+    {
+        const AssetPackEntry &asset = pack_entries[i];
+        bool ok = memchr(asset.name, '\0', ASSET_NAME_LENGTH) != nullptr && asset.offset >= entries_end &&
+                  asset.offset % ASSET_DATA_ALIGNMENT == 0 && asset.offset <= size && asset.size <= size - asset.offset;
+
+        if (ok && asset.type == (uint32_t)AssetType::Mesh)
+        {
+            size_t stride = asset.format < VERTEX_FORMAT_COUNT
+                                ? VertexLayout::get((VertexFormat)asset.format).stride
+                                : 0;
+            // offset <= حد و length <= حد - offset، عشان index_offset بايظ ميعملش wrap في الجمع
+            ok = stride > 0 && (asset.index_size == 2 || asset.index_size == 4) &&
+                 asset.index_offset % asset.index_size == 0 &&
+                 (uint64_t)asset.vertex_count * stride <= asset.index_offset && asset.index_offset <= asset.size &&
+                 (uint64_t)asset.index_count * asset.index_size <= asset.size - asset.index_offset;
+        }
+        else if (ok && asset.type == (uint32_t)AssetType::Texture)
+        {
+            ok = asset.format < TEXTURE_FORMAT_COUNT && asset.width > 0 && asset.height > 0 &&
+                 asset.width <= 0x10000 && asset.height <= 0x10000 &&
+                 asset.mip_levels <= (uint32_t)texture_max_levels((int)asset.width, (int)asset.height) &&
+                 texture_levels_size((TextureFormat)asset.format, (int)asset.width, (int)asset.height,
+                                     (int)max(asset.mip_levels, 1u)) <= asset.size;
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            cerr << path << ": bad entry " << i << " in asset pack\n";
+            return false;
+        }
+    }
+
+    header = pack;
+    entries = pack_entries;
+    return true;
+}
+
+void AssetPack::close()
+{
+    file.close();
+    header = nullptr;
+    entries = nullptr;
+}
+
+int AssetPack::find(const string &name) const
+{
+    for (size_t i = 0; i < count(); i++)
+    {
+        if (name == entries[i].name)
+            return (int)i;
+    }
+    return -1;
+}
+
+void AssetPack::prefetch(size_t index) const
+{
+    file.prefetch((size_t)entries[index].offset, (size_t)entries[index].size);
+}
+
+bool AssetPackWriter::addEntry(const string &name, AssetPackEntry &entry)
+{
+    if (name.empty() || name.size() >= ASSET_NAME_LENGTH)
+    {
+        cerr << "Asset name '" << name << "' must be 1 to " << ASSET_NAME_LENGTH - 1 << " characters\n";
+        return false;
+    }
+    for (const AssetPackEntry &existing : entries)
+    {
+        if (name == existing.name)
+        {
+            cerr << "Duplicate asset '" << name << "'\n";
+            return false;
+        }
+    }
+
+    strncpy(entry.name, name.c_str(), ASSET_NAME_LENGTH - 1);
+    entries.push_back(entry);
+    return true;
+}
+
+bool AssetPackWriter::addMesh(const string &name, const MeshBuilder &mesh, VertexFormat format)
+{
+    const vector<Vertex> &vertices = mesh.vertices();
+    const vector<uint32_t> &indices = mesh.indices();
+    if (vertices.empty() || indices.empty())
+    {
+        cerr << "Mesh '" << name << "' is empty\n";
+        return false;
+    }
+
+    const VertexLayout &layout = VertexLayout::get(format);
+    size_t index_size = vertices.size() <= 0x10000 ? sizeof(uint16_t) : sizeof(uint32_t);
+    size_t index_offset = (size_t)align_up(vertices.size() * layout.stride, 4);
+
+    vector<unsigned char> payload(index_offset + indices.size() * index_size, 0);
+    pack_vertices(format, vertices.data(), vertices.size(), payload.data());
+    if (index_size == sizeof(uint16_t))
+    {
+        uint16_t *out = (uint16_t *)(payload.data() + index_offset);
+        for (size_t i = 0; i < indices.size(); i++)
+            out[i] = (uint16_t)indices[i];
+    }
+    else
+    {
+        memcpy(payload.data() + index_offset, indices.data(), indices.size() * index_size);
+    }
+
+    AssetPackEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.type = (uint32_t)AssetType::Mesh;
+    entry.format = (uint32_t)format;
+    entry.vertex_count = (uint32_t)vertices.size();
+    entry.index_count = (uint32_t)indices.size();
+    entry.index_size = (uint32_t)index_size;
+    entry.size = payload.size();
+    entry.index_offset = index_offset;
+
+    if (!addEntry(name, entry))
+        return false;
+    payloads.push_back(move(payload));
+    return true;
+}
+
+bool AssetPackWriter::addTexture(const string &name, int width, int height, const uint8_t *data, TextureFormat format,
+                                 int mip_levels)
+{
+    if (width <= 0 || height <= 0)
+    {
+        cerr << "Texture '" << name << "' is empty\n";
+        return false;
+    }
+    if (mip_levels < 1 || mip_levels > texture_max_levels(width, height))
+    {
+        cerr << "Texture '" << name << "' can't have " << mip_levels << " mip levels\n";
+        return false;
+    }
+
+    AssetPackEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.type = (uint32_t)AssetType::Texture;
+    entry.format = (uint32_t)format;
+    entry.width = (uint32_t)width;
+    entry.height = (uint32_t)height;
+    entry.mip_levels = (uint32_t)mip_levels;
+    entry.size = texture_levels_size(format, width, height, mip_levels);
+
+    if (!addEntry(name, entry))
+        return false;
+    payloads.emplace_back(data, data + entry.size);
+    return true;
+}
+
+bool AssetPackWriter::write(const string &path) const
+{
+    vector<AssetPackEntry> table = entries;
+
+    AssetPackHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ASSET_PACK_MAGIC, 4);
+    header.version = ASSET_PACK_VERSION;
+    header.asset_count = (uint32_t)table.size();
+
+    uint64_t offset = align_up(sizeof(AssetPackHeader) + table.size() * sizeof(AssetPackEntry), ASSET_DATA_ALIGNMENT);
+    for (AssetPackEntry &entry : table)
+    {
+        entry.offset = offset;
+        offset = align_up(offset + entry.size, ASSET_DATA_ALIGNMENT);
+        header.data_size += entry.size;
+    }
+
+    error_code ec;
+    filesystem::path parent = filesystem::path(path).parent_path();
+    if (!parent.empty())
+        filesystem::create_directories(parent, ec);
+
+    string temp_path = path + ".tmp" + to_string(chrono::steady_clock::now().time_since_epoch().count());
+    {
+        ofstream file(temp_path, ios::binary | ios::trunc);
+        if (!file)
+        {
+            cerr << "Can't write " << temp_path << "\n";
+            return false;
+        }
+
+        static const char padding[ASSET_DATA_ALIGNMENT] = {};
+        file.write((const char *)&header, sizeof(header));
+        file.write((const char *)table.data(), table.size() * sizeof(AssetPackEntry));
+        for (size_t i = 0; i < table.size() && file; i++)
+        {
+            file.write(padding, (streamsize)(table[i].offset - (uint64_t)file.tellp()));
+            file.write((const char *)payloads[i].data(), payloads[i].size());
+        }
+        if (!file)
+        {
+            cerr << "Can't write " << temp_path << "\n";
+            file.close();
+            filesystem::remove(temp_path, ec);
+            return false;
+        }
+    }
+
+    filesystem::rename(temp_path, path, ec);
+    if (ec)
+    {
+        cerr << "Can't write " << path << ": " << ec.message() << "\n";
+        filesystem::remove(temp_path, ec);
+        return false;
+    }
+    return true;
+}
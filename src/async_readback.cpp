@@ -0,0 +1,156 @@
+#include "async_readback.h"
+
+#include "gl_state_cache.h"
+
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+using namespace std;
+
+AsyncReadback::AsyncReadback()
+    : head(0), in_flight(0), stall_count(0), frame_width(0), frame_height(0)
+{
+}
+
+AsyncReadback::~AsyncReadback()
+{
+    destroy();
+}
+
+bool AsyncReadback::init(int width, int height, size_t ring_size)
+{
+    destroy();
+
+    if (ring_size == 0)
+        ring_size = 1;
+
+    frame_width = width;
+    frame_height = height;
+    slots.resize(ring_size);
+
+    // GL_STREAM_READ: ال GPU بيكتب و ال CPU بيقرا مرة واحدة
+    GLsizeiptr size = (GLsizeiptr)width * height * 4;
+    for (Slot &slot : slots)
+    {
+        slot.PBO = GLBuffer::create();
+        GLStateCache::shared().bindBuffer(GL_PIXEL_PACK_BUFFER, slot.PBO.get());
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+    }
+    GLStateCache::shared().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (glGetError() != GL_NO_ERROR)
+    {
+        cerr << "Failed to create the readback buffers\n";
+        destroy();
+        return false;
+    }
+
+    return true;
+}
+
+void AsyncReadback::destroy()
+{
+    for (Slot &slot : slots)
+    {
+        if (slot.fence)
+            glDeleteSync(slot.fence);
+    }
+    slots.clear();
+    completed.clear();
+    head = 0;
+    in_flight = 0;
+    stall_count = 0;
+}
+
+void AsyncReadback::capture(const Framebuffer &framebuffer, size_t frame_index)
+{
+    // ال ring مليان: اقدم slot هو اللي عليه الدور، نقراه الاول
+    if (in_flight == slots.size())
+    {
+        Slot &oldest = slots[(head + slots.size() - in_flight) % slots.size()];
+        ReadbackFrame frame;
+        retire(oldest, frame, true);
+        completed.push_back(move(frame));
+        in_flight--;
+        stall_count++;
+    }
+
+    Slot &slot = slots[head];
+    slot.frame_index = frame_index;
+
+    // مع PBO متربط، آخر parameter بتاع glReadPixels بقي offset جوه ال buffer
+    GLStateCache::shared().bindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer.id());
+    GLStateCache::shared().bindBuffer(GL_PIXEL_PACK_BUFFER, slot.PBO.get());
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, frame_width, frame_height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    GLStateCache::shared().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    GLStateCache::shared().bindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    head = (head + 1) % slots.size();
+    in_flight++;
+}
+
+bool AsyncReadback::readFrame(ReadbackFrame &out, bool wait)
+{
+    if (!completed.empty())
+    {
+        // بنبدل ال vectors عشان ال buffer القديم بتاع out يفضل متاح للاستخدام
+        swap(out, completed.front());
+        completed.pop_front();
+        return true;
+    }
+
+    if (in_flight == 0)
+        return false;
+
+    Slot &oldest = slots[(head + slots.size() - in_flight) % slots.size()];
+    if (!retire(oldest, out, wait))
+        return false;
+
+    in_flight--;
+    return true;
+}
+
+bool AsyncReadback::retire(Slot &slot, ReadbackFrame &out, bool wait)
+{
+    // timeout صفر = مجرد سؤال، و GL_SYNC_FLUSH_COMMANDS_BIT بيضمن ان ال fence اتبعت فعلا
+    GLuint64 timeout = wait ? GL_TIMEOUT_IGNORED : 0;
+    GLenum result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+    if (result == GL_TIMEOUT_EXPIRED)
+        return false;
+
+    if (result == GL_WAIT_FAILED)
+        cerr << "glClientWaitSync failed while reading frame " << slot.frame_index << "\n";
+
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+
+    out.index = slot.frame_index;
+    out.width = frame_width;
+    out.height = frame_height;
+    out.pixels.resize((size_t)frame_width * frame_height * 4);
+
+    GLStateCache::shared().bindBuffer(GL_PIXEL_PACK_BUFFER, slot.PBO.get());
+    void *mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, out.pixels.size(), GL_MAP_READ_BIT);
+    out.valid = mapped != nullptr;
+    if (mapped)
+    {
+        memcpy(out.pixels.data(), mapped, out.pixels.size());
+        // GL_FALSE = ال storage باظ و هو متعمله map، فاللي اتنسخ مينفعش يتكتب
+        if (glUnmapBuffer(GL_PIXEL_PACK_BUFFER) != GL_TRUE)
+        {
+            cerr << "The readback buffer for frame " << slot.frame_index << " was corrupted\n";
+            out.valid = false;
+        }
+    }
+    else
+    {
+        cerr << "Failed to map the readback buffer for frame " << slot.frame_index << "\n";
+    }
+    GLStateCache::shared().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    return true;
+}
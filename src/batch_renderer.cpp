@@ -0,0 +1,355 @@
+#include "batch_renderer.h"
+
+#include "gl_state_cache.h"
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+QuadBatch::QuadBatch()
+    : vertex_format(VertexFormat::Pos2F_Col4U8), stride(0), max_quads(1), open_first(0)
+{
+}
+
+void QuadBatch::init(VertexFormat format, size_t max_quads)
+{
+    vertex_format = format;
+    stride = VertexLayout::get(format).stride;
+    this->max_quads = max_quads < 1 ? 1 : max_quads;
+    clear();
+}
+
+void QuadBatch::clear()
+{
+    stream.clear();
+    closed.clear();
+    open_first = 0;
+}
+
+void QuadBatch::drawQuad(float x0, float y0, float x1, float y1, float r, float g, float b)
+{
+    if (openVertexCount() + 4 > max_quads * 4)
+        closeSegment();
+
+    Vertex quad[4] = {
+        {x0, y0, r, g, b, 1.0f}, // BL
+        {x1, y0, r, g, b, 1.0f}, // BR
+        {x0, y1, r, g, b, 1.0f}, // TL
+        {x1, y1, r, g, b, 1.0f}, // TR
+    };
+
+    size_t offset = stream.size();
+    stream.resize(offset + 4 * stride);
+    pack_vertices(vertex_format, quad, 4, &stream[offset]);
+}
+
+void QuadBatch::drawTexturedQuad(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1,
+                                 float layer)
+{
+    if (openVertexCount() + 4 > max_quads * 4)
+        closeSegment();
+
+    // u0, v0 فوق شمال في الصورة، يعني عند y1
+    Vertex quad[4] = {
+        {x0, y0, 1.0f, 1.0f, 1.0f, 1.0f, u0, v1, layer}, // BL
+        {x1, y0, 1.0f, 1.0f, 1.0f, 1.0f, u1, v1, layer}, // BR
+        {x0, y1, 1.0f, 1.0f, 1.0f, 1.0f, u0, v0, layer}, // TL
+        {x1, y1, 1.0f, 1.0f, 1.0f, 1.0f, u1, v0, layer}, // TR
+    };
+
+    size_t offset = stream.size();
+    stream.resize(offset + 4 * stride);
+    pack_vertices(vertex_format, quad, 4, &stream[offset]);
+}
+
+void QuadBatch::drawFlag(const Flag &flag, float x, float y, float scale)
+{
+    float half_width = flag.width * scale;
+    for (const FlagStripe &stripe : flag.stripes)
+    {
+        drawQuad(x - half_width, y + stripe.bottom * scale,
+                 x + half_width, y + stripe.top * scale,
+                 stripe.r, stripe.g, stripe.b);
+    }
+
+    // الشعارات بعد الشرايط عشان تترسم فوقها، و بس لو ال format فيه UV
+    if (!vertex_format_has_texture(vertex_format))
+        return;
+    for (const FlagEmblem &emblem : flag.emblems)
+    {
+        if (emblem.layer < 0.0f)
+            continue;
+        drawTexturedQuad(x + emblem.x0 * scale, y + emblem.y0 * scale,
+                         x + emblem.x1 * scale, y + emblem.y1 * scale,
+                         emblem.u0, emblem.v0, emblem.u1, emblem.v1, emblem.layer);
+    }
+}
+
+void QuadBatch::closeSegment()
+{
+    size_t count = openVertexCount();
+    if (count == 0)
+        return;
+
+    closed.push_back({open_first, count});
+    open_first += count;
+}
+
+BatchRenderer::BatchRenderer()
+    : index_type(GL_UNSIGNED_INT), max_quads(0),
+      vertex_format(VertexFormat::Pos2F_Col4U8), stride(0),
+      list(nullptr), pass(), draw_calls(0), vertices_drawn(0), bytes_uploaded(0)
+{
+}
+
+BatchRenderer::~BatchRenderer()
+{
+    destroy();
+}
+
+// نفس ترتيب المثلثات اللي كان في main
+// النقط: 0 = BL, 1 = BR, 2 = TL, 3 = TR
+// Triangle 1: BL, BR, TL | Triangle 2: TR, TL, BR
+template <typename Index>
+static vector<Index> make_quad_indices(size_t quads)
+{
+    vector<Index> indices(quads * 6);
+    for (size_t q = 0; q < quads; q++)
+    {
+        Index base = (Index)(q * 4);
+        Index *out = &indices[q * 6];
+        out[0] = base + 0;
+        out[1] = base + 1;
+        out[2] = base + 2;
+        out[3] = base + 3;
+        out[4] = base + 2;
+        out[5] = base + 1;
+    }
+    return indices;
+}
+
+bool BatchRenderer::init(size_t max_quads, VertexFormat format)
+{
+    destroy();
+
+    this->max_quads = max_quads < 1 ? 1 : max_quads;
+    vertex_format = format;
+    stride = VertexLayout::get(format).stride;
+    pending.init(format, this->max_quads);
+
+    // بنبدأ بمساحة 4096 نقطة لكل frame و ال StreamBuffer بيكبر لوحده لو احتجنا
+    if (!vertex_stream.init(GL_ARRAY_BUFFER, 4 * 1024 * stride))
+        return false;
+
+    // ال indices ثابتة فبنرفعها مرة واحدة بس
+    GPUResourcePool &pool = GPUResourcePool::shared();
+    if (this->max_quads * 4 <= 0xFFFF + 1)
+    {
+        vector<uint16_t> indices = make_quad_indices<uint16_t>(this->max_quads);
+        index_type = GL_UNSIGNED_SHORT;
+        quad_indices = pool.acquireBuffer(indices.size() * sizeof(uint16_t), indices.data());
+    }
+    else
+    {
+        vector<uint32_t> indices = make_quad_indices<uint32_t>(this->max_quads);
+        index_type = GL_UNSIGNED_INT;
+        quad_indices = pool.acquireBuffer(indices.size() * sizeof(uint32_t), indices.data());
+    }
+
+    vertex_array = pool.acquireVertexArray();
+    GLStateCache::shared().bindVertexArray(vertex_array.get());
+    GLStateCache::shared().bindBuffer(GL_ARRAY_BUFFER, vertex_stream.id());
+    GLStateCache::shared().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, quad_indices.get());
+
+    VertexLayout::get(format).apply();
+
+    GLStateCache::shared().bindVertexArray(0);
+    GLStateCache::shared().bindBuffer(GL_ARRAY_BUFFER, 0);
+    GLStateCache::shared().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    return vertex_array && quad_indices;
+}
+
+void BatchRenderer::destroy()
+{
+    vertex_array.reset();
+    quad_indices.reset();
+    vertex_stream.destroy();
+    pending.clear();
+    list = nullptr;
+}
+
+void BatchRenderer::initBatch(QuadBatch &batch) const
+{
+    batch.init(vertex_format, max_quads);
+}
+
+void BatchRenderer::begin()
+{
+    pending.clear();
+    list = nullptr;
+    draw_calls = 0;
+    vertices_drawn = 0;
+    bytes_uploaded = 0;
+}
+
+void BatchRenderer::begin(DrawList &list, const DrawPass &pass)
+{
+    begin();
+    this->list = &list;
+    this->pass = pass;
+}
+
+void BatchRenderer::drawQuad(float x0, float y0, float x1, float y1, float r, float g, float b)
+{
+    // وضع ال list: ال QuadBatch بيقسم لوحده
+    if (!list && pending.openVertexCount() + 4 > max_quads * 4)
+        flush();
+
+    pending.drawQuad(x0, y0, x1, y1, r, g, b);
+}
+
+void BatchRenderer::drawTexturedQuad(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1,
+                                     float layer)
+{
+    if (!list && pending.openVertexCount() + 4 > max_quads * 4)
+        flush();
+
+    pending.drawTexturedQuad(x0, y0, x1, y1, u0, v0, u1, v1, layer);
+}
+
+void BatchRenderer::drawFlag(const Flag &flag, float x, float y, float scale)
+{
+    float half_width = flag.width * scale;
+    for (const FlagStripe &stripe : flag.stripes)
+    {
+        drawQuad(x - half_width, y + stripe.bottom * scale,
+                 x + half_width, y + stripe.top * scale,
+                 stripe.r, stripe.g, stripe.b);
+    }
+
+    if (!vertex_format_has_texture(vertex_format))
+        return;
+    for (const FlagEmblem &emblem : flag.emblems)
+    {
+        if (emblem.layer < 0.0f)
+            continue;
+        drawTexturedQuad(x + emblem.x0 * scale, y + emblem.y0 * scale,
+                         x + emblem.x1 * scale, y + emblem.y1 * scale,
+                         emblem.u0, emblem.v0, emblem.u1, emblem.v1, emblem.layer);
+    }
+}
+
+void BatchRenderer::flush()
+{
+    pending.closeSegment();
+
+    // وضع ال list: النقط بتفضل في pending لحد end
+    if (list || pending.bytes() == 0)
+        return;
+
+    // النقط بتتكتب في ال ring علي مضاعفات ال stride
+    // فمكانها = رقم اول نقطة، و ال indices الثابتة بتتزق بيه (base vertex)
+    size_t offset = 0;
+    if (!vertex_stream.write(pending.data(), pending.bytes(), stride, offset))
+    {
+        pending.clear();
+        return;
+    }
+
+    GLStateCache::shared().bindVertexArray(vertex_array.get());
+    GLsizei quads = (GLsizei)(pending.vertexCount() / 4);
+    glDrawElementsBaseVertex(GL_TRIANGLES, quads * 6, index_type, (void *)0, (GLint)(offset / stride));
+
+    draw_calls++;
+    vertices_drawn += pending.vertexCount();
+    bytes_uploaded += pending.bytes();
+    pending.clear();
+
+    GLStateCache::shared().bindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// ال caller بيملا نفس ال batches كل frame، فلازم تتفضي حتي لو مترسمتش
+// و الا النقط بتتراكم و بتترفع تاني في ال frame الجاي
+static void clear_batches(QuadBatch *batches, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        batches[i].clear();
+}
+
+void BatchRenderer::record(QuadBatch *batches, size_t count)
+{
+    if (!list)
+    {
+        clear_batches(batches, count);
+        return;
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        QuadBatch &batch = batches[i];
+        if (batch.format() != vertex_format || batch.maxQuads() != max_quads)
+        {
+            cerr << "QuadBatch doesn't match the batch renderer format\n";
+            clear_batches(batches, count);
+            return;
+        }
+        batch.closeSegment();
+        total += batch.bytes();
+    }
+    if (total == 0)
+    {
+        clear_batches(batches, count);
+        return;
+    }
+
+    // map واحد للكل: مفيش batch ممكن يكتب فوق نقط batch تاني لسه مترسمتش
+    size_t offset = 0;
+    unsigned char *out = (unsigned char *)vertex_stream.map(total, stride, offset);
+    if (!out)
+    {
+        clear_batches(batches, count);
+        return;
+    }
+
+    GLint base_vertex = (GLint)(offset / stride);
+    for (size_t i = 0; i < count; i++)
+    {
+        QuadBatch &batch = batches[i];
+        memcpy(out, batch.data(), batch.bytes());
+        out += batch.bytes();
+
+        for (const QuadBatch::Segment &segment : batch.segments())
+        {
+            GLsizei quads = (GLsizei)(segment.vertex_count / 4);
+            list->pushElements(pass, vertex_array.get(), quads * 6, index_type, 0,
+                               base_vertex + (GLint)segment.first_vertex);
+            draw_calls++;
+            vertices_drawn += segment.vertex_count;
+        }
+
+        base_vertex += (GLint)batch.vertexCount();
+        batch.clear();
+    }
+    vertex_stream.unmap();
+
+    bytes_uploaded += total;
+}
+
+void BatchRenderer::end()
+{
+    flush();
+    if (list)
+        record(&pending, 1);
+    else
+        vertex_stream.endFrame();
+}
+
+void BatchRenderer::endFrame()
+{
+    vertex_stream.endFrame();
+    list = nullptr;
+}
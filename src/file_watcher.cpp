@@ -0,0 +1,177 @@
+#include "file_watcher.h"
+
+#include <algorithm>
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// ال editor بيخلص الحفظ في وقت اقل من كده غالبا
+static const chrono::milliseconds SETTLE_TIME(50);
+
+// من غير inotify: كل قد ايه نبص علي اوقات الملفات
+static const chrono::milliseconds SCAN_INTERVAL(250);
+
+static filesystem::file_time_type modified_time(const string &path)
+{
+    error_code ec;
+    filesystem::file_time_type time = filesystem::last_write_time(path, ec);
+    return ec ? filesystem::file_time_type() : time;
+}
+
+FileWatcher::FileWatcher()
+    : inotify_fd(-1), dirty(false)
+{
+#ifdef __linux__
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd < 0)
+        cerr << "inotify_init1 failed, watching files by polling\n";
+#endif
+}
+
+FileWatcher::~FileWatcher()
+{
+    stop();
+#ifdef __linux__
+    if (inotify_fd >= 0)
+        close(inotify_fd);
+#endif
+    inotify_fd = -1;
+}
+
+bool FileWatcher::watch(const string &path)
+{
+    for (const WatchedFile &file : files)
+    {
+        if (file.path == path)
+            return true;
+    }
+
+    filesystem::path file(path);
+    WatchedFile watched;
+    watched.path = path;
+    watched.name = file.filename().string();
+    watched.directory = file.has_parent_path() ? file.parent_path().string() : string(".");
+    watched.modified = modified_time(path);
+
+#ifdef __linux__
+    if (inotify_fd >= 0)
+    {
+        bool known = false;
+        for (const auto &entry : directories)
+            known = known || entry.second == watched.directory;
+
+        if (!known)
+        {
+            int wd = inotify_add_watch(inotify_fd, watched.directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+            if (wd < 0)
+            {
+                cerr << "Can't watch " << watched.directory << "\n";
+                return false;
+            }
+            directories[wd] = watched.directory;
+        }
+    }
+#endif
+
+    files.push_back(watched);
+    last_scan = Clock::now();
+    return true;
+}
+
+void FileWatcher::stop()
+{
+#ifdef __linux__
+    if (inotify_fd >= 0)
+    {
+        for (const auto &entry : directories)
+            inotify_rm_watch(inotify_fd, entry.first);
+    }
+#endif
+    directories.clear();
+    files.clear();
+    dirty = false;
+    pending_files.clear();
+}
+
+const char *FileWatcher::backend() const
+{
+    return inotify_fd >= 0 ? "inotify" : "polling";
+}
+
+void FileWatcher::markChanged(const string &path)
+{
+    if (find(pending_files.begin(), pending_files.end(), path) == pending_files.end())
+        pending_files.push_back(path);
+
+    // كل event جديد بيأجل ال reload شوية
+    dirty = true;
+    dirty_since = Clock::now();
+}
+
+void FileWatcher::readEvents()
+{
+#ifdef __linux__
+    alignas(inotify_event) char buffer[4096];
+    while (true)
+    {
+        ssize_t length = read(inotify_fd, buffer, sizeof(buffer));
+        if (length <= 0)
+            return;
+
+        for (char *cursor = buffer; cursor < buffer + length;)
+        {
+            const inotify_event *event = (const inotify_event *)cursor;
+            cursor += sizeof(inotify_event) + event->len;
+
+            auto directory = directories.find(event->wd);
+            if (directory == directories.end() || event->len == 0)
+                continue;
+
+            for (const WatchedFile &file : files)
+            {
+                if (file.directory == directory->second && file.name == event->name)
+                    markChanged(file.path);
+            }
+        }
+    }
+#endif
+}
+
+void FileWatcher::scanTimes()
+{
+    Clock::time_point now = Clock::now();
+    if (now - last_scan < SCAN_INTERVAL)
+        return;
+    last_scan = now;
+
+    for (WatchedFile &file : files)
+    {
+        filesystem::file_time_type modified = modified_time(file.path);
+        if (modified != file.modified)
+        {
+            file.modified = modified;
+            markChanged(file.path);
+        }
+    }
+}
+
+bool FileWatcher::poll()
+{
+    if (inotify_fd >= 0)
+        readEvents();
+    else
+        scanTimes();
+
+    if (!dirty || Clock::now() - dirty_since < SETTLE_TIME)
+        return false;
+
+    dirty = false;
+    changed_files.swap(pending_files);
+    pending_files.clear();
+    return true;
+}
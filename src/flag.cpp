@@ -0,0 +1,55 @@
+#include "flag.h"
+
+#include <cmath>
+
+Flag make_gabon_flag(float width, float height_top, float height_middle1, float height_middle2, float height_bottom)
+{
+    // الألوان التقريبية:
+    // الأخضر: 0.0, 0.6, 0.3
+    // الأصفر: 1.0, 0.8, 0.0
+    // الأزرق: 0.0, 0.3, 0.7
+    Flag flag;
+    flag.width = width;
+    flag.stripes = {
+        {height_top, height_middle1, 0.0f, 0.6f, 0.3f},
+        {height_middle1, height_middle2, 1.0f, 0.8f, 0.0f},
+        {height_middle2, height_bottom, 0.0f, 0.3f, 0.7f},
+    };
+    return flag;
+}
+
+std::vector<FlagPlacement> make_flag_grid(const Flag &flag, size_t count)
+{
+    std::vector<FlagPlacement> placements;
+    if (count == 0)
+        return placements;
+
+    // نص عرض و نص ارتفاع العلم قبل ال scale
+    float half_width = flag.width;
+    float half_height = 0.0f;
+    for (const FlagStripe &stripe : flag.stripes)
+        half_height = std::fmax(half_height, std::fmax(std::fabs(stripe.top), std::fabs(stripe.bottom)));
+    if (half_width <= 0.0f || half_height <= 0.0f)
+        return placements;
+
+    size_t columns = (size_t)std::ceil(std::sqrt((double)count));
+    size_t rows = (count + columns - 1) / columns;
+
+    float cell_width = 2.0f / columns;
+    float cell_height = 2.0f / rows;
+
+    // بنسيب 10% مسافة بين الاعلام
+    float scale = 0.9f * std::fmin(cell_width / (2.0f * half_width), cell_height / (2.0f * half_height));
+
+    placements.reserve(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t column = i % columns;
+        size_t row = i / columns;
+        float x = -1.0f + cell_width * (column + 0.5f);
+        float y = 1.0f - cell_height * (row + 0.5f);
+        placements.push_back({x, y, scale});
+    }
+
+    return placements;
+}
@@ -0,0 +1,436 @@
+#include "flag_format.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+static bool parse_float(const string &token, float &value)
+{
+    char *end = nullptr;
+    value = strtof(token.c_str(), &end);
+    return !token.empty() && end && *end == '\0';
+}
+
+static int hex_digit(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+static bool is_hex_color(const string &token)
+{
+    if (token.size() != 7 || token[0] != '#')
+        return false;
+    for (size_t i = 1; i < token.size(); i++)
+    {
+        if (hex_digit(token[i]) < 0)
+            return false;
+    }
+    return true;
+}
+
+// #RRGGBB (token واحد) او R G B (3 tokens)، و pos بيتحرك بعد اللون
+static bool parse_color(const vector<string> &tokens, size_t &pos, float &r, float &g, float &b)
+{
+    if (pos >= tokens.size())
+        return false;
+
+    const string &token = tokens[pos];
+    if (token[0] == '#')
+    {
+        if (!is_hex_color(token))
+            return false;
+
+        float channels[3];
+        for (int i = 0; i < 3; i++)
+            channels[i] = (hex_digit(token[1 + i * 2]) * 16 + hex_digit(token[2 + i * 2])) / 255.0f;
+        r = channels[0];
+        g = channels[1];
+        b = channels[2];
+        pos++;
+        return true;
+    }
+
+    if (pos + 3 > tokens.size() || !parse_float(tokens[pos], r) || !parse_float(tokens[pos + 1], g) ||
+        !parse_float(tokens[pos + 2], b))
+        return false;
+    pos += 3;
+    return true;
+}
+
+// بيقرا count رقم من tokens[pos]
+static bool parse_floats(const vector<string> &tokens, size_t &pos, float *values, size_t count)
+{
+    if (pos + count > tokens.size())
+        return false;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!parse_float(tokens[pos + i], values[i]))
+            return false;
+    }
+    pos += count;
+    return true;
+}
+
+static float cross(float ax, float ay, float bx, float by, float cx, float cy)
+{
+    return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
+
+// ear clipping: بنقص مثلث من طرف الشكل (ear) كل مرة لحد ما يفضل مثلث واحد
+// بيشتغل مع اي شكل مقفول مش بيقطع نفسه (مش لازم convex، زي النجمة)
+static bool triangulate_polygon(const vector<float> &points, vector<uint32_t> &triangles)
+{
+    size_t count = points.size() / 2;
+    if (count < 3)
+        return false;
+
+    // بنخلي الترتيب عكس عقارب الساعة عشان ال ear يبقي cross > 0
+    float area = 0.0f;
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t j = (i + 1) % count;
+        area += points[i * 2] * points[j * 2 + 1] - points[j * 2] * points[i * 2 + 1];
+    }
+    if (fabs(area) < 1e-12f)
+        return false;
+
+    vector<uint32_t> remaining(count);
+    for (size_t i = 0; i < count; i++)
+        remaining[i] = (uint32_t)(area > 0.0f ? i : count - 1 - i);
+
+    while (remaining.size() > 3)
+    {
+        bool clipped = false;
+        for (size_t i = 0; i < remaining.size() && !clipped; i++)
+        {
+            uint32_t a = remaining[(i + remaining.size() - 1) % remaining.size()];
+            uint32_t b = remaining[i];
+            uint32_t c = remaining[(i + 1) % remaining.size()];
+            float ax = points[a * 2], ay = points[a * 2 + 1];
+            float bx = points[b * 2], by = points[b * 2 + 1];
+            float cx = points[c * 2], cy = points[c * 2 + 1];
+
+            // الزاوية عند b لازم تبقي لجوه
+            if (cross(ax, ay, bx, by, cx, cy) <= 0.0f)
+                continue;
+
+            // و مفيش نقطة تانية جوه المثلث
+            bool empty = true;
+            for (uint32_t other : remaining)
+            {
+                if (other == a || other == b || other == c)
+                    continue;
+                float px = points[other * 2], py = points[other * 2 + 1];
+                if (cross(ax, ay, bx, by, px, py) >= 0.0f && cross(bx, by, cx, cy, px, py) >= 0.0f &&
+                    cross(cx, cy, ax, ay, px, py) >= 0.0f)
+                {
+                    empty = false;
+                    break;
+                }
+            }
+            if (!empty)
+                continue;
+
+            triangles.push_back(a);
+            triangles.push_back(b);
+            triangles.push_back(c);
+            remaining.erase(remaining.begin() + i);
+            clipped = true;
+        }
+
+        // مفيش ear: الشكل بيقطع نفسه
+        if (!clipped)
+            return false;
+    }
+
+    triangles.insert(triangles.end(), remaining.begin(), remaining.end());
+    return true;
+}
+
+bool parse_flag_file(const string &path, vector<FlagDescription> &out)
+{
+    ifstream file(path);
+    if (!file)
+    {
+        cerr << "Can't open " << path << "\n";
+        return false;
+    }
+
+    size_t first_flag = out.size();
+    FlagDescription *flag = nullptr;
+    string line;
+    size_t line_number = 0;
+    while (getline(file, line))
+    {
+        line_number++;
+
+        // التعليق من اول # لآخر السطر، الا لو #RRGGBB (لون)
+        vector<string> tokens;
+        istringstream stream(line);
+        string token;
+        while (stream >> token)
+        {
+            if (token[0] == '#' && !is_hex_color(token))
+                break;
+            tokens.push_back(token);
+        }
+        if (tokens.empty())
+            continue;
+
+        const string &command = tokens[0];
+        auto fail = [&](const string &message)
+        {
+            cerr << path << ":" << line_number << ": " << message << "\n";
+            out.resize(first_flag);
+            return false;
+        };
+
+        if (command == "flag")
+        {
+            if (tokens.size() != 2)
+                return fail("expected: flag NAME");
+            if (tokens[1].size() >= FLAG_NAME_LENGTH)
+                return fail("flag name is longer than " + to_string(FLAG_NAME_LENGTH - 1) + " characters");
+
+            out.emplace_back();
+            flag = &out.back();
+            flag->name = tokens[1];
+            continue;
+        }
+
+        if (!flag)
+            return fail("'" + command + "' before any 'flag NAME'");
+
+        size_t pos = 1;
+        float r = 0.0f, g = 0.0f, b = 0.0f;
+        float values[4];
+        float w = flag->half_width;
+        float h = flag->half_height;
+
+        if (command == "size")
+        {
+            if (!parse_floats(tokens, pos, values, 2) || pos != tokens.size() || values[0] <= 0.0f || values[1] <= 0.0f)
+                return fail("expected: size HALF_WIDTH HALF_HEIGHT");
+            flag->half_width = values[0];
+            flag->half_height = values[1];
+            continue;
+        }
+
+        if (w <= 0.0f || h <= 0.0f)
+            return fail("'size' has to come before the shapes");
+
+        if (command == "stripe")
+        {
+            if (!parse_floats(tokens, pos, values, 2) || !parse_color(tokens, pos, r, g, b) || pos != tokens.size())
+                return fail("expected: stripe TOP BOTTOM COLOR");
+            flag->mesh.addQuad(-w, values[1], w, values[0], r, g, b);
+        }
+        else if (command == "band")
+        {
+            if (!parse_floats(tokens, pos, values, 2) || !parse_color(tokens, pos, r, g, b) || pos != tokens.size())
+                return fail("expected: band LEFT RIGHT COLOR");
+            flag->mesh.addQuad(values[0], -h, values[1], h, r, g, b);
+        }
+        else if (command == "rect")
+        {
+            if (!parse_floats(tokens, pos, values, 4) || !parse_color(tokens, pos, r, g, b) || pos != tokens.size())
+                return fail("expected: rect X0 Y0 X1 Y1 COLOR");
+            flag->mesh.addQuad(values[0], values[1], values[2], values[3], r, g, b);
+        }
+        else if (command == "cross")
+        {
+            if (!parse_floats(tokens, pos, values, 3) || !parse_color(tokens, pos, r, g, b) || pos != tokens.size())
+                return fail("expected: cross X Y THICKNESS COLOR");
+            float half = values[2] * 0.5f;
+            flag->mesh.addQuad(-w, values[1] - half, w, values[1] + half, r, g, b);
+            flag->mesh.addQuad(values[0] - half, -h, values[0] + half, h, r, g, b);
+        }
+        else if (command == "polygon")
+        {
+            if (!parse_color(tokens, pos, r, g, b))
+                return fail("expected: polygon COLOR X Y X Y ...");
+
+            vector<float> points;
+            size_t coordinates = tokens.size() - pos;
+            if (coordinates < 6 || coordinates % 2 != 0)
+                return fail("a polygon needs at least 3 X Y points");
+            points.resize(coordinates);
+            if (!parse_floats(tokens, pos, points.data(), coordinates))
+                return fail("expected: polygon COLOR X Y X Y ...");
+
+            vector<uint32_t> triangles;
+            if (!triangulate_polygon(points, triangles))
+                return fail("polygon is degenerate or intersects itself");
+
+            for (size_t i = 0; i + 2 < triangles.size(); i += 3)
+            {
+                Vertex corners[3];
+                for (int k = 0; k < 3; k++)
+                {
+                    uint32_t index = triangles[i + k];
+                    corners[k] = {points[index * 2], points[index * 2 + 1], r, g, b, 1.0f};
+                }
+                flag->mesh.addTriangle(corners[0], corners[1], corners[2]);
+            }
+        }
+        else
+        {
+            return fail("unknown command '" + command + "'");
+        }
+    }
+
+    for (size_t i = first_flag; i < out.size(); i++)
+    {
+        if (out[i].mesh.indices().empty())
+        {
+            cerr << path << ": flag '" << out[i].name << "' has no shapes\n";
+            out.resize(first_flag);
+            return false;
+        }
+    }
+    return true;
+}
+
+vector<string> list_flag_files(const string &directory)
+{
+    vector<string> paths;
+    error_code ec;
+    for (filesystem::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec))
+    {
+        if (it->path().extension() == ".flag")
+            paths.push_back(it->path().string());
+    }
+    sort(paths.begin(), paths.end());
+    return paths;
+}
+
+uint64_t flag_sources_key(const vector<string> &paths)
+{
+    // FNV-1a زي مفتاح ال shader cache
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](const void *data, size_t length)
+    {
+        const unsigned char *bytes = (const unsigned char *)data;
+        for (size_t i = 0; i < length; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    for (const string &path : paths)
+    {
+        error_code ec;
+        uint64_t size = (uint64_t)filesystem::file_size(path, ec);
+        int64_t modified = (int64_t)filesystem::last_write_time(path, ec).time_since_epoch().count();
+
+        mix(path.c_str(), path.size() + 1);
+        mix(&size, sizeof(size));
+        mix(&modified, sizeof(modified));
+    }
+    return hash;
+}
+
+static void pad_to_4(vector<unsigned char> &bytes)
+{
+    while (bytes.size() % 4 != 0)
+        bytes.push_back(0);
+}
+
+bool write_flag_blob(const string &path, const vector<FlagDescription> &flags, VertexFormat format, uint64_t source_key)
+{
+    const VertexLayout &layout = VertexLayout::get(format);
+
+    vector<FlagBlobEntry> entries(flags.size());
+    vector<unsigned char> vertices;
+    vector<uint16_t> indices;
+    for (size_t i = 0; i < flags.size(); i++)
+    {
+        const FlagDescription &flag = flags[i];
+        const vector<Vertex> &flag_vertices = flag.mesh.vertices();
+        const vector<uint32_t> &flag_indices = flag.mesh.indices();
+        if (flag_vertices.size() > 0xFFFF)
+        {
+            cerr << "Flag '" << flag.name << "' has more than 65535 vertices\n";
+            return false;
+        }
+
+        FlagBlobEntry &entry = entries[i];
+        memset(&entry, 0, sizeof(entry));
+        strncpy(entry.name, flag.name.c_str(), FLAG_NAME_LENGTH - 1);
+        entry.half_width = flag.half_width;
+        entry.half_height = flag.half_height;
+        entry.first_index = (uint32_t)indices.size();
+        entry.index_count = (uint32_t)flag_indices.size();
+        entry.base_vertex = (uint32_t)(vertices.size() / layout.stride);
+        entry.vertex_count = (uint32_t)flag_vertices.size();
+
+        size_t offset = vertices.size();
+        vertices.resize(offset + flag_vertices.size() * layout.stride);
+        pack_vertices(format, flag_vertices.data(), flag_vertices.size(), vertices.data() + offset);
+        indices.insert(indices.end(), flag_indices.begin(), flag_indices.end());
+    }
+    uint32_t vertex_count = (uint32_t)(vertices.size() / layout.stride);
+    pad_to_4(vertices);
+
+    FlagBlobHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, FLAG_BLOB_MAGIC, 4);
+    header.version = FLAG_BLOB_VERSION;
+    header.vertex_format = (uint32_t)format;
+    header.flag_count = (uint32_t)flags.size();
+    header.vertex_count = vertex_count;
+    header.index_count = (uint32_t)indices.size();
+    header.source_key = source_key;
+    header.vertex_offset = sizeof(FlagBlobHeader) + entries.size() * sizeof(FlagBlobEntry);
+    header.index_offset = header.vertex_offset + vertices.size();
+
+    error_code ec;
+    filesystem::path parent = filesystem::path(path).parent_path();
+    if (!parent.empty())
+        filesystem::create_directories(parent, ec);
+
+    string temp_path = path + ".tmp" + to_string(chrono::steady_clock::now().time_since_epoch().count());
+    {
+        ofstream file(temp_path, ios::binary | ios::trunc);
+        if (!file)
+        {
+            cerr << "Can't write " << temp_path << "\n";
+            return false;
+        }
+        file.write((const char *)&header, sizeof(header));
+        file.write((const char *)entries.data(), entries.size() * sizeof(FlagBlobEntry));
+        file.write((const char *)vertices.data(), vertices.size());
+        file.write((const char *)indices.data(), indices.size() * sizeof(uint16_t));
+        if (!file)
+        {
+            cerr << "Can't write " << temp_path << "\n";
+            file.close();
+            filesystem::remove(temp_path, ec);
+            return false;
+        }
+    }
+
+    filesystem::rename(temp_path, path, ec);
+    if (ec)
+    {
+        cerr << "Can't write " << path << ": " << ec.message() << "\n";
+        filesystem::remove(temp_path, ec);
+        return false;
+    }
+    return true;
+}
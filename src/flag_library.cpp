@@ -0,0 +1,148 @@
+#include "flag_library.h"
+
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+FlagLibrary::FlagLibrary()
+    : header(nullptr), entries(nullptr), was_compiled(false)
+{
+}
+
+bool FlagLibrary::open(const string &blob_path)
+{
+    close();
+    if (!file.open(blob_path))
+        return false;
+
+    if (!validate(blob_path))
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+// الملف جاي من الديسك فممكن يبقي ناقص او بايظ، فبنتأكد ان كل حاجة جوه حدوده
+// قبل ما نستخدم اي pointer
+bool FlagLibrary::validate(const string &path)
+{
+    const unsigned char *data = file.data();
+    size_t size = file.size();
+
+    if (size < sizeof(FlagBlobHeader))
+    {
+        cerr << path << ": not a flag blob\n";
+        return false;
+    }
+
+    const FlagBlobHeader *blob = (const FlagBlobHeader *)data;
+    if (memcmp(blob->magic, FLAG_BLOB_MAGIC, 4) != 0 || blob->version != FLAG_BLOB_VERSION ||
+        blob->vertex_format >= VERTEX_FORMAT_COUNT)
+    {
+        cerr << path << ": not a flag blob or an older version\n";
+        return false;
+    }
+
+    size_t stride = VertexLayout::get((VertexFormat)blob->vertex_format).stride;
+    uint64_t entries_end = sizeof(FlagBlobHeader) + (uint64_t)blob->flag_count * sizeof(FlagBlobEntry);
+    uint64_t vertex_bytes = (uint64_t)blob->vertex_count * stride;
+    uint64_t index_bytes = (uint64_t)blob->index_count * sizeof(uint16_t);
+
+    // offset <= حد و length <= حد - offset زي AssetPack::validate، عشان ملف بايظ ميعملش wrap في الجمع
+    // الترتيب: header، entries، vertices، indices
+    bool ok = entries_end <= blob->vertex_offset && blob->vertex_offset <= blob->index_offset &&
+              vertex_bytes <= blob->index_offset - blob->vertex_offset && blob->index_offset <= size &&
+              index_bytes <= size - blob->index_offset && blob->vertex_offset % 4 == 0 && blob->index_offset % 2 == 0;
+    if (!ok)
+    {
+        cerr << path << ": truncated flag blob\n";
+        return false;
+    }
+
+    const FlagBlobEntry *blob_entries = (const FlagBlobEntry *)(data + sizeof(FlagBlobHeader));
+    for (uint32_t i = 0; i < blob->flag_count; i++)
+    {
+        const FlagBlobEntry &flag = blob_entries[i];
+        if (memchr(flag.name, '\0', FLAG_NAME_LENGTH) == nullptr ||
+            (uint64_t)flag.first_index + flag.index_count > blob->index_count ||
+            (uint64_t)flag.base_vertex + flag.vertex_count > blob->vertex_count)
+        {
+            cerr << path << ": bad entry " << i << " in flag blob\n";
+            return false;
+        }
+    }
+
+    header = blob;
+    entries = blob_entries;
+    return true;
+}
+
+bool FlagLibrary::load(const string &source_dir, const string &cache_path, VertexFormat format)
+{
+    close();
+    was_compiled = false;
+
+    vector<string> sources = list_flag_files(source_dir);
+    if (sources.empty())
+    {
+        cerr << "No .flag files in " << source_dir << "\n";
+        return false;
+    }
+    uint64_t key = flag_sources_key(sources);
+
+    // لو ال blob موجود و من نفس الملفات و بنفس ال format نستخدمه زي ما هو
+    error_code ec;
+    if (filesystem::exists(cache_path, ec) && file.open(cache_path) && validate(cache_path) && header->source_key == key &&
+        header->vertex_format == (uint32_t)format)
+        return true;
+    close();
+
+    vector<FlagDescription> flags;
+    for (const string &source : sources)
+    {
+        if (!parse_flag_file(source, flags))
+            return false;
+    }
+    if (!write_flag_blob(cache_path, flags, format, key))
+        return false;
+
+    was_compiled = true;
+    return open(cache_path);
+}
+
+void FlagLibrary::close()
+{
+    file.close();
+    header = nullptr;
+    entries = nullptr;
+}
+
+int FlagLibrary::find(const string &name) const
+{
+    for (size_t i = 0; i < count(); i++)
+    {
+        if (name == entries[i].name)
+            return (int)i;
+    }
+    return -1;
+}
+
+bool FlagLibrary::upload(Mesh &mesh) const
+{
+    if (!header)
+        return false;
+
+    const unsigned char *data = file.data();
+    return mesh.uploadPacked(format(), data + header->vertex_offset, header->vertex_count,
+                             data + header->index_offset, header->index_count, GL_UNSIGNED_SHORT);
+}
+
+void FlagLibrary::record(const Mesh &mesh, DrawList &list, const DrawPass &pass, size_t index) const
+{
+    const FlagBlobEntry &flag = entries[index];
+    mesh.recordRange(list, pass, (GLsizei)flag.index_count, flag.first_index, (GLint)flag.base_vertex);
+}
@@ -0,0 +1,337 @@
+#include "frame_profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+RollingPercentiles::RollingPercentiles(size_t window)
+    : capacity(window > 0 ? window : 1), next(0)
+{
+    samples.reserve(capacity);
+}
+
+void RollingPercentiles::add(double value)
+{
+    if (samples.size() < capacity)
+    {
+        samples.push_back(value);
+        return;
+    }
+
+    samples[next] = value;
+    next = (next + 1) % capacity;
+}
+
+double RollingPercentiles::percentile(double p) const
+{
+    if (samples.empty())
+        return 0.0;
+
+    // nearest rank علي نسخة مترتبة جزئيا، بيتنادي بس وقت الطباعة
+    vector<double> sorted(samples);
+    size_t rank = (size_t)ceil(p / 100.0 * sorted.size());
+    rank = std::min(std::max(rank, (size_t)1), sorted.size()) - 1;
+    nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return sorted[rank];
+}
+
+double RollingPercentiles::mean() const
+{
+    if (samples.empty())
+        return 0.0;
+
+    double sum = 0.0;
+    for (double sample : samples)
+        sum += sample;
+    return sum / samples.size();
+}
+
+double RollingPercentiles::min() const
+{
+    return samples.empty() ? 0.0 : *min_element(samples.begin(), samples.end());
+}
+
+double RollingPercentiles::max() const
+{
+    return samples.empty() ? 0.0 : *max_element(samples.begin(), samples.end());
+}
+
+FrameProfiler::FrameProfiler(size_t window)
+    : window_size(window), query_depth(2), keep_history(false), frame_open(false), active_pass(-1), gpu_stalls(0),
+      frame_count(0), swap_ms(0.0), frame_stats(window), cpu_stats(window), swap_stats(window)
+{
+}
+
+FrameProfiler::~FrameProfiler()
+{
+    destroy();
+}
+
+void FrameProfiler::init(size_t query_frames, bool keep_history)
+{
+    destroy();
+    query_depth = query_frames > 0 ? query_frames : 1;
+    this->keep_history = keep_history;
+}
+
+void FrameProfiler::destroy()
+{
+    passes.clear();
+    history.clear();
+    frame_open = false;
+    active_pass = -1;
+    gpu_stalls = 0;
+    frame_count = 0;
+    frame_stats = RollingPercentiles(window_size);
+    cpu_stats = RollingPercentiles(window_size);
+    swap_stats = RollingPercentiles(window_size);
+}
+
+size_t FrameProfiler::pass(const string &name)
+{
+    for (size_t i = 0; i < passes.size(); i++)
+    {
+        if (passes[i].name == name)
+            return i;
+    }
+
+    GpuPass gpu_pass;
+    gpu_pass.name = name;
+    gpu_pass.query_frame.resize(query_depth, 0);
+    gpu_pass.query_pending.resize(query_depth, false);
+    gpu_pass.stats = RollingPercentiles(window_size);
+    for (size_t i = 0; i < query_depth; i++)
+        gpu_pass.queries.push_back(GLQuery::create());
+
+    passes.push_back(move(gpu_pass));
+    return passes.size() - 1;
+}
+
+void FrameProfiler::beginFrame()
+{
+    frame_start = clock::now();
+    swap_ms = 0.0;
+    frame_open = true;
+
+    frame_count++;
+    if (keep_history)
+    {
+        history.emplace_back();
+        history.back().gpu_ms.assign(passes.size(), -1.0);
+    }
+
+    // ال query اللي هنستخدمه في ال frame ده اتعمل من query_depth frames
+    // غالبا خلص، و لو لسه بنستناه (و ده معناه ان ال GPU متأخر فعلا)
+    size_t slot = (frame_count - 1) % query_depth;
+    for (size_t i = 0; i < passes.size(); i++)
+        collect(passes[i], i, slot, true);
+}
+
+void FrameProfiler::endFrame()
+{
+    if (!frame_open)
+        return;
+    frame_open = false;
+
+    double frame_ms = chrono::duration<double, milli>(clock::now() - frame_start).count();
+
+    frame_stats.add(frame_ms);
+    cpu_stats.add(frame_ms - swap_ms);
+    swap_stats.add(swap_ms);
+
+    if (keep_history)
+    {
+        FrameRecord &record = history.back();
+        record.frame_ms = frame_ms;
+        record.swap_ms = swap_ms;
+        record.cpu_ms = frame_ms - swap_ms;
+    }
+}
+
+void FrameProfiler::beginSwap()
+{
+    swap_start = clock::now();
+}
+
+void FrameProfiler::endSwap()
+{
+    swap_ms += chrono::duration<double, milli>(clock::now() - swap_start).count();
+}
+
+void FrameProfiler::beginGpu(size_t pass_index)
+{
+    if (pass_index >= passes.size() || active_pass >= 0 || frame_count == 0)
+        return;
+
+    GpuPass &gpu_pass = passes[pass_index];
+    size_t slot = (frame_count - 1) % query_depth;
+
+    // pass اتضاف بعد beginFrame بتاع ال frame ده
+    collect(gpu_pass, pass_index, slot, true);
+
+    glBeginQuery(GL_TIME_ELAPSED, gpu_pass.queries[slot].get());
+    gpu_pass.query_frame[slot] = frame_count - 1;
+    gpu_pass.query_pending[slot] = true;
+    active_pass = (int)pass_index;
+}
+
+void FrameProfiler::endGpu()
+{
+    if (active_pass < 0)
+        return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    active_pass = -1;
+}
+
+void FrameProfiler::collect(GpuPass &gpu_pass, size_t pass_index, size_t slot, bool wait)
+{
+    if (!gpu_pass.query_pending[slot])
+        return;
+
+    GLuint query = gpu_pass.queries[slot].get();
+    GLint available = 0;
+    glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+    {
+        if (!wait)
+            return;
+        gpu_stalls++;
+    }
+
+    // GL_QUERY_RESULT بيستني لو النتيجة لسه مجتش
+    GLuint64 elapsed_ns = 0;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed_ns);
+    gpu_pass.query_pending[slot] = false;
+
+    double elapsed_ms = elapsed_ns / 1e6;
+    gpu_pass.stats.add(elapsed_ms);
+    if (!keep_history)
+        return;
+
+    FrameRecord &record = history[gpu_pass.query_frame[slot]];
+    if (record.gpu_ms.size() <= pass_index)
+        record.gpu_ms.resize(pass_index + 1, -1.0);
+    record.gpu_ms[pass_index] = elapsed_ms;
+}
+
+void FrameProfiler::finish()
+{
+    endGpu();
+    for (size_t i = 0; i < passes.size(); i++)
+    {
+        for (size_t slot = 0; slot < query_depth; slot++)
+            collect(passes[i], i, slot, true);
+    }
+}
+
+static void print_stats(ostream &out, const string &name, const RollingPercentiles &stats)
+{
+    out << "  " << left << setw(14) << name << right << fixed << setprecision(3)
+        << " p50 " << setw(8) << stats.percentile(50.0)
+        << "  p99 " << setw(8) << stats.percentile(99.0)
+        << "  mean " << setw(8) << stats.mean()
+        << "  max " << setw(8) << stats.max() << " ms\n";
+    out.unsetf(ios::floatfield);
+}
+
+void FrameProfiler::printSummary(ostream &out) const
+{
+    out << "Frame timing (" << frame_count << " frames, last " << frame_stats.count() << " in window):\n";
+    print_stats(out, "frame", frame_stats);
+    print_stats(out, "cpu", cpu_stats);
+    print_stats(out, "swap", swap_stats);
+    for (const GpuPass &gpu_pass : passes)
+        print_stats(out, "gpu " + gpu_pass.name, gpu_pass.stats);
+    if (gpu_stalls > 0)
+        out << "  gpu query stalls: " << gpu_stalls << "\n";
+}
+
+bool FrameProfiler::writeCSV(const string &path) const
+{
+    if (!keep_history)
+    {
+        cerr << "Can't write " << path << ": per-frame history wasn't recorded\n";
+        return false;
+    }
+
+    ofstream file(path);
+    if (!file)
+    {
+        cerr << "Can't write " << path << "\n";
+        return false;
+    }
+
+    file << "frame,frame_ms,cpu_ms,swap_ms";
+    for (const GpuPass &gpu_pass : passes)
+        file << ",gpu_" << gpu_pass.name << "_ms";
+    file << "\n";
+
+    // الخلايا الفاضية معناها ان ال GPU time مرجعش لل frame ده
+    file << setprecision(6);
+    for (size_t i = 0; i < history.size(); i++)
+    {
+        const FrameRecord &record = history[i];
+        file << i << "," << record.frame_ms << "," << record.cpu_ms << "," << record.swap_ms;
+        for (size_t p = 0; p < passes.size(); p++)
+        {
+            file << ",";
+            if (p < record.gpu_ms.size() && record.gpu_ms[p] >= 0.0)
+                file << record.gpu_ms[p];
+        }
+        file << "\n";
+    }
+
+    return (bool)file;
+}
+
+static void json_stats(ostream &out, const string &name, const RollingPercentiles &stats, bool last)
+{
+    out << "    \"" << name << "\": {\"samples\": " << stats.count()
+        << ", \"p50\": " << stats.percentile(50.0)
+        << ", \"p99\": " << stats.percentile(99.0)
+        << ", \"mean\": " << stats.mean()
+        << ", \"min\": " << stats.min()
+        << ", \"max\": " << stats.max() << "}" << (last ? "\n" : ",\n");
+}
+
+bool FrameProfiler::writeJSON(const string &path) const
+{
+    ofstream file(path);
+    if (!file)
+    {
+        cerr << "Can't write " << path << "\n";
+        return false;
+    }
+
+    file << setprecision(6);
+    file << "{\n";
+    file << "  \"frames\": " << frame_count << ",\n";
+    file << "  \"window\": " << window_size << ",\n";
+    file << "  \"gpu_query_stalls\": " << gpu_stalls << ",\n";
+    file << "  \"unit\": \"ms\",\n";
+    file << "  \"metrics\": {\n";
+    json_stats(file, "frame", frame_stats, false);
+    json_stats(file, "cpu", cpu_stats, false);
+    json_stats(file, "swap", swap_stats, passes.empty());
+    for (size_t i = 0; i < passes.size(); i++)
+        json_stats(file, "gpu_" + passes[i].name, passes[i].stats, i + 1 == passes.size());
+    file << "  }\n";
+    file << "}\n";
+
+    return (bool)file;
+}
+
+bool FrameProfiler::needsHistory(const string &path)
+{
+    return !(path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0);
+}
+
+bool FrameProfiler::write(const string &path) const
+{
+    return needsHistory(path) ? writeCSV(path) : writeJSON(path);
+}
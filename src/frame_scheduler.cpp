@@ -0,0 +1,146 @@
+#include "frame_scheduler.h"
+
+#include <thread>
+
+using namespace std;
+
+// الوقت اللي بنعديه بـ yield في الآخر بدل sleep، مش اكتر من كده
+static const double MAX_YIELD_SECONDS = 0.002;
+
+FrameScheduler::FrameScheduler()
+    : fixed_step(1.0 / 60.0), frame_interval(0.0), max_steps(5), deterministic(false),
+      accumulator(0.0), steps_this_frame(0), steps_done(0), dropped_steps(0), sleep_count(0),
+      oversleep_estimate(0.0005)
+{
+    start();
+}
+
+void FrameScheduler::setFixedStep(double seconds)
+{
+    fixed_step = seconds > 0.0 ? seconds : 1.0 / 60.0;
+}
+
+void FrameScheduler::setFrameLimit(double fps)
+{
+    frame_interval = fps > 0.0 ? 1.0 / fps : 0.0;
+}
+
+void FrameScheduler::setMaxStepsPerFrame(int steps)
+{
+    max_steps = steps > 0 ? steps : 1;
+}
+
+void FrameScheduler::setDeterministic(bool enabled)
+{
+    deterministic = enabled;
+}
+
+void FrameScheduler::start()
+{
+    last_frame = Clock::now();
+    next_deadline = last_frame;
+    accumulator = 0.0;
+    steps_this_frame = 0;
+    steps_done = 0;
+    dropped_steps = 0;
+    sleep_count = 0;
+}
+
+void FrameScheduler::beginFrame()
+{
+    Clock::time_point now = Clock::now();
+    double elapsed = chrono::duration<double>(now - last_frame).count();
+    last_frame = now;
+    steps_this_frame = 0;
+
+    if (deterministic)
+    {
+        accumulator = fixed_step;
+        return;
+    }
+
+    accumulator += elapsed;
+
+    // frame متأخر جامد (breakpoint، تحميل، ...): منحاولش نلحق كل الخطوات
+    double max_accumulated = max_steps * fixed_step;
+    if (accumulator > max_accumulated)
+    {
+        dropped_steps += (size_t)((accumulator - max_accumulated) / fixed_step);
+        accumulator = max_accumulated;
+    }
+}
+
+bool FrameScheduler::update()
+{
+    if (accumulator < fixed_step || steps_this_frame >= max_steps)
+        return false;
+
+    accumulator -= fixed_step;
+    steps_this_frame++;
+    steps_done++;
+    return true;
+}
+
+double FrameScheduler::alpha() const
+{
+    double value = accumulator / fixed_step;
+    return value < 0.0 ? 0.0 : (value > 1.0 ? 1.0 : value);
+}
+
+void FrameScheduler::endFrame()
+{
+    if (frame_interval <= 0.0)
+        return;
+
+    Clock::duration interval = chrono::duration_cast<Clock::duration>(chrono::duration<double>(frame_interval));
+    next_deadline += interval;
+
+    // لو متأخرين اكتر من frame كامل منحاولش نعوض (كان هيطلع frames ورا بعض من غير نوم)
+    Clock::time_point now = Clock::now();
+    if (next_deadline + interval < now)
+    {
+        next_deadline = now;
+        return;
+    }
+
+    sleepUntil(next_deadline);
+}
+
+void FrameScheduler::sleepUntil(Clock::time_point deadline)
+{
+    while (true)
+    {
+        Clock::time_point now = Clock::now();
+        double remaining = chrono::duration<double>(deadline - now).count();
+        if (remaining <= 0.0)
+            return;
+
+        // قربنا: الحتة الصغيرة دي بال yield عشان sleep مش هيصحي في معاده
+        double margin = oversleep_estimate < MAX_YIELD_SECONDS ? oversleep_estimate : MAX_YIELD_SECONDS;
+        if (remaining <= margin)
+            break;
+
+        Clock::time_point target = deadline - chrono::duration_cast<Clock::duration>(chrono::duration<double>(margin));
+        this_thread::sleep_until(target);
+        sleep_count++;
+
+        // متوسط متحرك للتأخير بعد ال sleep
+        double late = chrono::duration<double>(Clock::now() - target).count();
+        if (late < 0.0)
+            late = 0.0;
+        oversleep_estimate = oversleep_estimate * 0.875 + late * 0.125;
+    }
+
+    while (Clock::now() < deadline)
+        this_thread::yield();
+}
+
+void FrameScheduler::printStats(ostream &out) const
+{
+    out << "Frame scheduler: " << steps_done << " updates of " << fixed_step * 1000.0 << " ms, "
+        << dropped_steps << " dropped";
+    if (frame_interval > 0.0)
+        out << ", limit " << 1.0 / frame_interval << " fps, " << sleep_count << " sleeps, oversleep "
+            << oversleepMs() << " ms";
+    out << "\n";
+}
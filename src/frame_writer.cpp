@@ -0,0 +1,105 @@
+#include "frame_writer.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <utility>
+
+#include "image_writer.h"
+
+using namespace std;
+
+FrameWriter::FrameWriter()
+    : queue_limit(8), stopping(false), written_count(0), failed_count(0)
+{
+}
+
+FrameWriter::~FrameWriter()
+{
+    stop();
+}
+
+bool FrameWriter::start(const string &directory, size_t max_queued)
+{
+    stop();
+
+    output_directory = directory;
+    queue_limit = max_queued > 0 ? max_queued : 1;
+    stopping = false;
+    written_count = 0;
+    failed_count = 0;
+
+    worker = thread(&FrameWriter::run, this);
+    return true;
+}
+
+void FrameWriter::stop()
+{
+    if (!worker.joinable())
+        return;
+
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        stopping = true;
+    }
+    queue_changed.notify_all();
+    worker.join();
+}
+
+void FrameWriter::push(ReadbackFrame &frame)
+{
+    unique_lock<mutex> lock(queue_mutex);
+    queue_changed.wait(lock, [this] { return queue.size() < queue_limit; });
+
+    queue.push_back(move(frame));
+
+    frame = ReadbackFrame();
+    if (!free_buffers.empty())
+    {
+        frame.pixels = move(free_buffers.back());
+        free_buffers.pop_back();
+    }
+
+    lock.unlock();
+    queue_changed.notify_all();
+}
+
+size_t FrameWriter::written() const
+{
+    lock_guard<mutex> lock(queue_mutex);
+    return written_count;
+}
+
+size_t FrameWriter::failed() const
+{
+    lock_guard<mutex> lock(queue_mutex);
+    return failed_count;
+}
+
+void FrameWriter::run()
+{
+    unique_lock<mutex> lock(queue_mutex);
+    for (;;)
+    {
+        queue_changed.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (queue.empty())
+            return;
+
+        ReadbackFrame frame = move(queue.front());
+        queue.pop_front();
+        lock.unlock();
+        queue_changed.notify_all();
+
+        // الكتابة نفسها برا ال lock عشان push متستناش الديسك
+        char name[32];
+        snprintf(name, sizeof(name), "frame_%04zu.ppm", frame.index);
+        string path = (filesystem::path(output_directory) / name).string();
+        bool ok = frame.valid && write_ppm(path, frame.width, frame.height, frame.pixels.data());
+
+        lock.lock();
+        if (ok)
+            written_count++;
+        else
+            failed_count++;
+        free_buffers.push_back(move(frame.pixels));
+    }
+}
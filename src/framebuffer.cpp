@@ -0,0 +1,75 @@
+#include "framebuffer.h"
+
+#include "gl_state_cache.h"
+
+#include <iostream>
+
+using namespace std;
+
+Framebuffer::Framebuffer()
+    : fb_width(0), fb_height(0)
+{
+}
+
+Framebuffer::~Framebuffer()
+{
+    destroy();
+}
+
+bool Framebuffer::create(int width, int height)
+{
+    destroy();
+
+    FBO = GLFramebuffer::create();
+    color_buffer = GLRenderbuffer::create();
+
+    glBindRenderbuffer(GL_RENDERBUFFER, color_buffer.get());
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    GLStateCache::shared().bindFramebuffer(GL_FRAMEBUFFER, FBO.get());
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color_buffer.get());
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    GLStateCache::shared().bindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        cerr << "Framebuffer is not complete: 0x" << hex << status << dec << "\n";
+        destroy();
+        return false;
+    }
+
+    fb_width = width;
+    fb_height = height;
+    return true;
+}
+
+void Framebuffer::destroy()
+{
+    FBO.reset();
+    color_buffer.reset();
+    fb_width = 0;
+    fb_height = 0;
+}
+
+void Framebuffer::bind() const
+{
+    GLStateCache::shared().bindFramebuffer(GL_FRAMEBUFFER, FBO.get());
+    GLStateCache::shared().viewport(0, 0, fb_width, fb_height);
+}
+
+void Framebuffer::bindDefault()
+{
+    GLStateCache::shared().bindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Framebuffer::readPixels(vector<uint8_t> &rgba) const
+{
+    rgba.resize((size_t)fb_width * fb_height * 4);
+
+    GLStateCache::shared().bindFramebuffer(GL_READ_FRAMEBUFFER, FBO.get());
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, fb_width, fb_height, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+    GLStateCache::shared().bindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
@@ -0,0 +1,257 @@
+#include "gl_context.h"
+
+#include <iostream>
+#include <cstring>
+
+#include "gl_state_cache.h"
+#include "gpu_pool.h"
+#include "startup_trace.h"
+
+#ifdef HAVE_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+using namespace std;
+
+GLContext::GLContext()
+    : is_headless(false), close_requested(false), glfw_initialized(false), swap_interval(1), glfw_window(nullptr),
+      egl_display(nullptr), egl_context(nullptr)
+{
+}
+
+GLContext::~GLContext()
+{
+    destroy();
+}
+
+bool GLContext::create(const GLContextOptions &options)
+{
+    destroy();
+    is_headless = options.headless;
+
+    bool created = false;
+    if (options.headless)
+    {
+        // الاول EGL لانه مش محتاج display خالص
+        // و لو مفيش EGL نجرب نافذة مخفية (محتاجة display بس مبتظهرش)
+        created = createEGL(options) || createGLFW(options, false);
+    }
+    else
+    {
+        created = createGLFW(options, true);
+    }
+
+    if (created)
+    {
+        // context جديد: ال state اللي فاكرينه بتاع القديم
+        GLStateCache::shared().invalidate();
+        GPUResourcePool::shared().open();
+        setSwapInterval(options.swap_interval);
+    }
+    return created;
+}
+
+bool GLContext::createEGL(const GLContextOptions &options)
+{
+#ifdef HAVE_EGL
+    (void)options;
+
+    // surfaceless: context من غير اي surface، الرسم كله في FBO
+    EGLDisplay display = EGL_NO_DISPLAY;
+    const char *client_extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (client_extensions && strstr(client_extensions, "EGL_MESA_platform_surfaceless"))
+    {
+        PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display =
+            (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (get_platform_display)
+            display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+    if (display == EGL_NO_DISPLAY)
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    size_t init_phase = StartupTrace::shared().begin("eglInitialize");
+    EGLint major = 0, minor = 0;
+    bool initialized = display != EGL_NO_DISPLAY && eglInitialize(display, &major, &minor);
+    StartupTrace::shared().end(init_phase);
+    if (!initialized)
+        return false;
+
+    const char *display_extensions = eglQueryString(display, EGL_EXTENSIONS);
+    if (!display_extensions || !strstr(display_extensions, "EGL_KHR_surfaceless_context") ||
+        !strstr(display_extensions, "EGL_KHR_no_config_context") || !eglBindAPI(EGL_OPENGL_API))
+    {
+        eglTerminate(display);
+        return false;
+    }
+
+    // نفس اعدادات النافذة: 3.3 core
+    const EGLint context_attributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE,
+    };
+
+    size_t context_phase = StartupTrace::shared().begin("eglCreateContext");
+    EGLContext context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, context_attributes);
+    StartupTrace::shared().end(context_phase);
+    if (context == EGL_NO_CONTEXT)
+    {
+        eglTerminate(display);
+        return false;
+    }
+
+    size_t load_phase = StartupTrace::shared().begin("gladLoadGLLoader");
+    bool loaded = eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context) &&
+                  gladLoadGLLoader((GLADloadproc)eglGetProcAddress);
+    StartupTrace::shared().end(load_phase);
+    if (!loaded)
+    {
+        cerr << "Can't Load functions using glad\n";
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(display, context);
+        eglTerminate(display);
+        return false;
+    }
+
+    egl_display = display;
+    egl_context = context;
+    return true;
+#else
+    (void)options;
+    return false;
+#endif
+}
+
+bool GLContext::createGLFW(const GLContextOptions &options, bool visible)
+{
+    // هنا بنبدأ نحمل المتكبة و نعمل اعداد للبيئة و بنعمل تشك
+    // هل تم تحميلها بشكل صحيح نكمل او لأ
+    size_t init_phase = StartupTrace::shared().begin("glfwInit");
+    bool initialized = glfwInit();
+    StartupTrace::shared().end(init_phase);
+    if (!initialized)
+    {
+        cerr << "Failed to Initialize GLFW \n";
+        return false;
+    }
+    glfw_initialized = true;
+
+
+    // هنا بقي بنبدأ نعمل اعداد لاصدار المكتبة اللي هنستخدمها و للبروفايل اللي هنستخدمه
+    // Default version: 3.3, Default profile: coreProfile
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
+
+
+    // هنا هنبدأ ننشئ الويندو او النافذة اللي هنشتغل عليها
+    size_t window_phase = StartupTrace::shared().begin("glfwCreateWindow");
+    glfw_window = glfwCreateWindow(options.width, options.height, options.title.c_str(), nullptr, nullptr);
+    StartupTrace::shared().end(window_phase);
+
+    // هنعمل تست نشوف هل تم انشاء النافذة بواسطة البرنامج
+    if (!glfw_window)
+    {
+        cerr << "Failed to Create a window\n";
+        destroy();
+        return false;
+    }
+
+
+    // بعد كده هنعمل اي لو عندنا اكتر من نافذة او ويندو لازم نختار منهم واحدة نشتغل عليها
+    // عن طريق الخطوة دي بنحدد النافذة اللي هنشتغل عليها في الوقت الحالي
+    glfwMakeContextCurrent(glfw_window);
+
+
+    // هنعمل استدعاء لوظائف المكتبةة و تحميلها في الميموري عن طريق ال glad
+    size_t load_phase = StartupTrace::shared().begin("gladLoadGLLoader");
+    bool loaded = gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+    StartupTrace::shared().end(load_phase);
+    if (!loaded)
+    {
+        cerr << "Can't Load functions using glad\n";
+        destroy();
+        return false;
+    }
+
+    return true;
+}
+
+void GLContext::destroy()
+{
+    // ال buffers و ال VAOs اللي مستنية في ال pool لازم تتمسح و ال context لسه موجود
+    if (egl_context || glfw_window)
+        GPUResourcePool::shared().shutdown();
+
+#ifdef HAVE_EGL
+    if (egl_context)
+    {
+        eglMakeCurrent((EGLDisplay)egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext((EGLDisplay)egl_display, (EGLContext)egl_context);
+        eglTerminate((EGLDisplay)egl_display);
+    }
+#endif
+    egl_display = nullptr;
+    egl_context = nullptr;
+
+    if (glfw_window)
+        glfwDestroyWindow(glfw_window);
+    glfw_window = nullptr;
+
+    if (glfw_initialized)
+        glfwTerminate();
+    glfw_initialized = false;
+
+    close_requested = false;
+}
+
+bool GLContext::shouldClose() const
+{
+    if (close_requested)
+        return true;
+    return glfw_window && !is_headless && glfwWindowShouldClose(glfw_window);
+}
+
+void GLContext::requestClose()
+{
+    close_requested = true;
+    if (glfw_window)
+        glfwSetWindowShouldClose(glfw_window, GLFW_TRUE);
+}
+
+void GLContext::swapBuffers()
+{
+    // في ال headless مفيش حاجة تتعرض، الصورة بتتقري من ال FBO
+    // بس لازم نبعت اوامر ال frame للدرايفر زي ما ال swap بيعمل
+    if (glfw_window && !is_headless)
+        glfwSwapBuffers(glfw_window);
+    else
+        glFlush();
+}
+
+void GLContext::setSwapInterval(int interval)
+{
+    swap_interval = interval;
+
+    // ال headless مفيهوش vblank اصلا
+    if (glfw_window && !is_headless)
+        glfwSwapInterval(interval);
+}
+
+void GLContext::pollEvents()
+{
+    if (glfw_window)
+        glfwPollEvents();
+}
+
+const char *GLContext::backend() const
+{
+    if (egl_context)
+        return "egl";
+    if (glfw_window)
+        return is_headless ? "glfw-hidden" : "glfw";
+    return "none";
+}
@@ -0,0 +1,268 @@
+#include "gl_state_cache.h"
+
+#include <iomanip>
+
+using namespace std;
+
+// رقم مستحيل يرجع من glGen فبنستخدمه علامة ان القيمة مش معروفة
+static const GLuint UNKNOWN_OBJECT = 0xFFFFFFFFu;
+static const GLenum UNKNOWN_ENUM = 0xFFFFFFFFu;
+
+GLStateCache::GLStateCache()
+{
+    invalidate();
+    resetCounters();
+}
+
+GLStateCache &GLStateCache::shared()
+{
+    static GLStateCache cache;
+    return cache;
+}
+
+bool GLStateCache::changed(StateKind kind, bool differs)
+{
+    if (differs)
+        counters[kind].issued++;
+    else
+        counters[kind].elided++;
+    return differs;
+}
+
+int GLStateCache::bufferSlot(GLenum target)
+{
+    switch (target)
+    {
+    case GL_ARRAY_BUFFER:
+        return ArrayBuffer;
+    case GL_ELEMENT_ARRAY_BUFFER:
+        return ElementArrayBuffer;
+    case GL_COPY_READ_BUFFER:
+        return CopyReadBuffer;
+    case GL_COPY_WRITE_BUFFER:
+        return CopyWriteBuffer;
+    case GL_PIXEL_PACK_BUFFER:
+        return PixelPackBuffer;
+    case GL_PIXEL_UNPACK_BUFFER:
+        return PixelUnpackBuffer;
+    case GL_UNIFORM_BUFFER:
+        return UniformBuffer;
+    default:
+        return -1;
+    }
+}
+
+void GLStateCache::useProgram(GLuint program)
+{
+    if (changed(Program, program != current_program))
+    {
+        glUseProgram(program);
+        current_program = program;
+    }
+}
+
+void GLStateCache::bindVertexArray(GLuint vertex_array)
+{
+    if (changed(VertexArray, vertex_array != current_vertex_array))
+    {
+        glBindVertexArray(vertex_array);
+        current_vertex_array = vertex_array;
+
+        // ال EBO متسجل جوه ال VAO فمنعرفش هو ايه
+        current_buffers[ElementArrayBuffer] = UNKNOWN_OBJECT;
+    }
+}
+
+void GLStateCache::bindBuffer(GLenum target, GLuint buffer)
+{
+    int slot = bufferSlot(target);
+    if (slot < 0)
+    {
+        changed(Buffer, true);
+        glBindBuffer(target, buffer);
+        return;
+    }
+
+    if (changed(Buffer, buffer != current_buffers[slot]))
+    {
+        glBindBuffer(target, buffer);
+        current_buffers[slot] = buffer;
+    }
+}
+
+void GLStateCache::bindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    bool read = target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER;
+    bool draw = target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER;
+
+    bool differs = (read && framebuffer != current_read_framebuffer) ||
+                   (draw && framebuffer != current_draw_framebuffer);
+    if (changed(Framebuffer, differs))
+    {
+        glBindFramebuffer(target, framebuffer);
+        if (read)
+            current_read_framebuffer = framebuffer;
+        if (draw)
+            current_draw_framebuffer = framebuffer;
+    }
+}
+
+void GLStateCache::viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    bool differs = x != current_viewport[0] || y != current_viewport[1] ||
+                   width != current_viewport[2] || height != current_viewport[3];
+    if (changed(Viewport, differs))
+    {
+        glViewport(x, y, width, height);
+        current_viewport[0] = x;
+        current_viewport[1] = y;
+        current_viewport[2] = width;
+        current_viewport[3] = height;
+    }
+}
+
+void GLStateCache::setBlend(bool enabled)
+{
+    if (changed(Blend, current_blend != (enabled ? 1 : 0)))
+    {
+        if (enabled)
+            glEnable(GL_BLEND);
+        else
+            glDisable(GL_BLEND);
+        current_blend = enabled ? 1 : 0;
+    }
+}
+
+void GLStateCache::blendFunc(GLenum source, GLenum destination)
+{
+    if (changed(BlendFunc, source != current_blend_func[0] || destination != current_blend_func[1]))
+    {
+        glBlendFunc(source, destination);
+        current_blend_func[0] = source;
+        current_blend_func[1] = destination;
+    }
+}
+
+void GLStateCache::clearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a)
+{
+    bool differs = !clear_color_known || r != current_clear_color[0] || g != current_clear_color[1] ||
+                   b != current_clear_color[2] || a != current_clear_color[3];
+    if (changed(ClearColor, differs))
+    {
+        glClearColor(r, g, b, a);
+        current_clear_color[0] = r;
+        current_clear_color[1] = g;
+        current_clear_color[2] = b;
+        current_clear_color[3] = a;
+        clear_color_known = true;
+    }
+}
+
+void GLStateCache::forgetProgram(GLuint program)
+{
+    // program متمسح و هو شغال بيفضل شغال لحد ما يتغير
+    // بس رقمه ممكن يرجع لprogram جديد، فمينفعش نشيل ال useProgram الجاي
+    if (program == current_program)
+        current_program = UNKNOWN_OBJECT;
+}
+
+void GLStateCache::forgetVertexArray(GLuint vertex_array)
+{
+    if (vertex_array == current_vertex_array)
+    {
+        current_vertex_array = 0;
+        current_buffers[ElementArrayBuffer] = UNKNOWN_OBJECT;
+    }
+}
+
+void GLStateCache::forgetBuffer(GLuint buffer)
+{
+    for (GLuint &bound : current_buffers)
+    {
+        if (bound == buffer)
+            bound = 0;
+    }
+}
+
+void GLStateCache::forgetFramebuffer(GLuint framebuffer)
+{
+    if (framebuffer == current_read_framebuffer)
+        current_read_framebuffer = 0;
+    if (framebuffer == current_draw_framebuffer)
+        current_draw_framebuffer = 0;
+}
+
+void GLStateCache::invalidate()
+{
+    current_program = UNKNOWN_OBJECT;
+    current_vertex_array = UNKNOWN_OBJECT;
+    for (GLuint &bound : current_buffers)
+        bound = UNKNOWN_OBJECT;
+    current_read_framebuffer = UNKNOWN_OBJECT;
+    current_draw_framebuffer = UNKNOWN_OBJECT;
+    current_viewport[0] = current_viewport[1] = -1;
+    current_viewport[2] = current_viewport[3] = -1;
+    current_blend = -1;
+    current_blend_func[0] = current_blend_func[1] = UNKNOWN_ENUM;
+    clear_color_known = false;
+}
+
+size_t GLStateCache::issued() const
+{
+    size_t total = 0;
+    for (const Counter &counter : counters)
+        total += counter.issued;
+    return total;
+}
+
+size_t GLStateCache::elided() const
+{
+    size_t total = 0;
+    for (const Counter &counter : counters)
+        total += counter.elided;
+    return total;
+}
+
+void GLStateCache::resetCounters()
+{
+    for (Counter &counter : counters)
+        counter = {0, 0};
+}
+
+const char *GLStateCache::stateName(StateKind kind)
+{
+    switch (kind)
+    {
+    case Program:
+        return "program";
+    case VertexArray:
+        return "vertex_array";
+    case Buffer:
+        return "buffer";
+    case Framebuffer:
+        return "framebuffer";
+    case Viewport:
+        return "viewport";
+    case Blend:
+        return "blend";
+    case BlendFunc:
+        return "blend_func";
+    case ClearColor:
+        return "clear_color";
+    default:
+        return "unknown";
+    }
+}
+
+void GLStateCache::printStats(ostream &out) const
+{
+    out << "GL state changes: " << issued() << " issued, " << elided() << " elided\n";
+    for (int kind = 0; kind < StateKindCount; kind++)
+    {
+        const Counter &counter = counters[kind];
+        if (counter.issued == 0 && counter.elided == 0)
+            continue;
+        out << "  " << left << setw(14) << stateName((StateKind)kind) << right
+            << " issued " << setw(8) << counter.issued << "  elided " << setw(8) << counter.elided << "\n";
+    }
+}
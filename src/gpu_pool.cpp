@@ -0,0 +1,273 @@
+#include "gpu_pool.h"
+
+#include "gl_state_cache.h"
+
+#include <iomanip>
+
+using namespace std;
+
+static const size_t MIN_BUFFER_CLASS_SHIFT = 8; // 256 byte
+
+static size_t buffer_class_index(size_t bytes)
+{
+    size_t index = 0;
+    while (((size_t)1 << (MIN_BUFFER_CLASS_SHIFT + index)) < bytes)
+        index++;
+    return index;
+}
+
+static size_t buffer_class_size(size_t index)
+{
+    return (size_t)1 << (MIN_BUFFER_CLASS_SHIFT + index);
+}
+
+PooledBuffer::PooledBuffer(PooledBuffer &&other) noexcept
+    : pool(other.pool), handle(other.handle), buffer_capacity(other.buffer_capacity)
+{
+    other.pool = nullptr;
+    other.handle = 0;
+    other.buffer_capacity = 0;
+}
+
+PooledBuffer &PooledBuffer::operator=(PooledBuffer &&other) noexcept
+{
+    if (this != &other)
+    {
+        reset();
+        pool = other.pool;
+        handle = other.handle;
+        buffer_capacity = other.buffer_capacity;
+        other.pool = nullptr;
+        other.handle = 0;
+        other.buffer_capacity = 0;
+    }
+    return *this;
+}
+
+void PooledBuffer::reset()
+{
+    if (handle && pool)
+        pool->releaseBuffer(handle, buffer_capacity);
+    pool = nullptr;
+    handle = 0;
+    buffer_capacity = 0;
+}
+
+PooledVertexArray::PooledVertexArray(PooledVertexArray &&other) noexcept
+    : pool(other.pool), handle(other.handle)
+{
+    other.pool = nullptr;
+    other.handle = 0;
+}
+
+PooledVertexArray &PooledVertexArray::operator=(PooledVertexArray &&other) noexcept
+{
+    if (this != &other)
+    {
+        reset();
+        pool = other.pool;
+        handle = other.handle;
+        other.pool = nullptr;
+        other.handle = 0;
+    }
+    return *this;
+}
+
+void PooledVertexArray::reset()
+{
+    if (handle && pool)
+        pool->releaseVertexArray(handle);
+    pool = nullptr;
+    handle = 0;
+}
+
+GPUResourcePool::GPUResourcePool()
+    : live_vertex_arrays(0), created_vertex_arrays(0), reused_vertex_arrays(0), free_bytes(0),
+      free_limit(64 * 1024 * 1024), closed(false)
+{
+}
+
+GPUResourcePool::~GPUResourcePool()
+{
+    // ال shared pool بيتمسح بعد main، و ساعتها ال context مبقاش موجود
+    // فمفيش GL calls هنا، اللي لسه فيه الدرايفر مسحه مع ال context
+    closed = true;
+}
+
+GPUResourcePool &GPUResourcePool::shared()
+{
+    static GPUResourcePool pool;
+    return pool;
+}
+
+PooledBuffer GPUResourcePool::acquireBuffer(size_t bytes, const void *data)
+{
+    size_t index = buffer_class_index(bytes);
+    if (index >= buffer_classes.size())
+        buffer_classes.resize(index + 1);
+
+    BufferClass &size_class = buffer_classes[index];
+    size_t capacity = buffer_class_size(index);
+
+    PooledBuffer buffer;
+    buffer.pool = this;
+    buffer.buffer_capacity = capacity;
+
+    // GL_COPY_WRITE_BUFFER مش مربوط بحاجة في ال VAO فمش هنبوظ اي state
+    if (!size_class.free.empty())
+    {
+        buffer.handle = size_class.free.back();
+        size_class.free.pop_back();
+        size_class.reused++;
+        free_bytes -= capacity;
+
+        GLStateCache::shared().bindBuffer(GL_COPY_WRITE_BUFFER, buffer.handle);
+    }
+    else
+    {
+        glGenBuffers(1, &buffer.handle);
+        size_class.created++;
+
+        GLStateCache::shared().bindBuffer(GL_COPY_WRITE_BUFFER, buffer.handle);
+        glBufferData(GL_COPY_WRITE_BUFFER, capacity, nullptr, GL_STATIC_DRAW);
+    }
+
+    if (data && bytes > 0)
+        glBufferSubData(GL_COPY_WRITE_BUFFER, 0, bytes, data);
+    GLStateCache::shared().bindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    size_class.live++;
+    return buffer;
+}
+
+PooledVertexArray GPUResourcePool::acquireVertexArray()
+{
+    PooledVertexArray vertex_array;
+    vertex_array.pool = this;
+
+    if (!free_vertex_arrays.empty())
+    {
+        vertex_array.handle = free_vertex_arrays.back();
+        free_vertex_arrays.pop_back();
+        reused_vertex_arrays++;
+    }
+    else
+    {
+        glGenVertexArrays(1, &vertex_array.handle);
+        created_vertex_arrays++;
+    }
+
+    live_vertex_arrays++;
+    return vertex_array;
+}
+
+void GPUResourcePool::releaseBuffer(GLuint id, size_t capacity)
+{
+    size_t index = buffer_class_index(capacity);
+    BufferClass &size_class = buffer_classes[index];
+    size_class.live--;
+
+    if (closed)
+        return;
+
+    // ال pool مليان: نمسحه بدل ما نحجز ميموري علي ال GPU من غير لازمة
+    if (free_bytes + capacity > free_limit)
+    {
+        glDeleteBuffers(1, &id);
+        GLStateCache::shared().forgetBuffer(id);
+        return;
+    }
+
+    size_class.free.push_back(id);
+    free_bytes += capacity;
+}
+
+void GPUResourcePool::releaseVertexArray(GLuint id)
+{
+    live_vertex_arrays--;
+    if (closed)
+        return;
+
+    // بنرجعه فاضي: كل ال attributes مقفولة و ال divisors صفر و مفيش EBO
+    GLint max_attributes = 0;
+    glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &max_attributes);
+
+    GLStateCache::shared().bindVertexArray(id);
+    for (GLint i = 0; i < max_attributes; i++)
+    {
+        glDisableVertexAttribArray(i);
+        glVertexAttribDivisor(i, 0);
+    }
+    GLStateCache::shared().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GLStateCache::shared().bindVertexArray(0);
+
+    free_vertex_arrays.push_back(id);
+}
+
+void GPUResourcePool::trim()
+{
+    if (closed)
+        return;
+
+    for (BufferClass &size_class : buffer_classes)
+    {
+        if (!size_class.free.empty())
+            glDeleteBuffers((GLsizei)size_class.free.size(), size_class.free.data());
+        for (GLuint id : size_class.free)
+            GLStateCache::shared().forgetBuffer(id);
+        size_class.free.clear();
+    }
+    if (!free_vertex_arrays.empty())
+        glDeleteVertexArrays((GLsizei)free_vertex_arrays.size(), free_vertex_arrays.data());
+    for (GLuint id : free_vertex_arrays)
+        GLStateCache::shared().forgetVertexArray(id);
+    free_vertex_arrays.clear();
+    free_bytes = 0;
+}
+
+void GPUResourcePool::shutdown()
+{
+    trim();
+    closed = true;
+}
+
+void GPUResourcePool::open()
+{
+    closed = false;
+}
+
+vector<GPUResourcePool::ClassStats> GPUResourcePool::bufferStats() const
+{
+    vector<ClassStats> stats;
+    for (size_t i = 0; i < buffer_classes.size(); i++)
+    {
+        const BufferClass &size_class = buffer_classes[i];
+        if (size_class.created == 0)
+            continue;
+
+        size_t size = buffer_class_size(i);
+        stats.push_back({size, size_class.live, size_class.free.size(), size_class.created, size_class.reused,
+                         size_class.live * size, size_class.free.size() * size});
+    }
+    return stats;
+}
+
+GPUResourcePool::ClassStats GPUResourcePool::vertexArrayStats() const
+{
+    return {0, live_vertex_arrays, free_vertex_arrays.size(), created_vertex_arrays, reused_vertex_arrays, 0, 0};
+}
+
+void GPUResourcePool::printStats(ostream &out) const
+{
+    out << "GPU resource pool:\n";
+    for (const ClassStats &stats : bufferStats())
+    {
+        out << "  buffers " << setw(9) << stats.size << " B: live " << stats.live << " (" << stats.live_bytes
+            << " B), free " << stats.free << " (" << stats.free_bytes << " B), created " << stats.created
+            << ", reused " << stats.reused << "\n";
+    }
+
+    ClassStats vertex_arrays = vertexArrayStats();
+    out << "  vertex arrays: live " << vertex_arrays.live << ", free " << vertex_arrays.free
+        << ", created " << vertex_arrays.created << ", reused " << vertex_arrays.reused << "\n";
+}
@@ -0,0 +1,773 @@
+#include "image_kernels.h"
+
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define IMAGE_KERNELS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// النسخ دي بس اللي بتتبني بـ SSE2 / AVX2، و باقي الملف علي ال flags العادية
+// فالبرنامج بيشتغل علي اي CPU و بيختار وقت التشغيل (MSVC مش محتاج flags لل intrinsics)
+#if defined(IMAGE_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+
+using namespace std;
+
+// ---- sRGB tables -----------------------------------------------------------
+
+static const uint32_t ENCODE_MIN_BITS = 0x39000000; // 2^-13، اللي اقل منه بيطلع 0
+static const uint32_t ENCODE_MAX_BITS = 0x3f7fffff; // اكبر float اقل من 1
+static const int ENCODE_BUCKETS = 104;              // 13 exponent * 8
+
+static double srgb_encode_exact(double linear)
+{
+    return linear <= 0.0031308 ? linear * 12.92 : 1.055 * pow(linear, 1.0 / 2.4) - 0.055;
+}
+
+static double srgb_decode_exact(double srgb)
+{
+    return srgb <= 0.04045 ? srgb / 12.92 : pow((srgb + 0.055) / 1.055, 2.4);
+}
+
+static float bits_to_float(uint32_t bits)
+{
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+struct SrgbTables
+{
+    float decode[512]; // 0..255: sRGB -> linear، 256..511: alpha / 255 (فال AVX2 بيعمل gather واحد للاربع قنوات)
+    uint32_t bias[ENCODE_BUCKETS];
+    uint32_t scale[ENCODE_BUCKETS];
+
+    SrgbTables()
+    {
+        for (int i = 0; i < 256; i++)
+        {
+            decode[i] = (float)srgb_decode_exact(i / 255.0);
+            decode[256 + i] = i * (1.0f / 255.0f);
+        }
+
+        // كل bucket خط (least squares) لـ 255 * sRGB + 0.5، بـ 16 bit كسور
+        // فال encode = floor(bias + scale * t) و t هي ال 8 bits اللي بعد ال bucket في ال mantissa
+        for (int i = 0; i < ENCODE_BUCKETS; i++)
+        {
+            double sum_t = 0.0, sum_tt = 0.0, sum_y = 0.0, sum_ty = 0.0;
+            for (int t = 0; t < 256; t++)
+            {
+                uint32_t bits = ENCODE_MIN_BITS + ((uint32_t)i << 20) + ((uint32_t)t << 12) + (1u << 11);
+                double y = 255.0 * srgb_encode_exact(bits_to_float(bits)) + 0.5;
+                sum_t += t;
+                sum_tt += (double)t * t;
+                sum_y += y;
+                sum_ty += t * y;
+            }
+            double slope = (256.0 * sum_ty - sum_t * sum_y) / (256.0 * sum_tt - sum_t * sum_t);
+            double intercept = (sum_y - slope * sum_t) / 256.0;
+            bias[i] = (uint32_t)llround(intercept * 65536.0);
+            scale[i] = (uint32_t)llround(slope * 65536.0);
+        }
+    }
+};
+
+static const SrgbTables &srgb_tables()
+{
+    static const SrgbTables tables;
+    return tables;
+}
+
+// ---- resize taps -----------------------------------------------------------
+
+// لكل pixel في ال output: ال pixels اللي بيتحسب منها و وزن كل واحد (مجموعهم 1)
+struct FilterTaps
+{
+    vector<int> first;
+    vector<int> count;
+    vector<int> index;
+    vector<float> weight;
+};
+
+static void make_taps(int in_size, int out_size, FilterTaps &taps)
+{
+    double scale = (double)in_size / out_size;
+    double radius = max(1.0, scale);
+
+    taps.first.resize(out_size);
+    taps.count.resize(out_size);
+    taps.index.clear();
+    taps.weight.clear();
+    for (int o = 0; o < out_size; o++)
+    {
+        double center = (o + 0.5) * scale - 0.5;
+        int low = (int)floor(center - radius) + 1;
+        int high = (int)ceil(center + radius) - 1;
+
+        taps.first[o] = (int)taps.index.size();
+        double total = 0.0;
+        for (int i = low; i <= high; i++)
+        {
+            double w = 1.0 - fabs(i - center) / radius;
+            if (w <= 0.0)
+                continue;
+
+            // برا الصورة = آخر pixel، و لو نفس اللي قبله بنجمع الوزن عليه
+            int clamped = min(max(i, 0), in_size - 1);
+            if (taps.index.size() > (size_t)taps.first[o] && taps.index.back() == clamped)
+            {
+                taps.weight.back() += (float)w;
+            }
+            else
+            {
+                taps.index.push_back(clamped);
+                taps.weight.push_back((float)w);
+            }
+            total += w;
+        }
+        taps.count[o] = (int)taps.index.size() - taps.first[o];
+        for (int k = taps.first[o]; k < (int)taps.index.size(); k++)
+            taps.weight[k] = (float)(taps.weight[k] / total);
+    }
+}
+
+// ---- scalar ----------------------------------------------------------------
+// المرجع: كل النسخ التانية لازم تطلع نفس البايتات بالظبط
+
+static uint8_t encode_channel(const SrgbTables &tables, float value)
+{
+    float low = bits_to_float(ENCODE_MIN_BITS);
+    float high = bits_to_float(ENCODE_MAX_BITS);
+    if (!(value > low))
+        value = low;
+    if (value > high)
+        value = high;
+
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t index = (bits - ENCODE_MIN_BITS) >> 20;
+    uint32_t t = (bits >> 12) & 0xFF;
+    return (uint8_t)min((tables.bias[index] + tables.scale[index] * t) >> 16, 255u);
+}
+
+static uint8_t encode_alpha(float value)
+{
+    if (!(value > 0.0f))
+        value = 0.0f;
+    if (value > 1.0f)
+        value = 1.0f;
+    return (uint8_t)(int)(value * 255.0f + 0.5f);
+}
+
+static void decode_scalar(const SrgbTables &tables, const uint8_t *in, float *out, size_t pixels)
+{
+    for (size_t i = 0; i < pixels; i++)
+    {
+        out[i * 4 + 0] = tables.decode[in[i * 4 + 0]];
+        out[i * 4 + 1] = tables.decode[in[i * 4 + 1]];
+        out[i * 4 + 2] = tables.decode[in[i * 4 + 2]];
+        out[i * 4 + 3] = tables.decode[256 + in[i * 4 + 3]];
+    }
+}
+
+static void encode_scalar(const SrgbTables &tables, const float *in, uint8_t *out, size_t pixels)
+{
+    for (size_t i = 0; i < pixels; i++)
+    {
+        out[i * 4 + 0] = encode_channel(tables, in[i * 4 + 0]);
+        out[i * 4 + 1] = encode_channel(tables, in[i * 4 + 1]);
+        out[i * 4 + 2] = encode_channel(tables, in[i * 4 + 2]);
+        out[i * 4 + 3] = encode_alpha(in[i * 4 + 3]);
+    }
+}
+
+static void premultiply_scalar(float *rgba, size_t pixels)
+{
+    for (size_t i = 0; i < pixels; i++)
+    {
+        float *pixel = rgba + i * 4;
+        pixel[0] = pixel[0] * pixel[3];
+        pixel[1] = pixel[1] * pixel[3];
+        pixel[2] = pixel[2] * pixel[3];
+    }
+}
+
+// rows صفوف ورا بعض، كل pixel في ال output = مجموع الوزن * ال input بترتيب ال taps
+static void horizontal_scalar(const float *in, int in_width, float *out, int out_width, int rows,
+                              const FilterTaps &taps)
+{
+    for (int y = 0; y < rows; y++)
+    {
+        const float *row = in + (size_t)y * in_width * 4;
+        float *dst = out + (size_t)y * out_width * 4;
+        for (int x = 0; x < out_width; x++)
+        {
+            float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+            for (int k = taps.first[x]; k < taps.first[x] + taps.count[x]; k++)
+            {
+                const float *pixel = row + (size_t)taps.index[k] * 4;
+                for (int c = 0; c < 4; c++)
+                    sum[c] = sum[c] + taps.weight[k] * pixel[c];
+            }
+            memcpy(dst + (size_t)x * 4, sum, sizeof(sum));
+        }
+    }
+}
+
+// صف واحد في ال output من count صف في ال input (كلهم floats قيمة)
+static void vertical_scalar(const float *const *rows, const float *weights, int count, float *out, size_t floats)
+{
+    memset(out, 0, floats * sizeof(float));
+    for (int k = 0; k < count; k++)
+    {
+        for (size_t i = 0; i < floats; i++)
+            out[i] = out[i] + weights[k] * rows[k][i];
+    }
+}
+
+// ((a + c) + (b + d)) * 0.25: الرأسي الاول، نفس الترتيب في كل النسخ
+static void downsample_scalar(const float *row0, const float *row1, float *out, int out_width)
+{
+    for (int x = 0; x < out_width; x++)
+    {
+        for (int c = 0; c < 4; c++)
+        {
+            float left = row0[x * 8 + c] + row1[x * 8 + c];
+            float right = row0[x * 8 + 4 + c] + row1[x * 8 + 4 + c];
+            out[x * 4 + c] = (left + right) * 0.25f;
+        }
+    }
+}
+
+// ---- SSE2 ------------------------------------------------------------------
+
+#ifdef IMAGE_KERNELS_X86
+
+// pixel واحد (4 قنوات) -> 4 int32، ال alpha في آخر lane
+TARGET_SSE2 static __m128i encode_pixel_sse2(const SrgbTables &tables, __m128 value)
+{
+    const __m128 low = _mm_castsi128_ps(_mm_set1_epi32((int)ENCODE_MIN_BITS));
+    const __m128 high = _mm_castsi128_ps(_mm_set1_epi32((int)ENCODE_MAX_BITS));
+    const __m128i alpha_mask = _mm_setr_epi32(0, 0, 0, -1);
+
+    // max(x, low): لو x = NaN بيرجع low زي ال scalar
+    __m128 clamped = _mm_min_ps(_mm_max_ps(value, low), high);
+    __m128i bits = _mm_castps_si128(clamped);
+    __m128i index = _mm_srli_epi32(_mm_sub_epi32(bits, _mm_set1_epi32((int)ENCODE_MIN_BITS)), 20);
+    __m128i t = _mm_and_si128(_mm_srli_epi32(bits, 12), _mm_set1_epi32(0xFF));
+
+    // SSE2 مفيهوش gather
+    alignas(16) uint32_t lanes[4];
+    _mm_store_si128((__m128i *)lanes, index);
+    __m128i bias = _mm_setr_epi32((int)tables.bias[lanes[0]], (int)tables.bias[lanes[1]], (int)tables.bias[lanes[2]], 0);
+    __m128i scale =
+        _mm_setr_epi32((int)tables.scale[lanes[0]], (int)tables.scale[lanes[1]], (int)tables.scale[lanes[2]], 0);
+
+    // scale و t اقل من 2^15 فـ madd (16 bit) بيدي الضرب بالظبط
+    __m128i color = _mm_srli_epi32(_mm_add_epi32(bias, _mm_madd_epi16(scale, t)), 16);
+
+    __m128 alpha = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+    __m128i alpha_value = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(alpha, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+    return _mm_or_si128(_mm_andnot_si128(alpha_mask, color), _mm_and_si128(alpha_mask, alpha_value));
+}
+
+TARGET_SSE2 static void encode_sse2(const SrgbTables &tables, const float *in, uint8_t *out, size_t pixels)
+{
+    size_t i = 0;
+    for (; i + 4 <= pixels; i += 4)
+    {
+        __m128i p0 = encode_pixel_sse2(tables, _mm_loadu_ps(in + i * 4));
+        __m128i p1 = encode_pixel_sse2(tables, _mm_loadu_ps(in + i * 4 + 4));
+        __m128i p2 = encode_pixel_sse2(tables, _mm_loadu_ps(in + i * 4 + 8));
+        __m128i p3 = encode_pixel_sse2(tables, _mm_loadu_ps(in + i * 4 + 12));
+
+        // القيم اكبر من 255 بتتقص في packus زي min في ال scalar
+        __m128i packed = _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3));
+        _mm_storeu_si128((__m128i *)(out + i * 4), packed);
+    }
+    encode_scalar(tables, in + i * 4, out + i * 4, pixels - i);
+}
+
+TARGET_SSE2 static void premultiply_sse2(float *rgba, size_t pixels)
+{
+    const __m128 rgb_mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (size_t i = 0; i < pixels; i++)
+    {
+        __m128 pixel = _mm_loadu_ps(rgba + i * 4);
+        __m128 alpha = _mm_shuffle_ps(pixel, pixel, _MM_SHUFFLE(3, 3, 3, 3));
+        __m128 factor = _mm_or_ps(_mm_and_ps(rgb_mask, alpha), _mm_andnot_ps(rgb_mask, one));
+        _mm_storeu_ps(rgba + i * 4, _mm_mul_ps(pixel, factor));
+    }
+}
+
+TARGET_SSE2 static void horizontal_sse2(const float *in, int in_width, float *out, int out_width, int rows,
+                                        const FilterTaps &taps)
+{
+    for (int y = 0; y < rows; y++)
+    {
+        const float *row = in + (size_t)y * in_width * 4;
+        float *dst = out + (size_t)y * out_width * 4;
+        for (int x = 0; x < out_width; x++)
+        {
+            __m128 sum = _mm_setzero_ps();
+            for (int k = taps.first[x]; k < taps.first[x] + taps.count[x]; k++)
+            {
+                __m128 pixel = _mm_loadu_ps(row + (size_t)taps.index[k] * 4);
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(taps.weight[k]), pixel));
+            }
+            _mm_storeu_ps(dst + (size_t)x * 4, sum);
+        }
+    }
+}
+
+TARGET_SSE2 static void vertical_sse2(const float *const *rows, const float *weights, int count, float *out,
+                                      size_t floats)
+{
+    memset(out, 0, floats * sizeof(float));
+    for (int k = 0; k < count; k++)
+    {
+        __m128 weight = _mm_set1_ps(weights[k]);
+        const float *row = rows[k];
+        size_t i = 0;
+        for (; i + 4 <= floats; i += 4)
+            _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(weight, _mm_loadu_ps(row + i))));
+        for (; i < floats; i++)
+            out[i] = out[i] + weights[k] * row[i];
+    }
+}
+
+TARGET_SSE2 static void downsample_sse2(const float *row0, const float *row1, float *out, int out_width)
+{
+    const __m128 quarter = _mm_set1_ps(0.25f);
+    for (int x = 0; x < out_width; x++)
+    {
+        __m128 left = _mm_add_ps(_mm_loadu_ps(row0 + x * 8), _mm_loadu_ps(row1 + x * 8));
+        __m128 right = _mm_add_ps(_mm_loadu_ps(row0 + x * 8 + 4), _mm_loadu_ps(row1 + x * 8 + 4));
+        _mm_storeu_ps(out + x * 4, _mm_mul_ps(_mm_add_ps(left, right), quarter));
+    }
+}
+
+// ---- AVX2 ------------------------------------------------------------------
+
+TARGET_AVX2 static void decode_avx2(const SrgbTables &tables, const uint8_t *in, float *out, size_t pixels)
+{
+    // pixelين في المرة: ال alpha بيتقري من النص التاني من ال table
+    const __m256i alpha_offset = _mm256_setr_epi32(0, 0, 0, 256, 0, 0, 0, 256);
+    size_t i = 0;
+    for (; i + 2 <= pixels; i += 2)
+    {
+        __m256i index = _mm256_add_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(in + i * 4))),
+                                         alpha_offset);
+        _mm256_storeu_ps(out + i * 4, _mm256_i32gather_ps(tables.decode, index, 4));
+    }
+    decode_scalar(tables, in + i * 4, out + i * 4, pixels - i);
+}
+
+// pixelين (8 قنوات) -> 8 int32، ال alpha في lane 3 و 7
+TARGET_AVX2 static __m256i encode_pixels_avx2(const SrgbTables &tables, __m256 value)
+{
+    const __m256 low = _mm256_castsi256_ps(_mm256_set1_epi32((int)ENCODE_MIN_BITS));
+    const __m256 high = _mm256_castsi256_ps(_mm256_set1_epi32((int)ENCODE_MAX_BITS));
+
+    __m256 clamped = _mm256_min_ps(_mm256_max_ps(value, low), high);
+    __m256i bits = _mm256_castps_si256(clamped);
+    __m256i index = _mm256_srli_epi32(_mm256_sub_epi32(bits, _mm256_set1_epi32((int)ENCODE_MIN_BITS)), 20);
+    __m256i t = _mm256_and_si256(_mm256_srli_epi32(bits, 12), _mm256_set1_epi32(0xFF));
+    __m256i bias = _mm256_i32gather_epi32((const int *)tables.bias, index, 4);
+    __m256i scale = _mm256_i32gather_epi32((const int *)tables.scale, index, 4);
+    __m256i color = _mm256_srli_epi32(_mm256_add_epi32(bias, _mm256_madd_epi16(scale, t)), 16);
+
+    __m256 alpha = _mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+    __m256i alpha_value =
+        _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(alpha, _mm256_set1_ps(255.0f)), _mm256_set1_ps(0.5f)));
+    return _mm256_blend_epi32(color, alpha_value, 0x88);
+}
+
+TARGET_AVX2 static void encode_avx2(const SrgbTables &tables, const float *in, uint8_t *out, size_t pixels)
+{
+    // packs بيشتغل جوه كل 128 bit: الترتيب بيطلع p0 p2 | p1 p3 و ال permute بيرجعه
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    size_t i = 0;
+    for (; i + 4 <= pixels; i += 4)
+    {
+        __m256i p01 = encode_pixels_avx2(tables, _mm256_loadu_ps(in + i * 4));
+        __m256i p23 = encode_pixels_avx2(tables, _mm256_loadu_ps(in + i * 4 + 8));
+        __m256i words = _mm256_packs_epi32(p01, p23);
+        __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(words, words), order);
+        _mm_storeu_si128((__m128i *)(out + i * 4), _mm256_castsi256_si128(bytes));
+    }
+    encode_scalar(tables, in + i * 4, out + i * 4, pixels - i);
+}
+
+TARGET_AVX2 static void premultiply_avx2(float *rgba, size_t pixels)
+{
+    const __m256 one = _mm256_set1_ps(1.0f);
+    size_t i = 0;
+    for (; i + 2 <= pixels; i += 2)
+    {
+        __m256 pixel = _mm256_loadu_ps(rgba + i * 4);
+        __m256 alpha = _mm256_permute_ps(pixel, _MM_SHUFFLE(3, 3, 3, 3));
+        __m256 factor = _mm256_blend_ps(alpha, one, 0x88);
+        _mm256_storeu_ps(rgba + i * 4, _mm256_mul_ps(pixel, factor));
+    }
+    premultiply_scalar(rgba + i * 4, pixels - i);
+}
+
+// صفين في المرة: الصف الاول في ال 128 bit التحتانيين و التاني في الفوقانيين
+TARGET_AVX2 static void horizontal_avx2(const float *in, int in_width, float *out, int out_width, int rows,
+                                        const FilterTaps &taps)
+{
+    size_t in_floats = (size_t)in_width * 4;
+    size_t out_floats = (size_t)out_width * 4;
+    int y = 0;
+    for (; y + 2 <= rows; y += 2)
+    {
+        const float *row0 = in + (size_t)y * in_floats;
+        const float *row1 = row0 + in_floats;
+        float *dst0 = out + (size_t)y * out_floats;
+        float *dst1 = dst0 + out_floats;
+        for (int x = 0; x < out_width; x++)
+        {
+            __m256 sum = _mm256_setzero_ps();
+            for (int k = taps.first[x]; k < taps.first[x] + taps.count[x]; k++)
+            {
+                size_t offset = (size_t)taps.index[k] * 4;
+                __m256 pixels = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(row0 + offset)),
+                                                     _mm_loadu_ps(row1 + offset), 1);
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(taps.weight[k]), pixels));
+            }
+            _mm_storeu_ps(dst0 + (size_t)x * 4, _mm256_castps256_ps128(sum));
+            _mm_storeu_ps(dst1 + (size_t)x * 4, _mm256_extractf128_ps(sum, 1));
+        }
+    }
+    if (y < rows)
+        horizontal_sse2(in + (size_t)y * in_floats, in_width, out + (size_t)y * out_floats, out_width, rows - y, taps);
+}
+
+TARGET_AVX2 static void vertical_avx2(const float *const *rows, const float *weights, int count, float *out,
+                                      size_t floats)
+{
+    memset(out, 0, floats * sizeof(float));
+    for (int k = 0; k < count; k++)
+    {
+        __m256 weight = _mm256_set1_ps(weights[k]);
+        const float *row = rows[k];
+        size_t i = 0;
+        for (; i + 8 <= floats; i += 8)
+        {
+            __m256 sum = _mm256_add_ps(_mm256_loadu_ps(out + i), _mm256_mul_ps(weight, _mm256_loadu_ps(row + i)));
+            _mm256_storeu_ps(out + i, sum);
+        }
+        for (; i < floats; i++)
+            out[i] = out[i] + weights[k] * row[i];
+    }
+}
+
+TARGET_AVX2 static void downsample_avx2(const float *row0, const float *row1, float *out, int out_width)
+{
+    const __m256 quarter = _mm256_set1_ps(0.25f);
+    int x = 0;
+    for (; x + 2 <= out_width; x += 2)
+    {
+        // (a + c | b + d) لكل pixel في ال output، و بعدين النصين علي بعض
+        __m256 first = _mm256_add_ps(_mm256_loadu_ps(row0 + x * 8), _mm256_loadu_ps(row1 + x * 8));
+        __m256 second = _mm256_add_ps(_mm256_loadu_ps(row0 + x * 8 + 8), _mm256_loadu_ps(row1 + x * 8 + 8));
+        __m256 left = _mm256_permute2f128_ps(first, second, 0x20);
+        __m256 right = _mm256_permute2f128_ps(first, second, 0x31);
+        _mm256_storeu_ps(out + x * 4, _mm256_mul_ps(_mm256_add_ps(left, right), quarter));
+    }
+    downsample_scalar(row0 + x * 8, row1 + x * 8, out + x * 4, out_width - x);
+}
+
+#endif
+
+// ---- dispatch --------------------------------------------------------------
+
+struct KernelTable
+{
+    void (*decode)(const SrgbTables &, const uint8_t *, float *, size_t);
+    void (*encode)(const SrgbTables &, const float *, uint8_t *, size_t);
+    void (*premultiply)(float *, size_t);
+    void (*horizontal)(const float *, int, float *, int, int, const FilterTaps &);
+    void (*vertical)(const float *const *, const float *, int, float *, size_t);
+    void (*downsample)(const float *, const float *, float *, int);
+};
+
+static const KernelTable scalar_kernels = {decode_scalar, encode_scalar, premultiply_scalar,
+                                           horizontal_scalar, vertical_scalar, downsample_scalar};
+#ifdef IMAGE_KERNELS_X86
+static const KernelTable sse2_kernels = {decode_scalar, encode_sse2, premultiply_sse2,
+                                         horizontal_sse2, vertical_sse2, downsample_sse2};
+static const KernelTable avx2_kernels = {decode_avx2, encode_avx2, premultiply_avx2,
+                                         horizontal_avx2, vertical_avx2, downsample_avx2};
+#endif
+
+SimdLevel simd_detect()
+{
+#ifdef IMAGE_KERNELS_X86
+#if defined(__GNUC__) || defined(__clang__)
+    // بيشوف كمان ان ال OS بيحفظ registers ال AVX (XGETBV)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return SimdLevel::SSE2;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    bool sse2 = (info[3] & (1 << 26)) != 0;
+    bool os_avx = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+    __cpuidex(info, 7, 0);
+    if (os_avx && (info[1] & (1 << 5)) != 0)
+        return SimdLevel::AVX2;
+    if (sse2)
+        return SimdLevel::SSE2;
+#endif
+#endif
+    return SimdLevel::Scalar;
+}
+
+// -1 = لسه متحددش
+static atomic<int> selected_level(-1);
+
+void simd_set_level(SimdLevel level)
+{
+    selected_level = (int)min(level, simd_detect());
+}
+
+SimdLevel simd_level()
+{
+    int level = selected_level.load();
+    if (level < 0)
+    {
+        level = (int)simd_detect();
+        selected_level = level;
+    }
+    return (SimdLevel)level;
+}
+
+const char *simd_level_name(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::Scalar:
+        return "scalar";
+    case SimdLevel::SSE2:
+        return "sse2";
+    case SimdLevel::AVX2:
+        return "avx2";
+    }
+    return "unknown";
+}
+
+static const KernelTable &kernels()
+{
+#ifdef IMAGE_KERNELS_X86
+    switch (simd_level())
+    {
+    case SimdLevel::AVX2:
+        return avx2_kernels;
+    case SimdLevel::SSE2:
+        return sse2_kernels;
+    case SimdLevel::Scalar:
+        break;
+    }
+#endif
+    return scalar_kernels;
+}
+
+// ---- tiles -----------------------------------------------------------------
+
+// 16K pixel (256 KB float) لكل tile: كبير كفاية ان ال scheduling ميبانش و صغير كفاية انه يتوزع
+static const size_t PIXEL_TILE = 16 * 1024;
+
+template <typename Body>
+static void for_each_tile(ThreadPool *pool, size_t pixels, const Body &body)
+{
+    size_t tiles = (pixels + PIXEL_TILE - 1) / PIXEL_TILE;
+    if (!pool || tiles < 2)
+    {
+        body(0, pixels);
+        return;
+    }
+    pool->parallelFor(tiles, [&](size_t tile)
+    {
+        size_t begin = tile * PIXEL_TILE;
+        body(begin, min(pixels, begin + PIXEL_TILE) - begin);
+    });
+}
+
+// صفوف كل واحد فيها row_pixels، متجمعة tiles بنفس الحجم تقريبا
+template <typename Body>
+static void for_each_row_tile(ThreadPool *pool, size_t rows, size_t row_pixels, const Body &body)
+{
+    size_t tile_rows = max<size_t>(2, PIXEL_TILE / max<size_t>(row_pixels, 1));
+    size_t tiles = (rows + tile_rows - 1) / tile_rows;
+    if (!pool || tiles < 2)
+    {
+        body(0, rows);
+        return;
+    }
+    pool->parallelFor(tiles, [&](size_t tile)
+    {
+        size_t begin = tile * tile_rows;
+        body(begin, min(rows, begin + tile_rows) - begin);
+    });
+}
+
+void srgb_to_linear(const uint8_t *srgb, float *linear, size_t pixels, ThreadPool *pool)
+{
+    const SrgbTables &tables = srgb_tables();
+    const KernelTable &k = kernels();
+    for_each_tile(pool, pixels, [&](size_t begin, size_t count)
+    {
+        k.decode(tables, srgb + begin * 4, linear + begin * 4, count);
+    });
+}
+
+void linear_to_srgb(const float *linear, uint8_t *srgb, size_t pixels, ThreadPool *pool)
+{
+    const SrgbTables &tables = srgb_tables();
+    const KernelTable &k = kernels();
+    for_each_tile(pool, pixels, [&](size_t begin, size_t count)
+    {
+        k.encode(tables, linear + begin * 4, srgb + begin * 4, count);
+    });
+}
+
+void premultiply_alpha(float *rgba, size_t pixels, ThreadPool *pool)
+{
+    const KernelTable &k = kernels();
+    for_each_tile(pool, pixels, [&](size_t begin, size_t count)
+    {
+        k.premultiply(rgba + begin * 4, count);
+    });
+}
+
+void resize_image(const float *in, int in_width, int in_height, float *out, int out_width, int out_height,
+                  ThreadPool *pool)
+{
+    if (in_width <= 0 || in_height <= 0 || out_width <= 0 || out_height <= 0)
+        return;
+
+    const KernelTable &k = kernels();
+    FilterTaps horizontal, vertical;
+    make_taps(in_width, out_width, horizontal);
+    make_taps(in_height, out_height, vertical);
+
+    // افقي لكل صفوف ال input، و بعدين رأسي لكل صف في ال output
+    vector<float> middle((size_t)out_width * in_height * 4);
+    for_each_row_tile(pool, (size_t)in_height, (size_t)max(in_width, out_width), [&](size_t begin, size_t count)
+    {
+        k.horizontal(in + begin * in_width * 4, in_width, middle.data() + begin * out_width * 4, out_width, (int)count,
+                     horizontal);
+    });
+
+    size_t row_floats = (size_t)out_width * 4;
+    for_each_row_tile(pool, (size_t)out_height, (size_t)out_width, [&](size_t begin, size_t count)
+    {
+        vector<const float *> rows;
+        for (size_t y = begin; y < begin + count; y++)
+        {
+            rows.clear();
+            for (int t = vertical.first[y]; t < vertical.first[y] + vertical.count[y]; t++)
+                rows.push_back(middle.data() + (size_t)vertical.index[t] * row_floats);
+            k.vertical(rows.data(), vertical.weight.data() + vertical.first[y], vertical.count[y],
+                       out + y * row_floats, row_floats);
+        }
+    });
+}
+
+void downsample_image(const float *in, int width, int height, vector<float> &out, ThreadPool *pool)
+{
+    int out_width = max(1, width / 2);
+    int out_height = max(1, height / 2);
+    out.resize((size_t)out_width * out_height * 4);
+    if (width % 2 != 0 || height % 2 != 0)
+    {
+        resize_image(in, width, height, out.data(), out_width, out_height, pool);
+        return;
+    }
+
+    const KernelTable &k = kernels();
+    for_each_row_tile(pool, (size_t)out_height, (size_t)width, [&](size_t begin, size_t count)
+    {
+        for (size_t y = begin; y < begin + count; y++)
+        {
+            const float *row0 = in + y * 2 * width * 4;
+            k.downsample(row0, row0 + (size_t)width * 4, out.data() + y * out_width * 4, out_width);
+        }
+    });
+}
+
+static void encode_level(const vector<float> &linear, int width, int height, vector<ImageLevel> &levels,
+                         ThreadPool *pool)
+{
+    ImageLevel level;
+    level.width = width;
+    level.height = height;
+    level.rgba.resize((size_t)width * height * 4);
+    linear_to_srgb(linear.data(), level.rgba.data(), (size_t)width * height, pool);
+    levels.push_back(move(level));
+}
+
+void build_image_levels(const uint8_t *srgb, int width, int height, int max_size, bool mips, bool premultiply,
+                        vector<ImageLevel> &levels, ThreadPool *pool)
+{
+    levels.clear();
+    if (width <= 0 || height <= 0)
+        return;
+
+    bool shrink = max_size > 0 && max(width, height) > max_size;
+    if (!shrink && !mips && !premultiply)
+    {
+        ImageLevel level;
+        level.width = width;
+        level.height = height;
+        level.rgba.assign(srgb, srgb + (size_t)width * height * 4);
+        levels.push_back(move(level));
+        return;
+    }
+
+    vector<float> linear((size_t)width * height * 4), next;
+    srgb_to_linear(srgb, linear.data(), (size_t)width * height, pool);
+    if (premultiply)
+        premultiply_alpha(linear.data(), (size_t)width * height, pool);
+
+    if (shrink)
+    {
+        double scale = (double)max_size / max(width, height);
+        int new_width = max(1, (int)lround(width * scale));
+        int new_height = max(1, (int)lround(height * scale));
+        next.resize((size_t)new_width * new_height * 4);
+        resize_image(linear.data(), width, height, next.data(), new_width, new_height, pool);
+        linear.swap(next);
+        width = new_width;
+        height = new_height;
+    }
+
+    encode_level(linear, width, height, levels, pool);
+    while (mips && (width > 1 || height > 1))
+    {
+        downsample_image(linear.data(), width, height, next, pool);
+        linear.swap(next);
+        width = max(1, width / 2);
+        height = max(1, height / 2);
+        encode_level(linear, width, height, levels, pool);
+    }
+}
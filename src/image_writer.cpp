@@ -0,0 +1,108 @@
+#include "image_writer.h"
+
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+bool write_ppm(const string &path, int width, int height, const uint8_t *rgba, bool flip_y)
+{
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file)
+    {
+        cerr << "Can't write " << path << "\n";
+        return false;
+    }
+
+    fprintf(file, "P6\n%d %d\n255\n", width, height);
+
+    vector<uint8_t> row((size_t)width * 3);
+    bool ok = true;
+    for (int y = 0; y < height && ok; y++)
+    {
+        int source_row = flip_y ? height - 1 - y : y;
+        const uint8_t *src = rgba + (size_t)source_row * width * 4;
+        for (int x = 0; x < width; x++)
+        {
+            row[x * 3 + 0] = src[x * 4 + 0];
+            row[x * 3 + 1] = src[x * 4 + 1];
+            row[x * 3 + 2] = src[x * 4 + 2];
+        }
+        ok = fwrite(row.data(), 1, row.size(), file) == row.size();
+    }
+
+    ok = (fclose(file) == 0) && ok;
+    if (!ok)
+        cerr << "Can't write " << path << "\n";
+    return ok;
+}
+
+// ال header: P6 W H MAX و بينهم مسافات او تعليقات (# لآخر السطر)
+static bool read_ppm_number(FILE *file, int &value)
+{
+    int c = fgetc(file);
+    while (c == '#' || c == ' ' || c == '\t' || c == '\n' || c == '\r')
+    {
+        if (c == '#')
+        {
+            while (c != '\n' && c != EOF)
+                c = fgetc(file);
+        }
+        c = fgetc(file);
+    }
+
+    value = 0;
+    if (c < '0' || c > '9')
+        return false;
+    while (c >= '0' && c <= '9')
+    {
+        value = value * 10 + (c - '0');
+        if (value > (1 << 16))
+            return false;
+        c = fgetc(file);
+    }
+    // مسافة واحدة بس بعد آخر رقم و بعدها البيانات علي طول
+    return c != EOF;
+}
+
+bool read_ppm(const string &path, int &width, int &height, vector<uint8_t> &rgba)
+{
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file)
+    {
+        cerr << "Can't open " << path << "\n";
+        return false;
+    }
+
+    int max_value = 0;
+    bool ok = fgetc(file) == 'P' && fgetc(file) == '6' && read_ppm_number(file, width) &&
+              read_ppm_number(file, height) && read_ppm_number(file, max_value) && width > 0 && height > 0 &&
+              max_value == 255;
+    if (!ok)
+    {
+        cerr << path << ": not an 8 bit binary PPM (P6)\n";
+        fclose(file);
+        return false;
+    }
+
+    rgba.resize((size_t)width * height * 4);
+    vector<uint8_t> row((size_t)width * 3);
+    for (int y = 0; y < height && ok; y++)
+    {
+        ok = fread(row.data(), 1, row.size(), file) == row.size();
+        uint8_t *dst = rgba.data() + (size_t)y * width * 4;
+        for (int x = 0; x < width && ok; x++)
+        {
+            dst[x * 4 + 0] = row[x * 3 + 0];
+            dst[x * 4 + 1] = row[x * 3 + 1];
+            dst[x * 4 + 2] = row[x * 3 + 2];
+            dst[x * 4 + 3] = 255;
+        }
+    }
+    fclose(file);
+
+    if (!ok)
+        cerr << path << ": truncated PPM\n";
+    return ok;
+}
@@ -0,0 +1,174 @@
+#include "instanced_renderer.h"
+
+#include "gl_state_cache.h"
+
+#include <cmath>
+#include <cstddef>
+
+using namespace std;
+
+static uint8_t to_unorm8(float value)
+{
+    if (!(value > 0.0f))
+        return 0;
+    if (value >= 1.0f)
+        return 255;
+    return (uint8_t)lrintf(value * 255.0f);
+}
+
+FlagInstance make_flag_instance(const Flag &flag, float x, float y, float scale)
+{
+    FlagInstance instance = {x, y, scale, scale, {}};
+    for (size_t i = 0; i < 3 && i < flag.stripes.size(); i++)
+    {
+        const FlagStripe &stripe = flag.stripes[i];
+        instance.palette[i][0] = to_unorm8(stripe.r);
+        instance.palette[i][1] = to_unorm8(stripe.g);
+        instance.palette[i][2] = to_unorm8(stripe.b);
+        instance.palette[i][3] = 255;
+    }
+    return instance;
+}
+
+InstancedFlagRenderer::InstancedFlagRenderer()
+    : draw_calls(0)
+{
+}
+
+InstancedFlagRenderer::~InstancedFlagRenderer()
+{
+    destroy();
+}
+
+bool InstancedFlagRenderer::init(const Flag &shape, VertexFormat format)
+{
+    destroy();
+
+    // لون كل نقطة في ال mesh الاساسي هو "انهي شريط": (1,0,0) او (0,1,0) او (0,0,1)
+    // و ال shader بيضربه في الوان ال instance
+    MeshBuilder builder;
+    float half_width = shape.width;
+    for (size_t i = 0; i < shape.stripes.size() && i < 3; i++)
+    {
+        const FlagStripe &stripe = shape.stripes[i];
+        builder.addQuad(-half_width, stripe.bottom, half_width, stripe.top,
+                        i == 0 ? 1.0f : 0.0f, i == 1 ? 1.0f : 0.0f, i == 2 ? 1.0f : 0.0f);
+    }
+
+    if (!base_mesh.upload(builder, format))
+        return false;
+
+    if (!instance_stream.init(GL_ARRAY_BUFFER, 1024 * sizeof(FlagInstance)))
+        return false;
+
+    // بنضيف بيانات ال instances علي نفس ال VAO بتاع ال mesh
+    base_mesh.bind();
+    GLStateCache::shared().bindBuffer(GL_ARRAY_BUFFER, instance_stream.id());
+    pointInstanceAttributes(0);
+
+    for (GLuint i = 2; i < 6; i++)
+    {
+        glEnableVertexAttribArray(i);
+        // divisor = 1 يعني القيمة بتتغير مرة لكل instance مش لكل نقطة
+        glVertexAttribDivisor(i, 1);
+    }
+
+    GLStateCache::shared().bindVertexArray(0);
+    GLStateCache::shared().bindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return true;
+}
+
+void InstancedFlagRenderer::pointInstanceAttributes(size_t first_instance)
+{
+    // location 2: المكان + ال scale، و 3..5: الوان الشرايط
+    GLsizei stride = sizeof(FlagInstance);
+    size_t base = first_instance * sizeof(FlagInstance);
+
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, (void *)(base + offsetof(FlagInstance, x)));
+    for (GLuint i = 0; i < 3; i++)
+    {
+        glVertexAttribPointer(3 + i, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+                              (void *)(base + offsetof(FlagInstance, palette) + i * 4));
+    }
+}
+
+void InstancedFlagRenderer::destroy()
+{
+    base_mesh.destroy();
+    instance_stream.destroy();
+}
+
+bool InstancedFlagRenderer::upload(const FlagInstance *instances, size_t count, size_t &first_instance)
+{
+    // بنكتب علي مضاعفات حجم ال instance فمكانها في ال buffer = رقم instance
+    size_t offset = 0;
+    if (!instance_stream.write(instances, count * sizeof(FlagInstance), sizeof(FlagInstance), offset))
+        return false;
+
+    first_instance = offset / sizeof(FlagInstance);
+    return true;
+}
+
+void InstancedFlagRenderer::draw(const FlagInstance *instances, size_t count)
+{
+    draw_calls = 0;
+    size_t first_instance = 0;
+    if (count == 0 || !upload(instances, count, first_instance))
+        return;
+
+    base_mesh.bind();
+    GLStateCache::shared().bindBuffer(GL_ARRAY_BUFFER, instance_stream.id());
+    pointInstanceAttributes(first_instance);
+    GLStateCache::shared().bindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glDrawElementsInstanced(GL_TRIANGLES, base_mesh.indexCount(), base_mesh.indexType(), (void *)0, (GLsizei)count);
+    draw_calls = 1;
+
+    instance_stream.endFrame();
+}
+
+void InstancedFlagRenderer::draw(DrawList &list, const DrawPass &pass, const FlagInstance *instances, size_t count)
+{
+    draw_calls = 0;
+    size_t first_instance = 0;
+    if (count == 0 || !upload(instances, count, first_instance))
+        return;
+
+    base_mesh.bind();
+    GLStateCache::shared().bindBuffer(GL_ARRAY_BUFFER, instance_stream.id());
+    pointInstanceAttributes(first_instance);
+    GLStateCache::shared().bindBuffer(GL_ARRAY_BUFFER, 0);
+
+    list.pushElements(pass, base_mesh.vao(), base_mesh.indexCount(), base_mesh.indexType(), 0, 0, (GLsizei)count);
+    draw_calls = 1;
+}
+
+void InstancedFlagRenderer::endFrame()
+{
+    instance_stream.endFrame();
+}
+
+void InstancedFlagRenderer::drawOnePerFlag(const FlagInstance *instances, size_t count)
+{
+    draw_calls = 0;
+    size_t first_instance = 0;
+    if (count == 0 || !upload(instances, count, first_instance))
+        return;
+
+    base_mesh.bind();
+    GLStateCache::shared().bindBuffer(GL_ARRAY_BUFFER, instance_stream.id());
+
+    // من غير base instance (GL 4.2) لازم نغير ال pointers قبل كل draw
+    for (size_t i = 0; i < count; i++)
+    {
+        pointInstanceAttributes(first_instance + i);
+        glDrawElementsInstanced(GL_TRIANGLES, base_mesh.indexCount(), base_mesh.indexType(), (void *)0, 1);
+    }
+    draw_calls = count;
+
+    GLStateCache::shared().bindVertexArray(0);
+    GLStateCache::shared().bindBuffer(GL_ARRAY_BUFFER, 0);
+
+    instance_stream.endFrame();
+}
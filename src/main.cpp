@@ -1,8 +1,37 @@
 // اول حاجة نضيف المكتبات اللي عندنا
 
 #include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <filesystem>
 #include <glad/glad.h>
-#include <GLFW/glfw3.h>
+
+#include "asset_loader.h"
+#include "asset_pack.h"
+#include "async_readback.h"
+#include "batch_renderer.h"
+#include "flag.h"
+#include "flag_library.h"
+#include "frame_writer.h"
+#include "frame_profiler.h"
+#include "frame_scheduler.h"
+#include "framebuffer.h"
+#include "gl_context.h"
+#include "gl_state_cache.h"
+#include "gpu_pool.h"
+#include "instanced_renderer.h"
+#include "mesh.h"
+#include "render_queue.h"
+#include "shader.h"
+#include "shader_builder.h"
+#include "shader_reloader.h"
+#include "startup_trace.h"
+#include "texture_atlas.h"
+#include "thread_pool.h"
 
 
 using namespace std;
@@ -18,28 +47,36 @@ using namespace std;
         هوا كود يطبق علي كل pixel او fragment
 */
 
-// ده المسئول عن معالج الاحداثيات
-const char *vertex_shader_source_code = R"(
+// ال shader الاساسي بقي في shaders/basic.vert و shaders/basic.frag
+// و بيتحمل من هناك (و بيتعمله reload لو اتعدل و البرنامج شغال)
+#ifndef SHADER_DIR
+#define SHADER_DIR "shaders"
+#endif
+
+// الاعلام (ملفات .flag) بتتترجم لـ blob واحد في flag_cache و بيتحمل بـ mmap
+#ifndef FLAG_DIR
+#define FLAG_DIR "assets/flags"
+#endif
+
+// ده shader بسيط جدا بنستخدمه لحد ما ال shader الاساسي يخلص compile
+// بيرسم كل حاجة بلون رمادي فاتح
+const char *fallback_vertex_shader_source_code = R"(
 #version 330 core
 layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aColor;
-out vec3 vColor;
 
 void main()
 {
     gl_Position = vec4(aPos, 1.0);
-    vColor = aColor;
 }
 )";
 
-const char *fragment_shader_source_code = R"(
+const char *fallback_fragment_shader_source_code = R"(
 #version 330 core
 out vec4 FragColor;
-in vec3 vColor;
 
 void main()
 {
-    FragColor = vec4(vColor, 1.0);
+    FragColor = vec4(0.6, 0.6, 0.6, 1.0);
 }
 )";
 
@@ -48,73 +85,380 @@ const int DWIDTH = 800;
 const int DHEIGHT = 600;
 
 
-int main(void)
+// طرق الرسم المتاحة
+//     single:    علم واحد ك mesh ثابت
+//     batched:   كل الاعلام في vertex stream واحد (BatchRenderer)
+//     instanced: mesh واحد + بيانات لكل علم (InstancedFlagRenderer)
+enum class DrawMode
+{
+    Single,
+    Batched,
+    Instanced,
+};
+
+
+int main(int argc, char **argv)
 {
+    // اول حاجة عشان وقت ال startup يتحسب من اول main
+    StartupTrace &startup = StartupTrace::shared();
+
     // لو هنكبر المشروع زي ما خططنا مفروض هنا نبدأ نعرض لستة للمستخدم و نهندل المدخلات الخاصة بيه
     // منها تحديد حجم الويندو و تحديد اسم العلم المستخدم
     // هل عايز يرسم اكتر من علم
+    //     --flags N                       عدد الاعلام
+    //     --mode single|batched|instanced طريقة الرسم
+    //     --headless                      من غير نافذة، الرسم في FBO
+    //     --frames N                      يقفل بعد N فريم (0 = لحد ما النافذة تتقفل)
+    //     --output DIR                    يحفظ كل فريم صورة PPM في DIR
+    //     --sync-readback                 glReadPixels عادية بدل ال PBOs (للمقارنة)
+    //     --stats PATH                    يطبع توقيت ال frames و يصدره CSV او JSON (حسب الامتداد)
+    //     --threads N                     عدد ال threads اللي بتجهز المشهد (0 = عدد ال cores)
+    //     --swap-interval N               1 = vsync (الافتراضي)، 0 = من غير انتظار الشاشة
+    //     --fps-limit F                   اقصي عدد frames في الثانية (0 = من غير limit)
+    //     --tick-rate HZ                  عدد خطوات ال update في الثانية (60)
+    //     --animate                       الاعلام بتتحرك (batched و instanced)
+    //     --shaders DIR                   مكان basic.vert و basic.frag
+    //     --no-watch                      من غير reload لما ملفات ال shaders تتعدل
+    //     --shader-fail-fast              كل مرحلة build بتتوقت لوحدها و اول غلط (حتي في reload) بيقفل البرنامج
+    //     --startup-trace PATH            مراحل ال startup لحد اول frame ك Chrome trace JSON
+    //     --flag NAME                     العلم اللي يترسم في ال single mode (gabon)
+    //     --flag-dir DIR                  مكان ملفات .flag
+    //     --assets PACK                   asset pack (tools/assetpack): العلم من ال pack و الباقي بيتحمل في الخلفية
+    //     --emblems DIR|FILE.atlas        شعارات فوق الاعلام من TextureAtlas (batched بس)
+    //                                     directory فيه صور .ppm بيترص وقت التشغيل، و .atlas من tools/atlaspack
+    size_t flag_count = 1;
+    DrawMode draw_mode = DrawMode::Single;
+    bool draw_mode_set = false;
+    bool headless = false;
+    size_t max_frames = 0;
+    string output_dir;
+    bool sync_readback = false;
+    string stats_path;
+    size_t thread_count = 0;
+    int swap_interval = 1;
+    double fps_limit = 0.0;
+    double tick_rate = 60.0;
+    bool animate = false;
+    string shaders_dir = SHADER_DIR;
+    bool watch_shaders = true;
+    bool shader_fail_fast = false;
+    string startup_trace_path;
+    string flag_name = "gabon";
+    string flag_dir = FLAG_DIR;
+    string asset_pack_path;
+    string emblems_path;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--flags" && i + 1 < argc)
+        {
+            flag_count = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--mode" && i + 1 < argc)
+        {
+            string mode = argv[++i];
+            if (mode == "single")
+                draw_mode = DrawMode::Single;
+            else if (mode == "batched")
+                draw_mode = DrawMode::Batched;
+            else if (mode == "instanced")
+                draw_mode = DrawMode::Instanced;
+            else
+            {
+                cerr << "Unknown draw mode: " << mode << "\n";
+                return -1;
+            }
+            draw_mode_set = true;
+        }
+        else if (arg == "--headless")
+        {
+            headless = true;
+        }
+        else if (arg == "--frames" && i + 1 < argc)
+        {
+            max_frames = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--output" && i + 1 < argc)
+        {
+            output_dir = argv[++i];
+        }
+        else if (arg == "--sync-readback")
+        {
+            sync_readback = true;
+        }
+        else if (arg == "--stats" && i + 1 < argc)
+        {
+            stats_path = argv[++i];
+        }
+        else if (arg == "--threads" && i + 1 < argc)
+        {
+            thread_count = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--swap-interval" && i + 1 < argc)
+        {
+            swap_interval = atoi(argv[++i]);
+        }
+        else if (arg == "--fps-limit" && i + 1 < argc)
+        {
+            fps_limit = atof(argv[++i]);
+        }
+        else if (arg == "--tick-rate" && i + 1 < argc)
+        {
+            tick_rate = atof(argv[++i]);
+        }
+        else if (arg == "--animate")
+        {
+            animate = true;
+        }
+        else if (arg == "--shaders" && i + 1 < argc)
+        {
+            shaders_dir = argv[++i];
+        }
+        else if (arg == "--no-watch")
+        {
+            watch_shaders = false;
+        }
+        else if (arg == "--shader-fail-fast")
+        {
+            shader_fail_fast = true;
+        }
+        else if (arg == "--startup-trace" && i + 1 < argc)
+        {
+            startup_trace_path = argv[++i];
+        }
+        else if (arg == "--flag" && i + 1 < argc)
+        {
+            flag_name = argv[++i];
+        }
+        else if (arg == "--flag-dir" && i + 1 < argc)
+        {
+            flag_dir = argv[++i];
+        }
+        else if (arg == "--assets" && i + 1 < argc)
+        {
+            asset_pack_path = argv[++i];
+        }
+        else if (arg == "--emblems" && i + 1 < argc)
+        {
+            emblems_path = argv[++i];
+        }
+        else
+        {
+            cerr << "Usage: " << argv[0] << " [--flags N] [--mode single|batched|instanced]"
+                 << " [--headless] [--frames N] [--output DIR] [--sync-readback] [--stats PATH] [--threads N]"
+                 << " [--swap-interval N] [--fps-limit F] [--tick-rate HZ] [--animate]"
+                 << " [--shaders DIR] [--no-watch] [--shader-fail-fast] [--startup-trace PATH]"
+                 << " [--flag NAME] [--flag-dir DIR] [--assets PACK] [--emblems DIR|FILE.atlas]\n";
+            return -1;
+        }
+    }
 
+    // الشعارات بتترسم في ال batched بس (ال instanced mesh مفيهوش غير الشرايط)
+    bool use_emblems = !emblems_path.empty();
+    if (use_emblems && !draw_mode_set)
+        draw_mode = DrawMode::Batched;
+    if (use_emblems && draw_mode != DrawMode::Batched)
+    {
+        cerr << "--emblems needs --mode batched\n";
+        return -1;
+    }
 
+    // اكتر من علم و مفيش mode متحدد: نستخدم ال instanced
+    if (flag_count > 1 && draw_mode == DrawMode::Single)
+        draw_mode = DrawMode::Instanced;
 
+    // في ال headless مفيش حد يقفل النافذة، فلو مفيش عدد فريمات نرسم فريم واحد
+    if (headless && max_frames == 0)
+        max_frames = 1;
 
-
-    // هنا بنبدأ نحمل المتكبة و نعمل اعداد للبيئة و بنعمل تشك
-    // هل تم تحميلها بشكل صحيح نكمل او لأ
-    if (!glfwInit())
+    if (!output_dir.empty())
     {
-        cerr << "Failed to Initialize GLFW \n";
-        return -1;
+        error_code ec;
+        filesystem::create_directories(output_dir, ec);
+        if (ec)
+        {
+            cerr << "Can't create output directory " << output_dir << ": " << ec.message() << "\n";
+            return -1;
+        }
     }
 
 
-    // هنا بقي بنبدأ نعمل اعداد لاصدار المكتبة اللي هنستخدمها و للبروفايل اللي هنستخدمه
-    // Default version: 3.3, Default profile: coreProfile
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    // ال workers بيبدأوا الاول عشان يبقوا جاهزين و احنا بنعمل ال context
+    // (بدل ما وقت بداية ال threads يتحسب علي اول frame)
+    size_t pool_phase = startup.begin("thread pool");
+    ThreadPool::setSharedThreads(thread_count);
+    ThreadPool &thread_pool = ThreadPool::shared();
+    startup.end(pool_phase);
 
 
-    // هنا هنبدأ ننشئ الويندو او النافذة اللي هنشتغل عليها
-    GLFWwindow *window1 = glfwCreateWindow(DWIDTH, DHEIGHT, "Project Name", nullptr, nullptr);
+    // الحاجات اللي مش محتاجة GL بتشتغل علي ال pool و thread ال GL بيعمل ال context في نفس الوقت:
+    // قراية ملفات ال shaders (و ال includes) و تجهيز نقط الاعلام
+    // ال tasks دي ممنوع تنادي OpenGL، و كل اللي بيستخدم نتايجها بيستني startup_tasks.wait() الاول
 
-    // هنعمل تست نشوف هل تم انشاء النافذة بواسطة البرنامج
-    if (!window1)
-    {
-        // بنطبع رسالة
-        cerr << "Failed to Create a window\n";
+    // ال shader الاساسي من الملفات: بنبعته و نكمل شغل، و ال render loop هو اللي بيسأل عليه
+    // و في وضع النافذة بنراقب الملفات و نبنيه تاني لو اتعدلت
+    // (في ال headless لأ، عشان ال frames تطلع من نفس ال shader كلها، و قبل اول frame بنستناه يخلص)
+    ShaderReloader shader_reloader;
+    bool shaders_loaded = false;
 
-        // بنعمل تدمير للمكتبة في الميموري
-        glfwTerminate();
 
-        return -1;
-    }
+    // USING AI
+    // --- Geometry Data (The Flag) ---
+    // علم الغابون: 3 مستطيلات أفقية
+    // الالوان بقت جوه make_gabon_flag
+    // (ال single mode بيرسم من assets/flags/gabon.flag، و ده لل batched و ال instanced)
 
 
-    // بعد كده هنعمل اي لو عندنا اكتر من نافذة او ويندو لازم نختار منهم واحدة نشتغل عليها
-    // عن طريق الخطوة دي بنحدد النافذة اللي هنشتغل عليها في الوقت الحالي
-    glfwMakeContextCurrent(window1);
+    float width = 0.8f; // عرض العلم
+    float height_top = 0.75f; // حدود المستطيل العلوي
+    float height_middle1 = 0.25f; // الحد الفاصل الأول
+    float height_middle2 = -0.25f; // الحد الفاصل الثاني
+    float height_bottom = -0.75f; // حدود المستطيل السفلي
 
+    Flag gabon;
 
+    // ال single mode: كل الاعلام في blob واحد (mmap)، و بيترفع mesh واحد و نرسم العلم المطلوب منه
+    // النقط في ال blob متعملها weld و بال format بتاع ال VBO، فال upload مفيهوش اي تحويل
+    FlagLibrary flag_library;
+    bool flags_loaded = true;
 
+    // مع --assets العلم بيجي من ال asset pack بدل ال flag library
+    // ال pack بيتفتح (mmap) علي ال pool و ال AssetLoader بيرفع منه بعد ما ال context يبقي جاهز
+    AssetPack asset_pack;
+    AssetLoader asset_loader;
+    bool pack_opened = true;
+    bool use_asset_pack = !asset_pack_path.empty();
 
-    // هنعمل استدعاء لوظائف المكتبةة و تحميلها في الميموري عن طريق ال glad
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    // الشعارات: كل الصور في TextureAtlas واحد (بيترص علي ال pool و بيترفع بعد ال context)
+    // و نسخة من الغابون لكل صورة، العلم رقم i بياخد النسخة i % عددهم
+    TextureAtlas emblem_atlas;
+    bool emblems_loaded = true;
+    vector<Flag> emblem_flags;
+
+    // لو اكتر من علم بنوزعهم في grid علي الشاشة
+    vector<FlagPlacement> placements;
+    vector<FlagInstance> instances;
+
+    TaskGroup startup_tasks(thread_pool);
+    startup_tasks.run([&]
     {
-        cerr << "Can't Load functions using glad\n";
-        glfwDestroyWindow(window1);
-        glfwTerminate();
-        return -1;
+        StartupTrace::Scope phase("load shader sources");
+        shaders_loaded = shader_reloader.load(shaders_dir + "/basic.vert", shaders_dir + "/basic.frag",
+                                              watch_shaders && !headless);
+    });
+    if (use_asset_pack)
+    {
+        startup_tasks.run([&]
+        {
+            StartupTrace::Scope phase("open asset pack");
+            pack_opened = asset_pack.open(asset_pack_path);
+        });
+    }
+    else if (draw_mode == DrawMode::Single)
+    {
+        startup_tasks.run([&]
+        {
+            StartupTrace::Scope phase("load flag library");
+            flags_loaded = flag_library.load(flag_dir, "flag_cache/flags.bin");
+        });
+    }
+    if (use_emblems)
+    {
+        startup_tasks.run([&]
+        {
+            StartupTrace::Scope phase("pack emblem atlas");
+            error_code ec;
+            if (filesystem::is_directory(emblems_path, ec))
+                emblems_loaded = emblem_atlas.packDirectory(emblems_path);
+            else
+                emblems_loaded = emblem_atlas.read(emblems_path);
+        });
     }
+    startup_tasks.run([&]
+    {
+        StartupTrace::Scope phase("build flags");
+        gabon = make_gabon_flag(width, height_top, height_middle1, height_middle2, height_bottom);
+        placements = make_flag_grid(gabon, flag_count);
+
+        if (draw_mode == DrawMode::Instanced)
+        {
+            instances.reserve(placements.size());
+            for (const FlagPlacement &placement : placements)
+                instances.push_back(make_flag_instance(gabon, placement.x, placement.y, placement.scale));
+        }
+    });
+
+
+    // انشاء النافذة (او ال headless context) و تحميل ال glad بقي جوه GLContext
+    GLContextOptions context_options;
+    context_options.width = DWIDTH;
+    context_options.height = DHEIGHT;
+    context_options.title = "Project Name";
+    context_options.headless = headless;
+    context_options.swap_interval = swap_interval;
+
+    GLContext context;
+    size_t context_phase = startup.begin("create context");
+    bool context_created = context.create(context_options);
+    startup.end(context_phase);
+    if (!context_created)
+        return -1;
 
+    // كل اللي فيه GL objects متعرف هنا عشان teardown يمسحه و ال context لسه موجود
+    // (ال destructors بعد context.destroy() مش هيلاقوا context)، و كل خروج بعد كده عادي او فشل بيعدي منه
+    Framebuffer offscreen;
+    AsyncReadback readback;
+    Shader FallbackProgram;
+    Mesh flag_mesh;
+    BatchRenderer batch;
+    InstancedFlagRenderer instanced;
+    auto teardown = [&]
+    {
+        readback.destroy();
+        flag_mesh.destroy();
+        asset_loader.destroy();
+        batch.destroy();
+        emblem_atlas.destroy();
+        instanced.destroy();
+        shader_reloader.destroy();
+        FallbackProgram.destroy();
+        offscreen.destroy();
+        context.destroy();
+    };
 
+    // في ال headless بنرسم في FBO بنفس مقاس النافذة و بنقرا منه الصورة
+    // و لو فيه --output في وضع النافذة بنرسم في FBO برضه و بننسخه للشاشة
+    size_t targets_phase = startup.begin("render targets");
+    bool use_offscreen = context.headless() || !output_dir.empty();
+    if (use_offscreen && !offscreen.create(DWIDTH, DHEIGHT))
+    {
+        teardown();
+        return -1;
+    }
 
+    // قراية ال frames من غير ما نوقف ال loop: PBOs + fences
+    // و الكتابة علي الديسك في thread تاني
+    FrameWriter frame_writer;
+    ReadbackFrame exported_frame;
+    bool export_frames = !output_dir.empty();
+    if (export_frames)
+    {
+        if (!sync_readback && !readback.init(DWIDTH, DHEIGHT))
+        {
+            teardown();
+            return -1;
+        }
+        frame_writer.start(output_dir);
+    }
+    startup.end(targets_phase);
 
 
     // النافذة الواحدة ممكن تتقسم لاكتر من viewport
     //جزء نعرض فيه رسوماتنا 
     // بس في حالتنا هنعتبر ان كل الويندو النافذة بتاعتنا
 
-    glViewport(
+    GLStateCache::shared().viewport(
         // نقطة البداية من اقصي اليسار في الاسفل
         0,
         0, 
@@ -125,165 +469,378 @@ int main(void)
 
 
     // نبدأ انشاء البرنامج الخاص بال shaders
-        // ننشئ ال vert shader
-        // نربطة بال source code
-        // compile vertex shader
-        // نعمل تشك هل كل حاجة تم ترجمتها بنجاح
-
-    // هنا انشئنا ال vertex shader
-    GLuint vertex_shader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex_shader, 1, &vertex_shader_source_code, nullptr); // link source code above to this object
-    glCompileShader(vertex_shader);
-
-    GLint success;
-    glGetShaderiv(vertex_shader, GL_COMPILE_STATUS, &success);
-    if (!success)
+    // كل الشغل بتاع ال compile و ال link بقي جوه ال Shader class
+    // و بنحفظ ال program المترجم في ال cache عشان التشغيلة الجاية تبقي اسرع
+    Shader::setCacheDirectory("shader_cache");
+    Shader::setFailFast(shader_fail_fast);
+    ShaderBuilder::enableParallelCompile();
+
+    // ال fallback صغير فبنستناه، ومن غيره مش هيبقي عندنا حاجة نرسم بيها
+    size_t fallback_phase = startup.begin("fallback shader");
+    bool fallback_built = FallbackProgram.build(fallback_vertex_shader_source_code, fallback_fragment_shader_source_code);
+    startup.end(fallback_phase);
+    if (!fallback_built)
     {
-        char error_message[512];
-        glGetShaderInfoLog(vertex_shader, 512, nullptr, error_message);
-        cerr << "Vertex Shader Compilation failed:\n" << error_message << endl;
+        cerr << "Failed to build the fallback shader program\n";
+        teardown();
+        return -1;
     }
 
-    // هننشئ ال fragment shader
-    GLuint fragment_shader = glCreateShader(GL_FRAGMENT_SHADER);
+    // من هنا محتاجين ال shaders و الاعلام، فبنستني ال tasks (و بنساعد لو لسه فيه شغل)
+    size_t wait_phase = startup.begin("wait for startup tasks");
+    startup_tasks.wait();
+    startup.end(wait_phase);
 
-    glShaderSource(fragment_shader, 1, &fragment_shader_source_code, nullptr); // link source code above to this object
-    glCompileShader(fragment_shader);// بنترجم ال fragment shader
-
-    glGetShaderiv(fragment_shader, GL_COMPILE_STATUS, &success);
-    if (!success)
+    if (!shaders_loaded)
     {
-        // هنا عملنا مكان نخزن فيه رسالة الخطا اللي هترجعها المكتبة
-        char error_message[512];
-
-        // بنقراء رسالة الخطاء دي و نخزنها عشان نطبعها
-        glGetShaderInfoLog(fragment_shader, 512, nullptr, error_message);
-        cerr << "Vertex Shader Compilation failed:\n" << error_message << endl;
+        cerr << "Failed to load the shaders from " << shaders_dir << "\n";
+        teardown();
+        return -1;
     }
 
+    // شكل النقطة علي ال GPU: X, Y float + لون RGBA بايت = 12 byte بدل 24
+    // (Z دايما صفر في الاعلام فمش محتاجين نرفعها)
+    size_t upload_phase = startup.begin("upload meshes");
+    int flag_index = -1;
+    const Mesh *pack_flag_mesh = nullptr;
+    if (use_asset_pack)
+    {
+        // العلم اللي هيترسم الاول و بنستناه، و باقي ال pack بيكمل تحميل و احنا بنرسم
+        bool pack_ready = pack_opened && asset_loader.init(asset_pack);
+        if (pack_ready && draw_mode == DrawMode::Single)
+        {
+            if (!asset_loader.request(flag_name, 1))
+                cerr << "No mesh named " << flag_name << " in " << asset_pack_path << "\n";
+            else if (asset_loader.wait(flag_name))
+                pack_flag_mesh = asset_loader.mesh(flag_name);
+            pack_ready = pack_flag_mesh != nullptr;
+        }
+        asset_loader.requestAll();
+
+        if (!pack_ready)
+        {
+            cerr << "Failed to load the asset pack " << asset_pack_path << "\n";
+            teardown();
+            return -1;
+        }
+    }
+    else if (draw_mode == DrawMode::Single)
+    {
+        flag_index = flags_loaded ? flag_library.find(flag_name) : -1;
+        if (flags_loaded && flag_index < 0)
+            cerr << "No flag named " << flag_name << " in " << flag_dir << "\n";
+
+        if (flag_index < 0 || !flag_library.upload(flag_mesh))
+        {
+            cerr << "Failed to upload the flag mesh\n";
+            teardown();
+            return -1;
+        }
+    }
 
-    // انشئ البرنامج عشان نبدأ نشغله
-    // نجمع البرامج الصغيرة و نربطها بالبرنامج الاساسى
-    GLuint ShaderProgram = glCreateProgram();
-    glAttachShader(ShaderProgram, vertex_shader);
-    glAttachShader(ShaderProgram, fragment_shader);
-    glLinkProgram(ShaderProgram);
-
+    // الشعار في نص العلم بنفس نسبة الصورة، و اطول ضلع فيه نص ارتفاع العلم
+    if (use_emblems)
+    {
+        for (const AtlasRegion &region : emblem_atlas.regions())
+        {
+            float extent = 0.35f / (float)max(region.width, region.height);
+            float half_width = region.width * extent;
+            float half_height = region.height * extent;
+
+            Flag flag = gabon;
+            flag.emblems.push_back({region.name, -half_width, -half_height, half_width, half_height});
+            emblem_atlas.rewriteUVs(flag);
+            emblem_flags.push_back(flag);
+        }
+
+        if (!emblems_loaded || !emblem_atlas.upload())
+        {
+            cerr << "Failed to load the emblem atlas " << emblems_path << "\n";
+            teardown();
+            return -1;
+        }
+    }
 
-    // دلوقتي احنا مش محتاجين الاجزاء الصغيرة ال shaders 
-    // بقي عندنا حاجة اكبر بتحتوي علي الاجزاء الصغيرة و هتشغلها
-    glDeleteShader(vertex_shader);
-    glDeleteShader(fragment_shader);
+    // في ال batched كل thread بيجهز نقط جزء من الاعلام في QuadBatch لوحده
+    // و thread ال GL بيرفعهم مرة واحدة و يسجل ال draws بترتيب الاجزاء
+    vector<QuadBatch> scene_batches;
 
+    bool renderer_ready = true;
+    if (draw_mode == DrawMode::Batched)
+    {
+        renderer_ready = batch.init(65536, use_emblems ? VertexFormat::Pos2F_Col4U8_Tex3F : VertexFormat::Pos2F_Col4U8);
+
+        // جزء لكل thread، بس مش اقل من 1024 علم في الجزء (كل جزء = draw call)
+        size_t parts = (placements.size() + 1023) / 1024;
+        if (parts > thread_pool.concurrency())
+            parts = thread_pool.concurrency();
+        scene_batches.resize(parts > 0 ? parts : 1);
+        for (QuadBatch &scene_batch : scene_batches)
+            batch.initBatch(scene_batch);
+    }
+    else if (draw_mode == DrawMode::Instanced)
+    {
+        renderer_ready = instanced.init(gabon);
+    }
+    startup.end(upload_phase);
 
-    // USING AI
-    // --- Geometry Data (The Flag) ---
-    // علم الغابون: 3 مستطيلات أفقية
-    // الترتيب: X, Y, Z (Position) | R, G, B (Color)
-    
-    // الألوان التقريبية:
-    // الأخضر: 0.0, 0.6, 0.3
-    // الأصفر: 1.0, 0.8, 0.0
-    // الأزرق: 0.0, 0.3, 0.7
+    if (!renderer_ready)
+    {
+        cerr << "Failed to create the flag renderer\n";
+        teardown();
+        return -1;
+    }
 
+    // كل ال draws بتتسجل في ال queue و بتترسم مرة واحدة مترتبة في آخر ال frame
+    RenderQueue render_queue;
+
+    // ال instanced mode محتاج نسخة من ال shader بـ INSTANCED
+    // ال permutation بتتبني اول مرة تتطلب بس، فال modes التانية مبتعملهاش compile
+    ShaderDefines shader_defines;
+    if (draw_mode == DrawMode::Instanced)
+        shader_defines.push_back({"INSTANCED", ""});
+    if (use_emblems)
+        shader_defines.push_back({"TEXTURED", ""});
+    size_t shader_phase = startup.begin("submit shaders");
+    shader_reloader.prepare(shader_defines);
+    startup.end(shader_phase);
+
+    // ال frames اللي بتتحفظ (headless او --output) لازم تطلع هي هي كل مرة، فمتترسمش بال fallback
+    // لو ال shader لسه بيتبني (parallel compile و cache فاضي) بنستناه قبل اول frame، و لو فشل منرسمش خالص
+    // (ال loop مبيبدأش، و ال teardown اللي تحت هو نفسه)
+    int exit_code = 0;
+    if (use_offscreen)
+    {
+        size_t wait_phase = startup.begin("wait for shaders");
+        bool shader_ready = shader_reloader.wait(shader_defines) != nullptr;
+        startup.end(wait_phase);
+        if (!shader_ready)
+        {
+            cerr << "Failed to build the shader program\n";
+            exit_code = -1;
+            context.requestClose();
+        }
+    }
 
-    float width = 0.8f; // عرض العلم
-    float height_top = 0.75f; // حدود المستطيل العلوي
-    float height_middle1 = 0.25f; // الحد الفاصل الأول
-    float height_middle2 = -0.25f; // الحد الفاصل الثاني
-    float height_bottom = -0.75f; // حدود المستطيل السفلي
 
-    GLfloat vertices[] = {
-        // === 1. الشريط العلوي (أخضر) ===
-        // Triangle 1
-        -width, height_middle1, 0.0f,   0.0f, 0.6f, 0.3f, // BL
-         width, height_middle1, 0.0f,   0.0f, 0.6f, 0.3f, // BR
-        -width, height_top,  0.0f,   0.0f, 0.6f, 0.3f, // TL
-        // Triangle 2
-         width, height_top,  0.0f,   0.0f, 0.6f, 0.3f, // TR
-        -width, height_top,  0.0f,   0.0f, 0.6f, 0.3f, // TL
-         width, height_middle1, 0.0f,   0.0f, 0.6f, 0.3f, // BR
-
-        // === 2. الشريط الأوسط (أصفر) ===
-        // Triangle 1
-        -width, height_middle2, 0.0f,   1.0f, 0.8f, 0.0f, // BL
-         width, height_middle2, 0.0f,   1.0f, 0.8f, 0.0f, // BR
-        -width, height_middle1, 0.0f,   1.0f, 0.8f, 0.0f, // TL
-        // Triangle 2
-         width, height_middle1, 0.0f,   1.0f, 0.8f, 0.0f, // TR
-        -width, height_middle1, 0.0f,   1.0f, 0.8f, 0.0f, // TL
-         width, height_middle2, 0.0f,   1.0f, 0.8f, 0.0f, // BR
-
-        // === 3. الشريط السفلي (أزرق) ===
-        // Triangle 1
-        -width, height_bottom,  0.0f,   0.0f, 0.3f, 0.7f, // BL
-         width, height_bottom,  0.0f,   0.0f, 0.3f, 0.7f, // BR
-        -width, height_middle2, 0.0f,   0.0f, 0.3f, 0.7f, // TL
-        // Triangle 2
-         width, height_middle2, 0.0f,   0.0f, 0.3f, 0.7f, // TR
-        -width, height_middle2, 0.0f,   0.0f, 0.3f, 0.7f, // TL
-         width, height_bottom,  0.0f,   0.0f, 0.3f, 0.7f, // BR
-    };
+    // توقيت كل frame: CPU و ال swap و ال GPU لكل pass
+    // الصف لكل frame بيتحفظ بس لو هيتكتب (--stats X.csv)
+    FrameProfiler profiler;
+    profiler.init(2, !stats_path.empty() && FrameProfiler::needsHistory(stats_path));
+    size_t draw_pass = profiler.pass("draw");
+    size_t readback_pass = use_offscreen ? profiler.pass("readback") : 0;
 
-    // هنبدا نجهز الميموري الخاص بينا 
-    // VAO, VBO
-    // هننشئ المكانين
-    GLuint VAO, VBO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-
-    // هنحدد انهي VAO, VBO 
-    // هنشتغل عليه عن طريق اننا نفعله زي موضوع الويندو فوق بالظبط
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-
-    // هنبدا نملي البيانت في ال BUFFER DATA VBO
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    // Configure vertex attribute
-    GLsizei stride = 6 * sizeof(float);
-
-    glVertexAttribPointer(
-        0,                // attribute index
-        3,                // size (x,y,z)
-        GL_FLOAT,         // data type
-        GL_FALSE,         // normalize
-        stride,// stride
-        (void*)0          // offset
-    );
-    glEnableVertexAttribArray(0);
 
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+    // ال update بخطوة ثابتة منفصل عن الرسم، و ال fps مش متربط بالشاشة لو swap interval = 0
+    // في ال headless كل frame خطوة واحدة بالظبط عشان الصور تطلع هي هي كل مرة
+    FrameScheduler scheduler;
+    scheduler.setFixedStep(tick_rate > 0.0 ? 1.0 / tick_rate : 1.0 / 60.0);
+    scheduler.setFrameLimit(fps_limit);
+    scheduler.setDeterministic(context.headless());
 
-    // Point again to the start of the VBO, VAO
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    // الحركة بتتحسب من المكان الاصلي عشان الغلط ميتجمعش
+    vector<FlagPlacement> base_placements = placements;
 
 
     // هنبدأ نرسم بقا
-    while (!glfwWindowShouldClose(window1))
+    // ال startup بيخلص مع اول frame (فيه اول draw و ال compile لو لسه مخلصش)
+    size_t first_frame_phase = startup.begin("first frame");
+    scheduler.start();
+    auto loop_start = chrono::steady_clock::now();
+    size_t frame = 0;
+    while (!context.shouldClose())
     {
-        glClearColor(0.2f, 0.2f, 0.2f, 1.0f);
+        profiler.beginFrame();
+
+        scheduler.beginFrame();
+        while (scheduler.update())
+        {
+            if (!animate)
+                continue;
+
+            // كل علم بيطلع و ينزل بموجة، و كل واحد متأخر شوية عن اللي قبله
+            float time = (float)scheduler.time();
+            thread_pool.parallelFor(placements.size(), [&](size_t i)
+            {
+                const FlagPlacement &base = base_placements[i];
+                float y = base.y + 0.05f * base.scale * sinf(time * 3.0f + i * 0.35f);
+                placements[i].y = y;
+                if (i < instances.size())
+                    instances[i].y = y;
+            }, 4096);
+        }
+
+        if (use_offscreen)
+            offscreen.bind();
+
+        profiler.beginGpu(draw_pass);
+
+        GLStateCache::shared().clearColor(0.2f, 0.2f, 0.2f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
-        glUseProgram(ShaderProgram);
-        glBindVertexArray(VAO);
+        // بنسأل علي ال shader من غير ما نستني، و لو لسه بيتبني نرسم بال fallback
+        // و لو ملف اتعدل ال program الجديد بيتبدل هنا بين ال frames
+        shader_reloader.update();
+        asset_loader.update();
+        if (shader_reloader.failed() && exit_code == 0)
+        {
+            cerr << "Failed to build the shader program\n";
+            exit_code = -1;
+            context.requestClose();
+        }
+
+        const Shader *main_program = shader_reloader.program(shader_defines);
+        const Shader &program = main_program ? *main_program : FallbackProgram;
+        DrawPass pass = {0, program.ID, 0};
+
+        switch (draw_mode)
+        {
+        case DrawMode::Single:
+            if (pack_flag_mesh)
+                pack_flag_mesh->record(render_queue, pass);
+            else
+                flag_library.record(flag_mesh, render_queue, pass, flag_index);
+            break;
+
+        case DrawMode::Batched:
+            // draw call لكل جزء (الا لو الاعلام اكتر من اللي ال batch يشيله)
+            // و ال atlas متربط طول ال frame فالشعارات مبتكسرش ال batch
+            if (use_emblems)
+                emblem_atlas.bind();
+            batch.begin(render_queue, pass);
+            thread_pool.parallelFor(scene_batches.size(), [&](size_t part)
+            {
+                size_t begin = placements.size() * part / scene_batches.size();
+                size_t end = placements.size() * (part + 1) / scene_batches.size();
+                for (size_t i = begin; i < end; i++)
+                {
+                    const Flag &flag = emblem_flags.empty() ? gabon : emblem_flags[i % emblem_flags.size()];
+                    scene_batches[part].drawFlag(flag, placements[i].x, placements[i].y, placements[i].scale);
+                }
+            });
+            batch.record(scene_batches.data(), scene_batches.size());
+            batch.end();
+            break;
+
+        case DrawMode::Instanced:
+            // draw call واحد لكل الاعلام
+            instanced.draw(render_queue, pass, instances.data(), instances.size());
+            break;
+        }
+
+        render_queue.submit();
+
+        // ال streams بيتقفلوا بعد ما ال draws اتبعتت
+        if (draw_mode == DrawMode::Batched)
+            batch.endFrame();
+        else if (draw_mode == DrawMode::Instanced)
+            instanced.endFrame();
+
+        profiler.endGpu();
+
+        if (use_offscreen)
+        {
+            profiler.beginGpu(readback_pass);
+
+            if (export_frames)
+            {
+                if (sync_readback)
+                {
+                    // بتوقف لحد ما ال GPU يخلص ال frame ده
+                    offscreen.readPixels(exported_frame.pixels);
+                    exported_frame.index = frame;
+                    exported_frame.width = DWIDTH;
+                    exported_frame.height = DHEIGHT;
+                    frame_writer.push(exported_frame);
+                }
+                else
+                {
+                    // بنطلب ال frame ده و بناخد اللي خلص من ال frames اللي قبله
+                    readback.capture(offscreen, frame);
+                    while (readback.readFrame(exported_frame))
+                        frame_writer.push(exported_frame);
+                }
+            }
+
+            // في وضع النافذة بننسخ ال FBO للشاشة عشان تفضل الصورة ظاهرة
+            if (!context.headless())
+            {
+                GLStateCache::shared().bindFramebuffer(GL_READ_FRAMEBUFFER, offscreen.id());
+                GLStateCache::shared().bindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+                glBlitFramebuffer(0, 0, DWIDTH, DHEIGHT, 0, 0, DWIDTH, DHEIGHT, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+                Framebuffer::bindDefault();
+            }
+
+            profiler.endGpu();
+        }
+
+        profiler.beginSwap();
+        context.swapBuffers();
+        profiler.endSwap();
+
+        context.pollEvents();
+        profiler.endFrame();
+
+        // ال limiter برا وقت ال frame عشان الارقام تبقي شغل بس
+        scheduler.endFrame();
+
+        frame++;
+        if (frame == 1)
+            startup.end(first_frame_phase);
+        if (max_frames > 0 && frame >= max_frames)
+            context.requestClose();
+    }
 
-        // نرسم 18 نقطة (3 مستطيلات * 6 نقاط لكل مستطيل)
-        glDrawArrays(GL_TRIANGLES, 0, 18);
+    // ال frames اللي لسه في ال PBOs بنستناها و بنكتبها
+    if (export_frames)
+    {
+        while (readback.readFrame(exported_frame, true))
+            frame_writer.push(exported_frame);
+        frame_writer.stop();
+
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - loop_start).count();
+        cout << "Exported " << frame_writer.written() << " frames to " << output_dir << " in " << seconds << " s ("
+             << (seconds > 0.0 ? frame_writer.written() / seconds : 0.0) << " fps, "
+             << readback.stalls() << " readback stalls)\n";
+        if (frame_writer.failed() > 0)
+            exit_code = -1;
+    }
 
-        glfwSwapBuffers(window1);
-        glfwPollEvents();
+
+    if (!stats_path.empty())
+    {
+        profiler.finish();
+        profiler.printSummary(cout);
+        GPUResourcePool::shared().printStats(cout);
+        GLStateCache::shared().printStats(cout);
+        render_queue.printStats(cout);
+        scheduler.printStats(cout);
+        shader_reloader.printStats(cout);
+        cout << "Scene threads: " << thread_pool.concurrency() << " (" << thread_pool.steals() << " steals)\n";
+        if (flag_library.count() > 0)
+            cout << "Flag library: " << flag_library.count() << " flags, " << (flag_library.compiled() ? "compiled" : "cached")
+                 << "\n";
+        asset_loader.printStats(cout);
+        if (use_emblems)
+            cout << "Emblem atlas: " << emblem_atlas.regions().size() << " images in " << emblem_atlas.layerCount()
+                 << " layers of " << emblem_atlas.layerSize() << "x" << emblem_atlas.layerSize() << " ("
+                 << emblem_atlas.occupancy() * 100.0f << "% used)\n";
+        if (!profiler.write(stats_path))
+            exit_code = -1;
     }
-    
-    
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteProgram(ShaderProgram);
-    glfwDestroyWindow(window1);
-    glfwTerminate();
 
-    return 0;
+
+    if (!startup_trace_path.empty())
+    {
+        startup.printSummary(cout);
+        if (!startup.writeJSON(startup_trace_path))
+            exit_code = -1;
+    }
+
+
+    profiler.destroy();
+    teardown();
+
+    return exit_code;
 }
 
@@ -0,0 +1,118 @@
+#include "mapped_file.h"
+
+#include <fstream>
+#include <iostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+MappedFile::MappedFile()
+    : bytes(nullptr), length(0), is_mapped(false)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const string &path)
+{
+    close();
+
+#ifdef HAVE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        cerr << "Can't open " << path << "\n";
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0)
+    {
+        cerr << "Can't map " << path << ": empty or unreadable\n";
+        ::close(fd);
+        return false;
+    }
+
+    // ال mapping بيفضل موجود بعد ما ال fd يتقفل
+    void *address = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED)
+    {
+        cerr << "Can't map " << path << "\n";
+        return false;
+    }
+
+    bytes = (const unsigned char *)address;
+    length = (size_t)info.st_size;
+    is_mapped = true;
+    return true;
+#else
+    ifstream file(path, ios::binary | ios::ate);
+    if (!file)
+    {
+        cerr << "Can't open " << path << "\n";
+        return false;
+    }
+
+    streamsize file_size = file.tellg();
+    if (file_size <= 0)
+    {
+        cerr << "Can't map " << path << ": empty or unreadable\n";
+        return false;
+    }
+
+    fallback.resize((size_t)file_size);
+    file.seekg(0);
+    if (!file.read((char *)fallback.data(), file_size))
+    {
+        cerr << "Can't read " << path << "\n";
+        fallback.clear();
+        return false;
+    }
+
+    bytes = fallback.data();
+    length = fallback.size();
+    return true;
+#endif
+}
+
+void MappedFile::close()
+{
+#ifdef HAVE_MMAP
+    if (is_mapped && bytes)
+        munmap((void *)bytes, length);
+#endif
+    fallback.clear();
+    fallback.shrink_to_fit();
+    bytes = nullptr;
+    length = 0;
+    is_mapped = false;
+}
+
+void MappedFile::prefetch(size_t offset, size_t count) const
+{
+#ifdef HAVE_MMAP
+    if (!is_mapped || offset >= length)
+        return;
+    if (count > length - offset)
+        count = length - offset;
+
+    // madvise محتاج عنوان علي اول صفحة
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t begin = offset / page * page;
+    madvise((void *)(bytes + begin), offset + count - begin, MADV_WILLNEED);
+#else
+    (void)offset;
+    (void)count;
+#endif
+}
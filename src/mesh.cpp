@@ -0,0 +1,228 @@
+#include "mesh.h"
+
+#include "gl_state_cache.h"
+
+#include <cstring>
+
+using namespace std;
+
+size_t MeshBuilder::VertexHash::operator()(const Vertex &v) const
+{
+    // FNV-1a علي بايتات النقطة، النقط لازم تكون متطابقة بالظبط عشان تندمج
+    const unsigned char *bytes = (const unsigned char *)&v;
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < sizeof(Vertex); i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return (size_t)hash;
+}
+
+bool MeshBuilder::VertexEqual::operator()(const Vertex &a, const Vertex &b) const
+{
+    return memcmp(&a, &b, sizeof(Vertex)) == 0;
+}
+
+uint32_t MeshBuilder::weld(const Vertex &v)
+{
+    auto it = lookup.find(v);
+    if (it != lookup.end())
+        return it->second;
+
+    uint32_t index = (uint32_t)unique_vertices.size();
+    unique_vertices.push_back(v);
+    lookup.emplace(v, index);
+    return index;
+}
+
+void MeshBuilder::addTriangle(const Vertex &a, const Vertex &b, const Vertex &c)
+{
+    triangle_indices.push_back(weld(a));
+    triangle_indices.push_back(weld(b));
+    triangle_indices.push_back(weld(c));
+}
+
+void MeshBuilder::addTriangles(const Vertex *triangle_vertices, size_t count)
+{
+    for (size_t i = 0; i + 2 < count; i += 3)
+        addTriangle(triangle_vertices[i], triangle_vertices[i + 1], triangle_vertices[i + 2]);
+}
+
+void MeshBuilder::addQuad(float x0, float y0, float x1, float y1, float r, float g, float b)
+{
+    Vertex bl = {x0, y0, r, g, b, 1.0f};
+    Vertex br = {x1, y0, r, g, b, 1.0f};
+    Vertex tl = {x0, y1, r, g, b, 1.0f};
+    Vertex tr = {x1, y1, r, g, b, 1.0f};
+
+    addTriangle(bl, br, tl);
+    addTriangle(tr, tl, br);
+}
+
+void MeshBuilder::addFlag(const Flag &flag, float x, float y, float scale)
+{
+    float half_width = flag.width * scale;
+    for (const FlagStripe &stripe : flag.stripes)
+    {
+        addQuad(x - half_width, y + stripe.bottom * scale,
+                x + half_width, y + stripe.top * scale,
+                stripe.r, stripe.g, stripe.b);
+    }
+}
+
+void MeshBuilder::clear()
+{
+    unique_vertices.clear();
+    triangle_indices.clear();
+    lookup.clear();
+}
+
+Mesh::Mesh()
+    : index_count(0), index_type(GL_UNSIGNED_INT),
+      vertex_format(VertexFormat::Pos2F_Col4U8)
+{
+}
+
+Mesh::~Mesh()
+{
+    destroy();
+}
+
+bool Mesh::upload(const MeshBuilder &builder, VertexFormat format)
+{
+    destroy();
+
+    const vector<Vertex> &vertices = builder.vertices();
+    const vector<uint32_t> &indices = builder.indices();
+    if (vertices.empty() || indices.empty())
+        return false;
+
+    const VertexLayout &layout = VertexLayout::get(format);
+    vector<unsigned char> packed(vertices.size() * layout.stride);
+    pack_vertices(format, vertices.data(), vertices.size(), packed.data());
+
+    // لو النقط اقل من 65536 نستخدم 16 bit indices (نص المساحة)
+    if (vertices.size() <= 0xFFFF)
+    {
+        vector<uint16_t> short_indices(indices.begin(), indices.end());
+        return uploadPacked(format, packed.data(), vertices.size(), short_indices.data(), short_indices.size(),
+                            GL_UNSIGNED_SHORT);
+    }
+    return uploadPacked(format, packed.data(), vertices.size(), indices.data(), indices.size(), GL_UNSIGNED_INT);
+}
+
+bool Mesh::uploadPacked(VertexFormat format, const void *vertices, size_t vertex_count,
+                        const void *indices, size_t indices_count, GLenum indices_type)
+{
+    destroy();
+    if (vertex_count == 0 || indices_count == 0)
+        return false;
+
+    GPUResourcePool &pool = GPUResourcePool::shared();
+    vertex_array = pool.acquireVertexArray();
+
+    const VertexLayout &layout = VertexLayout::get(format);
+    vertex_format = format;
+    vertex_buffer = pool.acquireBuffer(vertex_count * layout.stride, vertices);
+
+    index_count = (GLsizei)indices_count;
+    index_type = indices_type;
+    size_t index_size = index_type == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+    index_buffer = pool.acquireBuffer(indices_count * index_size, indices);
+
+    setupVertexArray();
+    return true;
+}
+
+bool Mesh::uploadStaged(VertexFormat format, GLuint staging, size_t vertex_offset, size_t vertex_count,
+                        size_t index_offset, size_t indices_count, GLenum indices_type)
+{
+    destroy();
+    if (vertex_count == 0 || indices_count == 0)
+        return false;
+
+    GPUResourcePool &pool = GPUResourcePool::shared();
+    vertex_array = pool.acquireVertexArray();
+
+    const VertexLayout &layout = VertexLayout::get(format);
+    vertex_format = format;
+    size_t vertex_bytes = vertex_count * layout.stride;
+    vertex_buffer = pool.acquireBuffer(vertex_bytes);
+
+    index_count = (GLsizei)indices_count;
+    index_type = indices_type;
+    size_t index_bytes = indices_count * (index_type == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t));
+    index_buffer = pool.acquireBuffer(index_bytes);
+
+    // COPY_READ و COPY_WRITE مش جزء من ال VAO فمش بيبوظوا اي state
+    GLStateCache &state = GLStateCache::shared();
+    state.bindBuffer(GL_COPY_READ_BUFFER, staging);
+    state.bindBuffer(GL_COPY_WRITE_BUFFER, vertex_buffer.get());
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, vertex_offset, 0, vertex_bytes);
+    state.bindBuffer(GL_COPY_WRITE_BUFFER, index_buffer.get());
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, index_offset, 0, index_bytes);
+    state.bindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    state.bindBuffer(GL_COPY_READ_BUFFER, 0);
+
+    setupVertexArray();
+    return true;
+}
+
+void Mesh::setupVertexArray()
+{
+    const VertexLayout &layout = VertexLayout::get(vertex_format);
+
+    GLStateCache::shared().bindVertexArray(vertex_array.get());
+    GLStateCache::shared().bindBuffer(GL_ARRAY_BUFFER, vertex_buffer.get());
+
+    // ال EBO بيتسجل جوه ال VAO نفسه فلازم يتعمله bind و ال VAO متفعل
+    GLStateCache::shared().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer.get());
+
+    layout.apply();
+
+    // نفك ال VAO الاول عشان ال EBO يفضل مربوط بيه
+    GLStateCache::shared().bindVertexArray(0);
+    GLStateCache::shared().bindBuffer(GL_ARRAY_BUFFER, 0);
+    GLStateCache::shared().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void Mesh::draw() const
+{
+    if (!vertex_array)
+        return;
+
+    GLStateCache::shared().bindVertexArray(vertex_array.get());
+    glDrawElements(GL_TRIANGLES, index_count, index_type, (void *)0);
+}
+
+void Mesh::record(DrawList &list, const DrawPass &pass) const
+{
+    if (!vertex_array)
+        return;
+
+    list.pushElements(pass, vertex_array.get(), index_count, index_type);
+}
+
+void Mesh::recordRange(DrawList &list, const DrawPass &pass, GLsizei count, size_t first_index, GLint base_vertex) const
+{
+    if (!vertex_array)
+        return;
+
+    size_t index_size = index_type == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+    list.pushElements(pass, vertex_array.get(), count, index_type, first_index * index_size, base_vertex);
+}
+
+void Mesh::bind() const
+{
+    GLStateCache::shared().bindVertexArray(vertex_array.get());
+}
+
+void Mesh::destroy()
+{
+    // بيرجعوا لل pool عشان ال mesh الجاي ياخدهم من غير glGen
+    vertex_array.reset();
+    vertex_buffer.reset();
+    index_buffer.reset();
+    index_count = 0;
+}
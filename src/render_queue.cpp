@@ -0,0 +1,200 @@
+#include "render_queue.h"
+
+#include "gl_state_cache.h"
+
+#include <chrono>
+#include <cstring>
+
+using namespace std;
+
+RenderQueue::RenderQueue()
+    : draw_count(0), program_changes(0), vertex_array_changes(0), material_changes(0), sort_ms(0.0)
+{
+    // material 0: مفيش uniforms
+    materials.push_back(MaterialApply());
+}
+
+uint64_t DrawList::makeKey(uint32_t layer, GLuint program, GLuint vertex_array, uint32_t material)
+{
+    return ((uint64_t)(layer & MAX_LAYER) << 56) |
+           ((uint64_t)(program & 0xFFFF) << 40) |
+           ((uint64_t)(vertex_array & 0xFFFF) << 24) |
+           (uint64_t)(material & MAX_MATERIAL);
+}
+
+uint32_t RenderQueue::addMaterial(const MaterialApply &apply)
+{
+    materials.push_back(apply);
+    return (uint32_t)(materials.size() - 1);
+}
+
+void DrawList::push(uint32_t layer, const DrawCommand &command)
+{
+    keys.push_back(makeKey(layer, command.program, command.vertex_array, command.material));
+    commands.push_back(command);
+}
+
+void DrawList::pushElements(const DrawPass &pass, GLuint vertex_array, GLsizei count, GLenum index_type,
+                               size_t offset, GLint base_vertex, GLsizei instances)
+{
+    DrawCommand command;
+    command.program = pass.program;
+    command.vertex_array = vertex_array;
+    command.material = pass.material;
+    command.primitive = GL_TRIANGLES;
+    command.count = count;
+    command.index_type = index_type;
+    command.first = offset;
+    command.base_vertex = base_vertex;
+    command.instances = instances;
+    push(pass.layer, command);
+}
+
+const vector<uint32_t> &RenderQueue::sort()
+{
+    size_t count = keys.size();
+    for (int i = 0; i < 2; i++)
+    {
+        sort_keys[i].resize(count);
+        sort_order[i].resize(count);
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        sort_keys[0][i] = keys[i];
+        sort_order[0][i] = (uint32_t)i;
+    }
+
+    // LSD: byte بعد byte من الاصغر، و كل pass stable
+    // لو كل المفاتيح فيها نفس ال byte ده (غالبا layer و اجزاء كتير من المفتاح) بنعدي ال pass
+    int source = 0;
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        size_t histogram[256];
+        memset(histogram, 0, sizeof(histogram));
+
+        const vector<uint64_t> &in_keys = sort_keys[source];
+        for (size_t i = 0; i < count; i++)
+            histogram[(in_keys[i] >> shift) & 0xFF]++;
+
+        if (count == 0 || histogram[(in_keys[0] >> shift) & 0xFF] == count)
+            continue;
+
+        size_t offset = 0;
+        for (size_t &bucket : histogram)
+        {
+            size_t size = bucket;
+            bucket = offset;
+            offset += size;
+        }
+
+        const vector<uint32_t> &in_order = sort_order[source];
+        vector<uint64_t> &out_keys = sort_keys[1 - source];
+        vector<uint32_t> &out_order = sort_order[1 - source];
+        for (size_t i = 0; i < count; i++)
+        {
+            size_t slot = histogram[(in_keys[i] >> shift) & 0xFF]++;
+            out_keys[slot] = in_keys[i];
+            out_order[slot] = in_order[i];
+        }
+        source = 1 - source;
+    }
+
+    return sort_order[source];
+}
+
+void RenderQueue::execute(const DrawCommand &command) const
+{
+    GLsizei instances = command.instances;
+
+    if (command.index_type == 0)
+    {
+        if (instances > 0)
+            glDrawArraysInstanced(command.primitive, (GLint)command.first, command.count, instances);
+        else
+            glDrawArrays(command.primitive, (GLint)command.first, command.count);
+        return;
+    }
+
+    const void *indices = (const void *)command.first;
+    if (instances > 0)
+        glDrawElementsInstancedBaseVertex(command.primitive, command.count, command.index_type, indices,
+                                          instances, command.base_vertex);
+    else if (command.base_vertex != 0)
+        glDrawElementsBaseVertex(command.primitive, command.count, command.index_type, indices, command.base_vertex);
+    else
+        glDrawElements(command.primitive, command.count, command.index_type, indices);
+}
+
+void RenderQueue::submit()
+{
+    auto sort_start = chrono::steady_clock::now();
+    const vector<uint32_t> &order = sort();
+    sort_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - sort_start).count();
+
+    draw_count = 0;
+    program_changes = 0;
+    vertex_array_changes = 0;
+    material_changes = 0;
+
+    GLStateCache &state = GLStateCache::shared();
+
+    bool first = true;
+    GLuint program = 0;
+    GLuint vertex_array = 0;
+    uint32_t material = 0;
+    for (uint32_t index : order)
+    {
+        const DrawCommand &command = commands[index];
+
+        bool program_changed = first || command.program != program;
+        if (program_changed)
+        {
+            state.useProgram(command.program);
+            program = command.program;
+            program_changes++;
+        }
+
+        // ال uniforms بتاعة ال program، فلو ال program اتغير لازم نحطها تاني
+        if (program_changed || command.material != material)
+        {
+            material = command.material;
+            if (material < materials.size() && materials[material])
+                materials[material](program);
+            material_changes++;
+        }
+
+        if (first || command.vertex_array != vertex_array)
+        {
+            state.bindVertexArray(command.vertex_array);
+            vertex_array = command.vertex_array;
+            vertex_array_changes++;
+        }
+
+        execute(command);
+        draw_count++;
+        first = false;
+    }
+
+    clear();
+}
+
+void DrawList::clear()
+{
+    commands.clear();
+    keys.clear();
+}
+
+void DrawList::append(DrawList &list)
+{
+    commands.insert(commands.end(), list.commands.begin(), list.commands.end());
+    keys.insert(keys.end(), list.keys.begin(), list.keys.end());
+    list.clear();
+}
+
+void RenderQueue::printStats(ostream &out) const
+{
+    out << "Render queue (last frame): " << draw_count << " draws, " << program_changes << " programs, "
+        << vertex_array_changes << " vertex arrays, " << material_changes << " materials, sort "
+        << sort_ms << " ms\n";
+}
@@ -0,0 +1,656 @@
+#include "shader.h"
+
+#include "gl_state_cache.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+
+// الملف بتاع ال cache بيبدأ بالهيدر ده و بعده ال binary نفسه
+struct ProgramCacheHeader
+{
+    char magic[4];          // "GLPB"
+    uint32_t version;       // لو غيرنا شكل الملف نزود الرقم ده
+    uint32_t binary_format; // ال format اللي رجعه الدرايفر
+    uint32_t length;        // حجم ال binary بالبايت
+};
+
+static const uint32_t PROGRAM_CACHE_VERSION = 1;
+
+static string &cache_dir_storage()
+{
+    static string dir;
+    return dir;
+}
+
+void Shader::setCacheDirectory(const string &dir)
+{
+    cache_dir_storage() = dir;
+}
+
+const string &Shader::cacheDirectory()
+{
+    return cache_dir_storage();
+}
+
+static bool &fail_fast_storage()
+{
+    static bool enabled = false;
+    return enabled;
+}
+
+void Shader::setFailFast(bool enabled)
+{
+    fail_fast_storage() = enabled;
+}
+
+bool Shader::failFast()
+{
+    return fail_fast_storage();
+}
+
+static double elapsed_ms(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// FNV-1a 64 bit: سريع و كفاية اننا نفرق بين ال sources المختلفة
+static void hash_bytes(uint64_t &hash, const char *data)
+{
+    if (!data)
+        data = "";
+
+    // بنضيف الحرف الصفري كمان عشان "ab"+"c" ماتطلعش نفس "a"+"bc"
+    size_t length = strlen(data) + 1;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)data[i];
+        hash *= 1099511628211ULL;
+    }
+}
+
+// المفتاح بيعتمد علي ال sources و علي الدرايفر نفسه
+// لو الدرايفر اتحدث ال binary القديم مينفعش يتحمل فبنغير المفتاح
+static string program_cache_path(const char *vertex_source, const char *fragment_source)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    hash_bytes(hash, vertex_source);
+    hash_bytes(hash, fragment_source);
+    hash_bytes(hash, (const char *)glGetString(GL_VENDOR));
+    hash_bytes(hash, (const char *)glGetString(GL_RENDERER));
+    hash_bytes(hash, (const char *)glGetString(GL_VERSION));
+
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)hash);
+    return (filesystem::path(Shader::cacheDirectory()) / name).string();
+}
+
+static bool program_binary_supported()
+{
+#ifdef GL_ARB_get_program_binary
+    if (!GLAD_GL_ARB_get_program_binary)
+        return false;
+
+    // بعض الدرايفرات بتدعم ال extension بس مبترجعش ولا format
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+#else
+    return false;
+#endif
+}
+
+// بيقرا ال binary من الديسك و يبعته للدرايفر
+// النتيجة (قبله ولا رفضه) بنعرفها من GL_LINK_STATUS بعدين في poll
+static bool submit_cached_program(GLuint program, const string &path)
+{
+#ifdef GL_ARB_get_program_binary
+    ifstream file(path, ios::binary);
+    if (!file)
+        return false;
+
+    ProgramCacheHeader header;
+    if (!file.read((char *)&header, sizeof(header)))
+        return false;
+
+    if (memcmp(header.magic, "GLPB", 4) != 0 || header.version != PROGRAM_CACHE_VERSION || header.length == 0)
+        return false;
+
+    vector<char> binary(header.length);
+    if (!file.read(binary.data(), binary.size()))
+        return false;
+
+    glProgramBinary(program, header.binary_format, binary.data(), (GLsizei)binary.size());
+    return true;
+#else
+    (void)program;
+    (void)path;
+    return false;
+#endif
+}
+
+static void store_cached_program(GLuint program, const string &path)
+{
+#ifdef GL_ARB_get_program_binary
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    vector<char> binary(length);
+    GLenum binary_format = 0;
+    glGetProgramBinary(program, length, nullptr, &binary_format, binary.data());
+
+    error_code ec;
+    filesystem::create_directories(Shader::cacheDirectory(), ec);
+
+    ProgramCacheHeader header;
+    memcpy(header.magic, "GLPB", 4);
+    header.version = PROGRAM_CACHE_VERSION;
+    header.binary_format = binary_format;
+    header.length = (uint32_t)length;
+
+    // بنكتب في ملف مؤقت و بعدين rename
+    // عشان لو اكتر من worker بيكتبوا في نفس الوقت محدش يقرا ملف نصه مكتوب
+    string temp_path = path + ".tmp" + to_string(chrono::steady_clock::now().time_since_epoch().count());
+    {
+        ofstream file(temp_path, ios::binary | ios::trunc);
+        if (!file)
+            return;
+        file.write((const char *)&header, sizeof(header));
+        file.write(binary.data(), binary.size());
+        if (!file)
+        {
+            file.close();
+            filesystem::remove(temp_path, ec);
+            return;
+        }
+    }
+
+    filesystem::rename(temp_path, path, ec);
+    if (ec)
+        filesystem::remove(temp_path, ec);
+#else
+    (void)program;
+    (void)path;
+#endif
+}
+
+static string shader_info_log(GLuint shader)
+{
+    GLint length = 0;
+    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+    if (length <= 1)
+        return string();
+
+    string log(length, '\0');
+    glGetShaderInfoLog(shader, length, nullptr, &log[0]);
+    log.resize(length - 1);
+    return log;
+}
+
+static string program_info_log(GLuint program)
+{
+    GLint length = 0;
+    glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+    if (length <= 1)
+        return string();
+
+    string log(length, '\0');
+    glGetProgramInfoLog(program, length, nullptr, &log[0]);
+    log.resize(length - 1);
+    return log;
+}
+
+// الدرايفرات بتكتب مكان الغلط باشكال مختلفة:
+//     "0:12(5): error ..."   (Mesa)
+//     "0(12) : error ..."    (NVIDIA)
+//     "ERROR: 0:12: ..."     (AMD / Intel)
+// الرقم الاول رقم الملف (#line) و التاني السطر، و [begin, end) هو مكانهم في السطر
+static bool parse_log_location(const string &text, size_t &begin, size_t &end, int &file, int &line)
+{
+    size_t pos = 0;
+    for (const char *prefix : {"ERROR: ", "WARNING: "})
+    {
+        size_t length = strlen(prefix);
+        if (text.compare(0, length, prefix) == 0)
+            pos = length;
+    }
+
+    if (pos >= text.size() || !isdigit((unsigned char)text[pos]))
+        return false;
+    begin = pos;
+
+    file = 0;
+    while (pos < text.size() && isdigit((unsigned char)text[pos]))
+        file = file * 10 + (text[pos++] - '0');
+
+    if (pos >= text.size() || (text[pos] != ':' && text[pos] != '('))
+        return false;
+    char separator = text[pos++];
+
+    if (pos >= text.size() || !isdigit((unsigned char)text[pos]))
+        return false;
+    line = 0;
+    while (pos < text.size() && isdigit((unsigned char)text[pos]))
+        line = line * 10 + (text[pos++] - '0');
+
+    if (separator == '(')
+    {
+        if (pos >= text.size() || text[pos] != ')')
+            return false;
+        pos++;
+    }
+
+    end = pos;
+    return true;
+}
+
+static string text_line(const string &text, int line)
+{
+    istringstream stream(text);
+    string result;
+    for (int i = 0; i < line; i++)
+    {
+        if (!getline(stream, result))
+            return string();
+    }
+    return result;
+}
+
+// بيبدل رقم الملف باسمه و يحط تحت كل غلط السطر اللي فيه
+// من غير files (source مكتوب في الكود) السطور بتتاخد من ال source نفسه
+static string annotate_info_log(const string &log, const vector<string> &files, const string &source)
+{
+    map<int, string> texts;
+    string result;
+    istringstream stream(log);
+    string text;
+    while (getline(stream, text))
+    {
+        size_t begin = 0, end = 0;
+        int file = 0, line = 0;
+        if (!parse_log_location(text, begin, end, file, line))
+        {
+            result += text + "\n";
+            continue;
+        }
+
+        string snippet;
+        if (files.empty())
+        {
+            if (file == 0)
+                snippet = text_line(source, line);
+        }
+        else if (file < (int)files.size())
+        {
+            auto found = texts.find(file);
+            if (found == texts.end())
+            {
+                ifstream input(files[file], ios::binary);
+                stringstream buffer;
+                buffer << input.rdbuf();
+                found = texts.emplace(file, buffer.str()).first;
+            }
+            snippet = text_line(found->second, line);
+            text = text.substr(0, begin) + files[file] + ":" + to_string(line) + text.substr(end);
+        }
+
+        result += text + "\n";
+        if (!snippet.empty())
+            result += "    " + to_string(line) + " | " + snippet + "\n";
+    }
+    return result;
+}
+
+// الرقم ممكن يرجع لprogram جديد فلازم ال state cache ينساه
+static void delete_program(GLuint program)
+{
+    glDeleteProgram(program);
+    GLStateCache::shared().forgetProgram(program);
+}
+
+static bool shader_compiled(GLuint shader, const char *name, const vector<string> &files, const string &source)
+{
+    GLint success = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success)
+    {
+        cerr << name << " Shader Compilation failed:\n" << annotate_info_log(shader_info_log(shader), files, source) << endl;
+        return false;
+    }
+
+    return true;
+}
+
+static GLuint compile_shader(GLenum type, const char *source)
+{
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+    return shader;
+}
+
+bool Shader::parallelCompileSupported()
+{
+#ifdef GL_KHR_parallel_shader_compile
+    return GLAD_GL_KHR_parallel_shader_compile != 0;
+#else
+    return false;
+#endif
+}
+
+Shader::Shader()
+    : ID(0), build_status(NotBuilt), from_cache(false), build_ms(0.0), failed_stage(nullptr),
+      vertex_shader(0), fragment_shader(0)
+{
+}
+
+Shader::~Shader()
+{
+    destroy();
+}
+
+void Shader::destroy()
+{
+    if (vertex_shader)
+    {
+        glDeleteShader(vertex_shader);
+        vertex_shader = 0;
+    }
+    if (fragment_shader)
+    {
+        glDeleteShader(fragment_shader);
+        fragment_shader = 0;
+    }
+    if (ID)
+    {
+        delete_program(ID);
+        ID = 0;
+    }
+    build_status = NotBuilt;
+}
+
+bool Shader::build(const char *vertex_source, const char *fragment_source)
+{
+    submit(vertex_source, fragment_source);
+    return poll(true) == Ready;
+}
+
+bool Shader::build(const PreprocessedShader &vertex, const PreprocessedShader &fragment)
+{
+    submit(vertex, fragment);
+    return poll(true) == Ready;
+}
+
+void Shader::submit(const char *vertex_source, const char *fragment_source)
+{
+    vertex_files.clear();
+    fragment_files.clear();
+    start(vertex_source, fragment_source);
+}
+
+void Shader::submit(const PreprocessedShader &vertex, const PreprocessedShader &fragment)
+{
+    vertex_files = vertex.files;
+    fragment_files = fragment.files;
+    start(vertex.source.c_str(), fragment.source.c_str());
+}
+
+void Shader::start(const char *vertex_source, const char *fragment_source)
+{
+    destroy();
+    build_start = chrono::steady_clock::now();
+    build_status = Building;
+    from_cache = false;
+    build_timings = BuildTimings();
+    failed_stage = nullptr;
+
+    this->vertex_source = vertex_source;
+    this->fragment_source = fragment_source;
+
+    cache_path.clear();
+    if (!cacheDirectory().empty() && program_binary_supported())
+    {
+        cache_path = program_cache_path(vertex_source, fragment_source);
+
+        ID = glCreateProgram();
+        if (submit_cached_program(ID, cache_path))
+            from_cache = true;
+        else
+        {
+            delete_program(ID);
+            ID = 0;
+        }
+    }
+
+    if (!from_cache)
+        submitCompile();
+
+    if (failFast())
+        poll(true);
+}
+
+void Shader::submitCompile()
+{
+    if (failFast())
+    {
+        compileStaged();
+        return;
+    }
+
+    // هنا بنبعت كل حاجة للدرايفر و مش بنسأل عن ال status خالص
+    // السؤال هو اللي بيوقف ال thread لحد ما ال compile يخلص
+    vertex_shader = compile_shader(GL_VERTEX_SHADER, vertex_source.c_str());
+    fragment_shader = compile_shader(GL_FRAGMENT_SHADER, fragment_source.c_str());
+
+    ID = glCreateProgram();
+
+#ifdef GL_ARB_get_program_binary
+    // لازم نقول للدرايفر قبل ال link اننا هنطلب ال binary بعدين
+    if (!cache_path.empty())
+        glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
+
+    glAttachShader(ID, vertex_shader);
+    glAttachShader(ID, fragment_shader);
+    glLinkProgram(ID);
+}
+
+void Shader::compileStaged()
+{
+    // السؤال عن ال status بيستني المرحلة تخلص، فالوقت بيتحسب عليها هي بس
+    // و لو فشلت مبنبدأش اللي بعدها، و finishCompile بيطبع الغلط
+    GLint success = 0;
+    chrono::steady_clock::time_point stage_start = chrono::steady_clock::now();
+    vertex_shader = compile_shader(GL_VERTEX_SHADER, vertex_source.c_str());
+    glGetShaderiv(vertex_shader, GL_COMPILE_STATUS, &success);
+    build_timings.vertex_ms = elapsed_ms(stage_start);
+    if (!success)
+        return;
+
+    stage_start = chrono::steady_clock::now();
+    fragment_shader = compile_shader(GL_FRAGMENT_SHADER, fragment_source.c_str());
+    glGetShaderiv(fragment_shader, GL_COMPILE_STATUS, &success);
+    build_timings.fragment_ms = elapsed_ms(stage_start);
+    if (!success)
+        return;
+
+    stage_start = chrono::steady_clock::now();
+    ID = glCreateProgram();
+
+#ifdef GL_ARB_get_program_binary
+    if (!cache_path.empty())
+        glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
+
+    glAttachShader(ID, vertex_shader);
+    glAttachShader(ID, fragment_shader);
+    glLinkProgram(ID);
+    glGetProgramiv(ID, GL_LINK_STATUS, &success);
+    build_timings.link_ms = elapsed_ms(stage_start);
+}
+
+Shader::BuildStatus Shader::poll(bool wait)
+{
+    if (build_status != Building)
+        return build_status;
+
+#ifdef GL_KHR_parallel_shader_compile
+    // GL_COMPLETION_STATUS_KHR مبيوقفش ال thread، بيقول بس خلص ولا لسه
+    if (!wait && parallelCompileSupported())
+    {
+        GLint done = GL_FALSE;
+        glGetProgramiv(ID, GL_COMPLETION_STATUS_KHR, &done);
+        if (!done)
+            return Building;
+    }
+#endif
+
+    if (from_cache)
+    {
+        GLint success = 0;
+        glGetProgramiv(ID, GL_LINK_STATUS, &success);
+        if (failFast())
+            build_timings.cache_load_ms = elapsed_ms(build_start);
+        if (success)
+        {
+            finish(Ready);
+            return build_status;
+        }
+
+        // الدرايفر رفض ال binary (مثلا اتعمل بنسخة تانية) فنعمل compile عادي
+        delete_program(ID);
+        ID = 0;
+        from_cache = false;
+        submitCompile();
+        return wait ? poll(true) : Building;
+    }
+
+    bool success = finishCompile();
+
+    // بنحفظ في ال cache بس لو عملنا compile فعلا
+    if (success && !cache_path.empty())
+    {
+        chrono::steady_clock::time_point store_start = chrono::steady_clock::now();
+        store_cached_program(ID, cache_path);
+        build_timings.store_ms = elapsed_ms(store_start);
+    }
+
+    finish(success ? Ready : Failed);
+    return build_status;
+}
+
+bool Shader::finishCompile()
+{
+    // في fail fast المراحل اللي بعد اول غلط مبتتعملش، فممكن fragment_shader او ID يبقوا صفر
+    bool success = shader_compiled(vertex_shader, "Vertex", vertex_files, vertex_source);
+    if (!success)
+        failed_stage = "vertex";
+
+    if (fragment_shader && !shader_compiled(fragment_shader, "Fragment", fragment_files, fragment_source))
+    {
+        if (success)
+            failed_stage = "fragment";
+        success = false;
+    }
+
+    if (success)
+    {
+        GLint linked = 0;
+        glGetProgramiv(ID, GL_LINK_STATUS, &linked);
+        if (!linked)
+        {
+            cerr << "Shader Program Linking failed:\n" << program_info_log(ID) << endl;
+            failed_stage = "link";
+            success = false;
+        }
+    }
+
+    // بعد ال link مش محتاجين ال shaders الصغيرة
+    if (ID)
+    {
+        glDetachShader(ID, vertex_shader);
+        glDetachShader(ID, fragment_shader);
+    }
+    glDeleteShader(vertex_shader);
+    if (fragment_shader)
+        glDeleteShader(fragment_shader);
+    vertex_shader = 0;
+    fragment_shader = 0;
+
+    return success;
+}
+
+void Shader::finish(BuildStatus result)
+{
+    if (result == Failed && ID)
+    {
+        delete_program(ID);
+        ID = 0;
+    }
+
+    build_status = result;
+    build_ms = elapsed_ms(build_start);
+
+    if (failFast())
+        printTimings();
+
+    vertex_source.clear();
+    vertex_source.shrink_to_fit();
+    fragment_source.clear();
+    fragment_source.shrink_to_fit();
+    vertex_files.clear();
+    fragment_files.clear();
+}
+
+void Shader::printTimings() const
+{
+    ostream &out = build_status == Ready ? cout : cerr;
+    out << "Shader build";
+    if (!vertex_files.empty() && !fragment_files.empty())
+        out << " [" << vertex_files[0] << " + " << fragment_files[0] << "]";
+
+    if (build_status == Ready)
+        out << " ready in " << build_ms << " ms:";
+    else
+        out << " failed" << (failed_stage ? string(" at ") + failed_stage : string()) << " after " << build_ms << " ms:";
+
+    const BuildTimings &t = build_timings;
+    if (from_cache)
+        out << " cache load " << t.cache_load_ms << " ms";
+    if (t.vertex_ms > 0.0)
+        out << " vertex " << t.vertex_ms << " ms";
+    if (t.fragment_ms > 0.0)
+        out << ", fragment " << t.fragment_ms << " ms";
+    if (t.link_ms > 0.0)
+        out << ", link " << t.link_ms << " ms";
+    if (t.store_ms > 0.0)
+        out << ", cache store " << t.store_ms << " ms";
+    out << "\n";
+}
+
+void Shader::use() const
+{
+    GLStateCache::shared().useProgram(ID);
+}
+
+void Shader::setBool(const string &name, bool value) const
+{
+    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+}
+
+void Shader::setInt(const string &name, int value) const
+{
+    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+}
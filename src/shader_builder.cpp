@@ -0,0 +1,39 @@
+#include "shader_builder.h"
+
+#include <algorithm>
+
+using namespace std;
+
+void ShaderBuilder::enableParallelCompile(GLuint max_threads)
+{
+#ifdef GL_KHR_parallel_shader_compile
+    if (GLAD_GL_KHR_parallel_shader_compile)
+        glMaxShaderCompilerThreadsKHR(max_threads);
+#else
+    (void)max_threads;
+#endif
+}
+
+void ShaderBuilder::submit(Shader &shader, const char *vertex_source, const char *fragment_source)
+{
+    shader.submit(vertex_source, fragment_source);
+    if (find(building.begin(), building.end(), &shader) == building.end())
+        building.push_back(&shader);
+}
+
+size_t ShaderBuilder::poll()
+{
+    // من غير ال extension poll بيوقف ال thread، فبنسيب الشغل ده لحد ما كل ال submits تخلص
+    // و ده لوحده بيدي الدرايفر فرصة يشتغل علي كذا shader مع بعض
+    building.erase(remove_if(building.begin(), building.end(),
+                             [](Shader *shader) { return shader->poll() != Shader::Building; }),
+                   building.end());
+    return building.size();
+}
+
+void ShaderBuilder::waitAll()
+{
+    for (Shader *shader : building)
+        shader->poll(true);
+    building.clear();
+}
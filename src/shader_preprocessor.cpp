@@ -0,0 +1,205 @@
+#include "shader_preprocessor.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+using namespace std;
+
+// include جوه include جوه ... اكتر من كده غالبا include بيلف علي نفسه
+static const int MAX_INCLUDE_DEPTH = 16;
+
+struct PreprocessState
+{
+    PreprocessedShader *out;
+    const ShaderDefines *defines;
+    set<string> once_files;
+    vector<string> stack;
+};
+
+static bool read_lines(const string &path, vector<string> &lines)
+{
+    ifstream file(path);
+    if (!file)
+        return false;
+
+    string line;
+    while (getline(file, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        lines.push_back(line);
+    }
+    return true;
+}
+
+// لو السطر directive بيرجع اسمه (version, include, pragma ...) و الباقي في rest
+static bool parse_directive(const string &line, string &name, string &rest)
+{
+    size_t i = line.find_first_not_of(" \t");
+    if (i == string::npos || line[i] != '#')
+        return false;
+
+    i = line.find_first_not_of(" \t", i + 1);
+    if (i == string::npos)
+        return false;
+
+    size_t end = line.find_first_of(" \t", i);
+    name = line.substr(i, end == string::npos ? string::npos : end - i);
+    rest = end == string::npos ? string() : line.substr(end);
+    return true;
+}
+
+static size_t file_index(PreprocessedShader &out, const string &path)
+{
+    auto found = find(out.files.begin(), out.files.end(), path);
+    if (found != out.files.end())
+        return found - out.files.begin();
+
+    out.files.push_back(path);
+    return out.files.size() - 1;
+}
+
+static void append_defines(string &source, const ShaderDefines &defines)
+{
+    for (const ShaderDefine &define : defines)
+    {
+        source += "#define " + define.name;
+        if (!define.value.empty())
+            source += " " + define.value;
+        source += "\n";
+    }
+}
+
+static bool process_file(PreprocessState &state, const string &path, bool root)
+{
+    string canonical = filesystem::weakly_canonical(path).string();
+    if (state.once_files.count(canonical))
+        return true;
+
+    if ((int)state.stack.size() >= MAX_INCLUDE_DEPTH ||
+        find(state.stack.begin(), state.stack.end(), canonical) != state.stack.end())
+    {
+        cerr << path << ": recursive #include\n";
+        return false;
+    }
+
+    vector<string> lines;
+    if (!read_lines(path, lines))
+    {
+        cerr << "Can't open " << path << "\n";
+        return false;
+    }
+
+    state.stack.push_back(canonical);
+    PreprocessedShader &out = *state.out;
+    size_t index = file_index(out, path);
+
+    // الملف الاساسي من غير #version: ال defines في الاول
+    bool defines_written = !root;
+    if (root)
+    {
+        bool has_version = false;
+        for (const string &line : lines)
+        {
+            string name, rest;
+            if (parse_directive(line, name, rest) && name == "version")
+                has_version = true;
+        }
+        if (!has_version)
+        {
+            append_defines(out.source, *state.defines);
+            out.source += "#line 1 " + to_string(index) + "\n";
+            defines_written = true;
+        }
+    }
+    else
+    {
+        out.source += "#line 1 " + to_string(index) + "\n";
+    }
+
+    for (size_t i = 0; i < lines.size(); i++)
+    {
+        const string &line = lines[i];
+        size_t next_line = i + 2;
+
+        string name, rest;
+        if (!parse_directive(line, name, rest))
+        {
+            out.source += line + "\n";
+            continue;
+        }
+
+        if (name == "version" && !defines_written)
+        {
+            out.source += line + "\n";
+            append_defines(out.source, *state.defines);
+            out.source += "#line " + to_string(next_line) + " " + to_string(index) + "\n";
+            defines_written = true;
+        }
+        else if (name == "include")
+        {
+            size_t open = rest.find_first_of("\"<");
+            size_t close = open == string::npos ? string::npos : rest.find_first_of("\">", open + 1);
+            if (close == string::npos)
+            {
+                cerr << path << ":" << i + 1 << ": bad #include\n";
+                state.stack.pop_back();
+                return false;
+            }
+
+            string include = rest.substr(open + 1, close - open - 1);
+            filesystem::path include_path = filesystem::path(path).parent_path() / include;
+            if (!process_file(state, include_path.string(), false))
+            {
+                cerr << "  included from " << path << ":" << i + 1 << "\n";
+                state.stack.pop_back();
+                return false;
+            }
+            out.source += "#line " + to_string(next_line) + " " + to_string(index) + "\n";
+        }
+        else if (name == "pragma" && rest.find("once") != string::npos)
+        {
+            state.once_files.insert(canonical);
+            out.source += "\n";
+        }
+        else
+        {
+            out.source += line + "\n";
+        }
+    }
+
+    state.stack.pop_back();
+    return true;
+}
+
+bool preprocess_shader(const string &path, const ShaderDefines &defines, PreprocessedShader &out)
+{
+    out.source.clear();
+    out.files.clear();
+
+    PreprocessState state;
+    state.out = &out;
+    state.defines = &defines;
+    return process_file(state, path, true);
+}
+
+string shader_defines_key(const ShaderDefines &defines)
+{
+    vector<string> parts;
+    for (const ShaderDefine &define : defines)
+        parts.push_back(define.value.empty() ? define.name : define.name + "=" + define.value);
+    sort(parts.begin(), parts.end());
+
+    string key;
+    for (const string &part : parts)
+    {
+        if (!key.empty())
+            key += ";";
+        key += part;
+    }
+    return key;
+}
@@ -0,0 +1,197 @@
+#include "shader_reloader.h"
+
+#include <iostream>
+
+using namespace std;
+
+// الاسم اللي بيتطبع في الرسايل، المفتاح الفاضي هو النسخة من غير defines
+static const string &permutation_name(const string &key)
+{
+    static const string default_name = "default";
+    return key.empty() ? default_name : key;
+}
+
+ShaderReloader::ShaderReloader()
+    : watching(false), reload_count(0), reload_failures(0)
+{
+}
+
+ShaderReloader::~ShaderReloader()
+{
+    destroy();
+}
+
+bool ShaderReloader::load(const string &vertex_path, const string &fragment_path, bool watch)
+{
+    destroy();
+    this->vertex_path = vertex_path;
+    this->fragment_path = fragment_path;
+
+    // من غير defines: بس عشان نعرف ان الملفات موجودة و نعرف ال includes
+    PreprocessedShader vertex, fragment;
+    if (!preprocess_shader(vertex_path, ShaderDefines(), vertex) ||
+        !preprocess_shader(fragment_path, ShaderDefines(), fragment))
+        return false;
+
+    watching = watch;
+    if (watching)
+    {
+        watchSources(vertex);
+        watchSources(fragment);
+    }
+    return true;
+}
+
+void ShaderReloader::watchSources(const PreprocessedShader &source)
+{
+    for (const string &file : source.files)
+        watcher.watch(file);
+}
+
+ShaderReloader::Permutation &ShaderReloader::find(const ShaderDefines &defines)
+{
+    string key = shader_defines_key(defines);
+    auto found = cache.find(key);
+    if (found != cache.end())
+        return found->second;
+
+    Permutation &permutation = cache[key];
+    permutation.defines = defines;
+    if (!submit(permutation))
+        permutation.failed = true;
+    return permutation;
+}
+
+const Shader *ShaderReloader::program(const ShaderDefines &defines)
+{
+    return find(defines).active.get();
+}
+
+void ShaderReloader::prepare(const ShaderDefines &defines)
+{
+    find(defines);
+}
+
+const Shader *ShaderReloader::wait(const ShaderDefines &defines)
+{
+    Permutation &permutation = find(defines);
+    if (permutation.pending)
+        permutation.pending->poll(true);
+
+    // update هو اللي بيبدل ال pending لما يخلص و بيعلم ال failed
+    update();
+    return permutation.failed ? nullptr : permutation.active.get();
+}
+
+bool ShaderReloader::submit(Permutation &permutation)
+{
+    PreprocessedShader vertex, fragment;
+    if (!preprocess_shader(vertex_path, permutation.defines, vertex) ||
+        !preprocess_shader(fragment_path, permutation.defines, fragment))
+        return false;
+
+    // لو اتضاف include جديد نراقبه هو كمان
+    if (watching)
+    {
+        watchSources(vertex);
+        watchSources(fragment);
+    }
+
+    // لو فيه build لسه شغال من تعديل قبل كده بنرميه، الاحدث هو اللي يهمنا
+    permutation.pending.reset(new Shader());
+    permutation.pending->submit(vertex, fragment);
+    return true;
+}
+
+void ShaderReloader::update()
+{
+    if (watching && watcher.poll())
+    {
+        cout << "Shader source changed, rebuilding " << cache.size() << " permutation(s) of "
+             << vertex_path << " + " << fragment_path << "\n";
+        for (auto &entry : cache)
+        {
+            // غلط في ال include مثلا: بيتطبع و بنفضل علي القديم زي غلط ال compile
+            if (!submit(entry.second) && Shader::failFast())
+                entry.second.failed = true;
+        }
+    }
+
+    for (auto &entry : cache)
+    {
+        Permutation &permutation = entry.second;
+        if (!permutation.pending)
+            continue;
+
+        Shader::BuildStatus status = permutation.pending->poll();
+        if (status == Shader::Building)
+            continue;
+
+        if (status == Shader::Ready)
+        {
+            // القديم بيتمسح هنا، و ال draws اللي اتبعتت بيه الدرايفر بيخلصها الاول
+            if (permutation.active)
+            {
+                reload_count++;
+                cout << "Shader [" << permutation_name(entry.first) << "] reloaded in " << permutation.pending->buildTimeMs() << " ms\n";
+            }
+            permutation.active = move(permutation.pending);
+            permutation.failed = false;
+            continue;
+        }
+
+        permutation.pending.reset();
+        if (permutation.active)
+        {
+            reload_failures++;
+            cerr << "Shader [" << permutation_name(entry.first) << "] reload failed, keeping the previous program\n";
+        }
+
+        // في fail fast اي غلط بيعتبر فشل حتي لو فيه program قديم شغال
+        if (!permutation.active || Shader::failFast())
+            permutation.failed = true;
+    }
+}
+
+bool ShaderReloader::building() const
+{
+    for (const auto &entry : cache)
+    {
+        if (entry.second.pending)
+            return true;
+    }
+    return false;
+}
+
+bool ShaderReloader::failed() const
+{
+    for (const auto &entry : cache)
+    {
+        if (entry.second.failed)
+            return true;
+    }
+    return false;
+}
+
+void ShaderReloader::printStats(ostream &out) const
+{
+    out << "Shader permutations: " << cache.size();
+    for (const auto &entry : cache)
+    {
+        const Permutation &permutation = entry.second;
+        out << " [" << permutation_name(entry.first) << ": ";
+        if (permutation.active)
+            out << permutation.active->buildTimeMs() << " ms" << (permutation.active->loadedFromCache() ? " cached" : "");
+        else
+            out << (permutation.failed ? "failed" : "building");
+        out << "]";
+    }
+    out << ", " << reload_count << " reloads\n";
+}
+
+void ShaderReloader::destroy()
+{
+    watcher.stop();
+    watching = false;
+    cache.clear();
+}
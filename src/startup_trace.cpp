@@ -0,0 +1,135 @@
+#include "startup_trace.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+StartupTrace::StartupTrace()
+    : origin(clock::now())
+{
+    // ال thread اللي عمل ال trace (main) هو رقم 0
+    threads[this_thread::get_id()] = 0;
+}
+
+StartupTrace &StartupTrace::shared()
+{
+    static StartupTrace trace;
+    return trace;
+}
+
+size_t StartupTrace::threadIndex()
+{
+    auto found = threads.find(this_thread::get_id());
+    if (found != threads.end())
+        return found->second;
+
+    size_t index = threads.size();
+    threads[this_thread::get_id()] = index;
+    return index;
+}
+
+size_t StartupTrace::begin(const string &name)
+{
+    double start_us = chrono::duration<double, micro>(clock::now() - origin).count();
+
+    lock_guard<mutex> lock(phases_mutex);
+    Phase phase;
+    phase.name = name;
+    phase.thread = threadIndex();
+    phase.start_us = start_us;
+    phases.push_back(phase);
+    return phases.size() - 1;
+}
+
+void StartupTrace::end(size_t phase)
+{
+    double end_us = chrono::duration<double, micro>(clock::now() - origin).count();
+
+    lock_guard<mutex> lock(phases_mutex);
+    if (phase < phases.size())
+        phases[phase].duration_us = end_us - phases[phase].start_us;
+}
+
+StartupTrace::Scope::Scope(const string &name, StartupTrace &trace)
+    : trace(trace), phase(trace.begin(name))
+{
+}
+
+StartupTrace::Scope::~Scope()
+{
+    trace.end(phase);
+}
+
+double StartupTrace::elapsedMs() const
+{
+    return chrono::duration<double, milli>(clock::now() - origin).count();
+}
+
+void StartupTrace::printSummary(ostream &out) const
+{
+    lock_guard<mutex> lock(phases_mutex);
+    out << "Startup phases (ms from start):\n";
+    for (const Phase &phase : phases)
+    {
+        out << "  " << left << setw(24) << phase.name << right
+            << " thread " << phase.thread
+            << "  at " << setw(9) << fixed << setprecision(3) << phase.start_us / 1000.0;
+        if (phase.duration_us >= 0.0)
+            out << "  took " << setw(9) << phase.duration_us / 1000.0;
+        else
+            out << "  (not finished)";
+        out << defaultfloat << setprecision(6) << "\n";
+    }
+}
+
+static string json_escape(const string &text)
+{
+    string result;
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            result += '\\';
+        result += c;
+    }
+    return result;
+}
+
+bool StartupTrace::writeJSON(const string &path) const
+{
+    ofstream file(path);
+    if (!file)
+    {
+        cerr << "Can't write " << path << "\n";
+        return false;
+    }
+
+    lock_guard<mutex> lock(phases_mutex);
+
+    // "X" = مرحلة كاملة (بداية + مدة) و "M" = اسم ال thread، الوقت بالميكرو ثانية
+    file << fixed << setprecision(3);
+    file << "{\n";
+    file << "  \"displayTimeUnit\": \"ms\",\n";
+    file << "  \"traceEvents\": [\n";
+    for (size_t i = 0; i < threads.size(); i++)
+    {
+        file << (i > 0 ? ",\n" : "")
+             << "    {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << i
+             << ", \"args\": {\"name\": \"" << (i == 0 ? string("main") : "worker " + to_string(i)) << "\"}}";
+    }
+    for (const Phase &phase : phases)
+    {
+        // اللي متقفلتش مبنكتبهاش عشان ال viewer ميرسمهاش بطول غلط
+        if (phase.duration_us < 0.0)
+            continue;
+
+        file << ",\n    {\"name\": \"" << json_escape(phase.name) << "\", \"cat\": \"startup\", \"ph\": \"X\""
+             << ", \"pid\": 1, \"tid\": " << phase.thread
+             << ", \"ts\": " << phase.start_us << ", \"dur\": " << phase.duration_us << "}";
+    }
+    file << "\n  ]\n";
+    file << "}\n";
+
+    return (bool)file;
+}
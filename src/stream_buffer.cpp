@@ -0,0 +1,168 @@
+#include "stream_buffer.h"
+
+#include "gl_state_cache.h"
+
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+StreamBuffer::StreamBuffer()
+    : target(GL_ARRAY_BUFFER), buffer_capacity(0), ring_frames(3), head(0), region_begin(0),
+      frame_bytes(0), wait_count(0), wrap_count(0), reallocation_count(0)
+{
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    destroy();
+}
+
+bool StreamBuffer::init(GLenum target, size_t bytes_per_frame, size_t frames)
+{
+    destroy();
+
+    this->target = target;
+    ring_frames = frames > 0 ? frames : 1;
+
+    buffer = GLBuffer::create();
+    reallocate((bytes_per_frame > 0 ? bytes_per_frame : 4096) * ring_frames);
+    reallocation_count = 0;
+
+    return (bool)buffer;
+}
+
+void StreamBuffer::destroy()
+{
+    for (Region &region : regions)
+        glDeleteSync(region.fence);
+    regions.clear();
+
+    buffer.reset();
+    buffer_capacity = 0;
+    head = 0;
+    region_begin = 0;
+    frame_bytes = 0;
+    wait_count = 0;
+    wrap_count = 0;
+    reallocation_count = 0;
+}
+
+void StreamBuffer::reallocate(size_t new_capacity)
+{
+    // glBufferData بيدي storage جديد (orphan) و القديم الدرايفر بيمسحه لما ال GPU يخلص منه
+    // فال fences القديمة مبقاش ليها لازمة
+    for (Region &region : regions)
+        glDeleteSync(region.fence);
+    regions.clear();
+
+    GLStateCache::shared().bindBuffer(target, buffer.get());
+    glBufferData(target, new_capacity, nullptr, GL_STREAM_DRAW);
+
+    buffer_capacity = new_capacity;
+    head = 0;
+    region_begin = 0;
+    reallocation_count++;
+}
+
+void StreamBuffer::fenceRegion()
+{
+    if (head == region_begin)
+        return;
+
+    regions.push_back({glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), region_begin, head});
+    region_begin = head;
+}
+
+void StreamBuffer::waitForRange(size_t begin, size_t end)
+{
+    // ال regions مترتبة من الاقدم، و الاقدم هو اللي قدام ال head علي طول
+    // فلو اول واحد مش متداخل مع اللي هنكتبه يبقي محدش متداخل
+    while (!regions.empty())
+    {
+        Region &oldest = regions.front();
+        if (oldest.end <= begin || oldest.begin >= end)
+            break;
+
+        // بنسأل الاول من غير انتظار، و لو لسه نستني بجد
+        GLenum result = glClientWaitSync(oldest.fence, 0, 0);
+        if (result == GL_TIMEOUT_EXPIRED)
+        {
+            wait_count++;
+            result = glClientWaitSync(oldest.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        }
+        if (result == GL_WAIT_FAILED)
+            cerr << "glClientWaitSync failed in the stream buffer\n";
+
+        glDeleteSync(oldest.fence);
+        regions.pop_front();
+    }
+}
+
+void *StreamBuffer::map(size_t bytes, size_t alignment, size_t &offset)
+{
+    if (!buffer || bytes == 0)
+        return nullptr;
+
+    // اكبر من ال buffer كله: مفيش حل غير نكبره دلوقتي
+    if (bytes > buffer_capacity)
+        reallocate(bytes * ring_frames);
+
+    if (alignment == 0)
+        alignment = 1;
+    size_t start = (head + alignment - 1) / alignment * alignment;
+
+    // مفيش مكان لحد آخر ال buffer: نقفل اللي اتكتب بـ fence و نلف من الاول
+    if (start + bytes > buffer_capacity)
+    {
+        fenceRegion();
+        head = 0;
+        region_begin = 0;
+        start = 0;
+        wrap_count++;
+    }
+
+    waitForRange(start, start + bytes);
+
+    GLStateCache::shared().bindBuffer(target, buffer.get());
+    void *pointer = glMapBufferRange(target, start, bytes,
+                                     GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+    if (!pointer)
+    {
+        cerr << "Failed to map the stream buffer\n";
+        return nullptr;
+    }
+
+    offset = start;
+    head = start + bytes;
+    frame_bytes += bytes;
+    return pointer;
+}
+
+void StreamBuffer::unmap()
+{
+    GLStateCache::shared().bindBuffer(target, buffer.get());
+    glUnmapBuffer(target);
+}
+
+bool StreamBuffer::write(const void *data, size_t bytes, size_t alignment, size_t &offset)
+{
+    void *pointer = map(bytes, alignment, offset);
+    if (!pointer)
+        return false;
+
+    memcpy(pointer, data, bytes);
+    unmap();
+    return true;
+}
+
+void StreamBuffer::endFrame()
+{
+    fenceRegion();
+
+    // ال frame ده محتاج اكتر من نصيبه من ال ring: نكبر عشان ال frames الجاية متستناش
+    if (frame_bytes * ring_frames > buffer_capacity)
+        reallocate(frame_bytes * ring_frames);
+
+    frame_bytes = 0;
+}
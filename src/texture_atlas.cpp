@@ -0,0 +1,451 @@
+#include "texture_atlas.h"
+
+#include "image_writer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+SkylinePacker::SkylinePacker()
+    : area_width(0), area_height(0), used_area(0)
+{
+}
+
+void SkylinePacker::init(int width, int height)
+{
+    area_width = width;
+    area_height = height;
+    used_area = 0;
+    skyline.assign(1, {0, 0, width});
+}
+
+int SkylinePacker::fit(size_t index, int width, int height) const
+{
+    int x = skyline[index].x;
+    if (x + width > area_width)
+        return -1;
+
+    // المستطيل بيقعد علي اعلي جزء من الاجزاء اللي تحته
+    int y = 0;
+    int remaining = width;
+    for (size_t i = index; remaining > 0; i++)
+    {
+        y = max(y, skyline[i].y);
+        if (y + height > area_height)
+            return -1;
+        remaining -= skyline[i].width;
+    }
+    return y;
+}
+
+bool SkylinePacker::insert(int width, int height, int &x, int &y)
+{
+    if (width <= 0 || height <= 0)
+        return false;
+
+    size_t best = skyline.size();
+    int best_top = area_height + 1;
+    int best_width = area_width + 1;
+    for (size_t i = 0; i < skyline.size(); i++)
+    {
+        int top = fit(i, width, height);
+        if (top < 0)
+            continue;
+
+        // اوطي مكان، و لو متساويين اللي الجزء بتاعه اضيق (فراغ اقل)
+        if (top + height < best_top || (top + height == best_top && skyline[i].width < best_width))
+        {
+            best = i;
+            best_top = top + height;
+            best_width = skyline[i].width;
+        }
+    }
+    if (best == skyline.size())
+        return false;
+
+    x = skyline[best].x;
+    y = best_top - height;
+
+    // الجزء الجديد بيغطي اللي تحته، و اللي بعده بيتقص او يتشال
+    skyline.insert(skyline.begin() + best, {x, best_top, width});
+    for (size_t i = best + 1; i < skyline.size();)
+    {
+        int covered = skyline[i - 1].x + skyline[i - 1].width - skyline[i].x;
+        if (covered <= 0)
+            break;
+        if (covered < skyline[i].width)
+        {
+            skyline[i].x += covered;
+            skyline[i].width -= covered;
+            break;
+        }
+        skyline.erase(skyline.begin() + i);
+    }
+
+    // الاجزاء اللي جنب بعض بنفس الارتفاع بتبقي جزء واحد
+    for (size_t i = 0; i + 1 < skyline.size();)
+    {
+        if (skyline[i].y == skyline[i + 1].y)
+        {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    used_area += (size_t)width * height;
+    return true;
+}
+
+float SkylinePacker::occupancy() const
+{
+    size_t area = (size_t)area_width * area_height;
+    return area > 0 ? (float)used_area / area : 0.0f;
+}
+
+TextureAtlas::TextureAtlas()
+    : layer_size(0), layer_count(0), fill(0.0f)
+{
+}
+
+TextureAtlas::~TextureAtlas()
+{
+    destroy();
+}
+
+void TextureAtlas::computeUVs(AtlasRegion &region) const
+{
+    float size = (float)layer_size;
+    region.u0 = region.x / size;
+    region.v0 = region.y / size;
+    region.u1 = (region.x + region.width) / size;
+    region.v1 = (region.y + region.height) / size;
+}
+
+bool TextureAtlas::pack(const vector<AtlasImage> &images, int layer_size, int padding)
+{
+    destroy();
+    if (layer_size <= 0 || padding < 0)
+        return false;
+
+    for (const AtlasImage &image : images)
+    {
+        if (image.width <= 0 || image.height <= 0 || image.rgba.size() < (size_t)image.width * image.height * 4)
+        {
+            cerr << "Atlas image " << image.name << " is empty\n";
+            return false;
+        }
+        if (image.width + 2 * padding > layer_size || image.height + 2 * padding > layer_size)
+        {
+            cerr << "Atlas image " << image.name << " (" << image.width << "x" << image.height
+                 << ") doesn't fit in a " << layer_size << "x" << layer_size << " layer\n";
+            return false;
+        }
+    }
+
+    // الاطول الاول بيرص احسن بكتير في ال skyline
+    vector<size_t> order(images.size());
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    stable_sort(order.begin(), order.end(), [&images](size_t a, size_t b)
+    {
+        if (images[a].height != images[b].height)
+            return images[a].height > images[b].height;
+        return images[a].width > images[b].width;
+    });
+
+    this->layer_size = layer_size;
+    atlas_regions.resize(images.size());
+    vector<SkylinePacker> packers;
+    size_t image_area = 0;
+    for (size_t index : order)
+    {
+        const AtlasImage &image = images[index];
+        int w = image.width + 2 * padding;
+        int h = image.height + 2 * padding;
+
+        // اول layer فيه مكان، و لو مفيش layer جديد
+        int x = 0, y = 0;
+        size_t layer = 0;
+        while (layer < packers.size() && !packers[layer].insert(w, h, x, y))
+            layer++;
+        if (layer == packers.size())
+        {
+            packers.emplace_back();
+            packers.back().init(layer_size, layer_size);
+            packers.back().insert(w, h, x, y);
+        }
+
+        AtlasRegion &region = atlas_regions[index];
+        region.name = image.name;
+        region.layer = (int)layer;
+        region.x = x + padding;
+        region.y = y + padding;
+        region.width = image.width;
+        region.height = image.height;
+        computeUVs(region);
+        image_area += (size_t)image.width * image.height;
+    }
+
+    layer_count = (int)packers.size();
+    size_t layer_bytes = (size_t)layer_size * layer_size * 4;
+    layers.assign(layer_bytes * layer_count, 0);
+    fill = layer_count > 0 ? (float)image_area / ((size_t)layer_size * layer_size * layer_count) : 0.0f;
+
+    // الصورة و حواليها padding بنفس لون اطرافها
+    for (size_t i = 0; i < images.size(); i++)
+    {
+        const AtlasImage &image = images[i];
+        const AtlasRegion &region = atlas_regions[i];
+        uint8_t *layer = layers.data() + layer_bytes * region.layer;
+
+        for (int dy = -padding; dy < image.height + padding; dy++)
+        {
+            int sy = min(max(dy, 0), image.height - 1);
+            uint8_t *dst = layer + ((size_t)(region.y + dy) * layer_size + region.x - padding) * 4;
+            const uint8_t *src = image.rgba.data() + (size_t)sy * image.width * 4;
+            for (int dx = -padding; dx < image.width + padding; dx++, dst += 4)
+            {
+                int sx = min(max(dx, 0), image.width - 1);
+                memcpy(dst, src + sx * 4, 4);
+            }
+        }
+    }
+    return true;
+}
+
+bool TextureAtlas::packDirectory(const string &directory, int layer_size, int padding)
+{
+    vector<string> paths;
+    error_code ec;
+    for (filesystem::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec))
+    {
+        if (it->path().extension() == ".ppm")
+            paths.push_back(it->path().string());
+    }
+    sort(paths.begin(), paths.end());
+    if (paths.empty())
+    {
+        cerr << "No .ppm images in " << directory << "\n";
+        return false;
+    }
+
+    vector<AtlasImage> images(paths.size());
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        images[i].name = filesystem::path(paths[i]).stem().string();
+        if (!read_ppm(paths[i], images[i].width, images[i].height, images[i].rgba))
+            return false;
+    }
+    return pack(images, layer_size, padding);
+}
+
+// foo.atlas -> foo.0.ppm, foo.1.ppm ...
+static string layer_path(const string &atlas_path, int layer)
+{
+    filesystem::path path(atlas_path);
+    return (path.parent_path() / (path.stem().string() + "." + to_string(layer) + ".ppm")).string();
+}
+
+bool TextureAtlas::write(const string &atlas_path) const
+{
+    if (layers.empty())
+    {
+        cerr << "Atlas has no pixels to write (empty or already uploaded)\n";
+        return false;
+    }
+
+    error_code ec;
+    filesystem::path parent = filesystem::path(atlas_path).parent_path();
+    if (!parent.empty())
+        filesystem::create_directories(parent, ec);
+
+    size_t layer_bytes = (size_t)layer_size * layer_size * 4;
+    for (int layer = 0; layer < layer_count; layer++)
+    {
+        if (!write_ppm(layer_path(atlas_path, layer), layer_size, layer_size, layers.data() + layer_bytes * layer, false))
+            return false;
+    }
+
+    ofstream file(atlas_path, ios::trunc);
+    if (!file)
+    {
+        cerr << "Can't write " << atlas_path << "\n";
+        return false;
+    }
+    file << "atlas " << layer_size << " " << layer_count << "\n";
+    for (const AtlasRegion &region : atlas_regions)
+    {
+        file << "region " << region.name << " " << region.layer << " " << region.x << " " << region.y << " "
+             << region.width << " " << region.height << "\n";
+    }
+    if (!file)
+    {
+        cerr << "Can't write " << atlas_path << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool TextureAtlas::read(const string &atlas_path)
+{
+    destroy();
+
+    ifstream file(atlas_path);
+    if (!file)
+    {
+        cerr << "Can't open " << atlas_path << "\n";
+        return false;
+    }
+
+    string line;
+    size_t line_number = 0;
+    size_t image_area = 0;
+    while (getline(file, line))
+    {
+        line_number++;
+        istringstream tokens(line);
+        string command;
+        if (!(tokens >> command) || command[0] == '#')
+            continue;
+
+        bool ok = false;
+        if (command == "atlas")
+        {
+            ok = (bool)(tokens >> layer_size >> layer_count) && layer_size > 0 && layer_count > 0;
+        }
+        else if (command == "region" && layer_size > 0)
+        {
+            AtlasRegion region;
+            ok = (bool)(tokens >> region.name >> region.layer >> region.x >> region.y >> region.width >> region.height) &&
+                 region.layer >= 0 && region.layer < layer_count && region.x >= 0 && region.y >= 0 &&
+                 region.width > 0 && region.height > 0 && region.x + region.width <= layer_size &&
+                 region.y + region.height <= layer_size;
+            if (ok)
+            {
+                computeUVs(region);
+                image_area += (size_t)region.width * region.height;
+                atlas_regions.push_back(region);
+            }
+        }
+        if (!ok)
+        {
+            cerr << atlas_path << ":" << line_number << ": bad atlas line\n";
+            destroy();
+            return false;
+        }
+    }
+    if (layer_count == 0)
+    {
+        cerr << atlas_path << ": not an atlas\n";
+        return false;
+    }
+
+    size_t layer_bytes = (size_t)layer_size * layer_size * 4;
+    layers.resize(layer_bytes * layer_count);
+    for (int layer = 0; layer < layer_count; layer++)
+    {
+        int width = 0, height = 0;
+        vector<uint8_t> rgba;
+        string path = layer_path(atlas_path, layer);
+        if (!read_ppm(path, width, height, rgba) || width != layer_size || height != layer_size)
+        {
+            cerr << path << ": missing or wrong size atlas layer\n";
+            destroy();
+            return false;
+        }
+        memcpy(layers.data() + layer_bytes * layer, rgba.data(), layer_bytes);
+    }
+
+    fill = (float)image_area / ((size_t)layer_size * layer_size * layer_count);
+    return true;
+}
+
+bool TextureAtlas::upload()
+{
+    if (layers.empty())
+        return false;
+
+    GLint max_size = 0, max_layers = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &max_layers);
+    if (layer_size > max_size || layer_count > max_layers)
+    {
+        cerr << "Atlas " << layer_size << "x" << layer_size << "x" << layer_count << " is larger than the driver allows ("
+             << max_size << "x" << max_size << "x" << max_layers << ")\n";
+        return false;
+    }
+
+    texture = GLTexture::create();
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture.get());
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, layer_size, layer_size, layer_count, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                 layers.data());
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    layers.clear();
+    layers.shrink_to_fit();
+    return true;
+}
+
+void TextureAtlas::bind(GLuint unit) const
+{
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture.get());
+    if (unit != 0)
+        glActiveTexture(GL_TEXTURE0);
+}
+
+void TextureAtlas::destroy()
+{
+    texture.reset();
+    atlas_regions.clear();
+    layers.clear();
+    layers.shrink_to_fit();
+    layer_size = 0;
+    layer_count = 0;
+    fill = 0.0f;
+}
+
+const AtlasRegion *TextureAtlas::find(const string &name) const
+{
+    for (const AtlasRegion &region : atlas_regions)
+    {
+        if (region.name == name)
+            return &region;
+    }
+    return nullptr;
+}
+
+bool TextureAtlas::rewriteUVs(Flag &flag) const
+{
+    for (FlagEmblem &emblem : flag.emblems)
+    {
+        const AtlasRegion *region = find(emblem.image);
+        if (!region)
+        {
+            cerr << "No image named " << emblem.image << " in the atlas\n";
+            return false;
+        }
+
+        float width = region->u1 - region->u0;
+        float height = region->v1 - region->v0;
+        emblem.u0 = region->u0 + emblem.u0 * width;
+        emblem.u1 = region->u0 + emblem.u1 * width;
+        emblem.v0 = region->v0 + emblem.v0 * height;
+        emblem.v1 = region->v0 + emblem.v1 * height;
+        emblem.layer = (float)region->layer;
+    }
+    return true;
+}
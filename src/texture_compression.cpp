@@ -0,0 +1,687 @@
+#include "texture_compression.h"
+
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+static const char *format_names[] = {
+    "rgba8",
+    "bc1",
+    "bc3",
+    "rgtc1",
+    "rgtc2",
+};
+
+const char *texture_format_name(TextureFormat format)
+{
+    return (unsigned)format < TEXTURE_FORMAT_COUNT ? format_names[(int)format] : "unknown";
+}
+
+bool parse_texture_format(const char *name, TextureFormat &format)
+{
+    for (unsigned i = 0; i < TEXTURE_FORMAT_COUNT; i++)
+    {
+        if (strcmp(name, format_names[i]) == 0)
+        {
+            format = (TextureFormat)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool texture_format_compressed(TextureFormat format)
+{
+    return format != TextureFormat::RGBA8;
+}
+
+static size_t block_bytes(TextureFormat format)
+{
+    return format == TextureFormat::BC1 || format == TextureFormat::RGTC1 ? 8 : 16;
+}
+
+size_t texture_data_size(TextureFormat format, int width, int height)
+{
+    if (width <= 0 || height <= 0)
+        return 0;
+    if (format == TextureFormat::RGBA8)
+        return (size_t)width * height * 4;
+    return (size_t)((width + 3) / 4) * ((height + 3) / 4) * block_bytes(format);
+}
+
+int texture_max_levels(int width, int height)
+{
+    int levels = 1;
+    for (int size = max(width, height); size > 1; size /= 2)
+        levels++;
+    return levels;
+}
+
+size_t texture_levels_size(TextureFormat format, int width, int height, int levels)
+{
+    size_t total = 0;
+    for (int level = 0; level < levels; level++)
+    {
+        total += texture_data_size(format, width, height);
+        width = max(1, width / 2);
+        height = max(1, height / 2);
+    }
+    return total;
+}
+
+GLenum texture_internal_format(TextureFormat format)
+{
+    switch (format)
+    {
+    case TextureFormat::RGBA8:
+        return GL_RGBA8;
+    case TextureFormat::BC1:
+        return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    case TextureFormat::BC3:
+        return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case TextureFormat::RGTC1:
+        return GL_COMPRESSED_RED_RGTC1;
+    case TextureFormat::RGTC2:
+        return GL_COMPRESSED_RG_RGTC2;
+    }
+    return GL_RGBA8;
+}
+
+static bool has_extension(const char *name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++)
+    {
+        const char *extension = (const char *)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+        if (extension && strcmp(extension, name) == 0)
+            return true;
+    }
+    return false;
+}
+
+bool texture_format_supported(TextureFormat format)
+{
+    // RGTC core من 3.0
+    if (format != TextureFormat::BC1 && format != TextureFormat::BC3)
+        return true;
+
+    // -1 = لسه مسألناش
+    static int s3tc = -1;
+    if (s3tc < 0)
+        s3tc = has_extension("GL_EXT_texture_compression_s3tc") ? 1 : 0;
+    return s3tc == 1;
+}
+
+// ---- BC1 (اللون) -----------------------------------------------------------
+
+static uint16_t pack_565(const float *rgb)
+{
+    int r = (int)(min(max(rgb[0], 0.0f), 255.0f) * 31.0f / 255.0f + 0.5f);
+    int g = (int)(min(max(rgb[1], 0.0f), 255.0f) * 63.0f / 255.0f + 0.5f);
+    int b = (int)(min(max(rgb[2], 0.0f), 255.0f) * 31.0f / 255.0f + 0.5f);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static void unpack_565(uint16_t color, int *rgb)
+{
+    int r = (color >> 11) & 31;
+    int g = (color >> 5) & 63;
+    int b = color & 31;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+// الالوان الاربعة (4-color mode): c0، c1، و نقطتين بينهم
+static void color_palette(uint16_t c0, uint16_t c1, int palette[4][3])
+{
+    unpack_565(c0, palette[0]);
+    unpack_565(c1, palette[1]);
+    for (int i = 0; i < 3; i++)
+    {
+        palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+        palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+    }
+}
+
+// اقرب لون لكل pixel، و مجموع مربع الغلط
+static uint32_t color_indices(const uint8_t *rgba, uint16_t c0, uint16_t c1, int &error)
+{
+    int palette[4][3];
+    color_palette(c0, c1, palette);
+
+    uint32_t indices = 0;
+    error = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        const uint8_t *pixel = rgba + i * 4;
+        int best = 0;
+        int best_distance = 1 << 30;
+        for (int p = 0; p < 4; p++)
+        {
+            int dr = pixel[0] - palette[p][0];
+            int dg = pixel[1] - palette[p][1];
+            int db = pixel[2] - palette[p][2];
+            int distance = dr * dr + dg * dg + db * db;
+            if (distance < best_distance)
+            {
+                best = p;
+                best_distance = distance;
+            }
+        }
+        indices |= (uint32_t)best << (2 * i);
+        error += best_distance;
+    }
+    return indices;
+}
+
+/*
+    اللون في BC1 خط بين لونين (c0 و c1) و كل pixel بياخد واحد من 4 نقط عليه
+        1. الخط في اتجاه ال principal axis للالوان (power iteration علي ال covariance)
+           و الطرفين اول و آخر pixel عليه
+        2. least squares: الطرفين اللي بيقللوا الغلط لل indices اللي طلعت، مرتين
+    بعدها c0 > c1 دايما عشان الدرايفر يقراه 4-color (لو c0 <= c1 يبقي 3 الوان + اسود)
+*/
+static void encode_color_block(const uint8_t *rgba, uint8_t *out)
+{
+    float mean[3] = {0.0f, 0.0f, 0.0f};
+    int low[3] = {255, 255, 255};
+    int high[3] = {0, 0, 0};
+    for (int i = 0; i < 16; i++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            mean[c] += rgba[i * 4 + c];
+            low[c] = min(low[c], (int)rgba[i * 4 + c]);
+            high[c] = max(high[c], (int)rgba[i * 4 + c]);
+        }
+    }
+    for (int c = 0; c < 3; c++)
+        mean[c] /= 16.0f;
+
+    uint16_t c0, c1;
+    uint32_t indices = 0;
+    if (low[0] == high[0] && low[1] == high[1] && low[2] == high[2])
+    {
+        // لون واحد
+        c0 = c1 = pack_565(mean);
+    }
+    else
+    {
+        // covariance: rr rg rb gg gb bb
+        float covariance[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+        for (int i = 0; i < 16; i++)
+        {
+            float r = rgba[i * 4 + 0] - mean[0];
+            float g = rgba[i * 4 + 1] - mean[1];
+            float b = rgba[i * 4 + 2] - mean[2];
+            covariance[0] += r * r;
+            covariance[1] += r * g;
+            covariance[2] += r * b;
+            covariance[3] += g * g;
+            covariance[4] += g * b;
+            covariance[5] += b * b;
+        }
+
+        float axis[3] = {(float)(high[0] - low[0]), (float)(high[1] - low[1]), (float)(high[2] - low[2])};
+        for (int iteration = 0; iteration < 4; iteration++)
+        {
+            float x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+            float y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+            float z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+            float length = max(fabs(x), max(fabs(y), fabs(z)));
+            if (length < 1e-6f)
+                break;
+            axis[0] = x / length;
+            axis[1] = y / length;
+            axis[2] = z / length;
+        }
+
+        int first = 0, last = 0;
+        float first_t = 1e30f, last_t = -1e30f;
+        for (int i = 0; i < 16; i++)
+        {
+            float t = (rgba[i * 4 + 0] - mean[0]) * axis[0] + (rgba[i * 4 + 1] - mean[1]) * axis[1] +
+                      (rgba[i * 4 + 2] - mean[2]) * axis[2];
+            if (t < first_t)
+            {
+                first_t = t;
+                first = i;
+            }
+            if (t > last_t)
+            {
+                last_t = t;
+                last = i;
+            }
+        }
+
+        float end0[3] = {(float)rgba[last * 4 + 0], (float)rgba[last * 4 + 1], (float)rgba[last * 4 + 2]};
+        float end1[3] = {(float)rgba[first * 4 + 0], (float)rgba[first * 4 + 1], (float)rgba[first * 4 + 2]};
+        c0 = pack_565(end0);
+        c1 = pack_565(end1);
+        int error = 0;
+        indices = color_indices(rgba, c0, c1, error);
+
+        // وزن c0 لكل index: 0 -> c0، 1 -> c1، 2 -> 2/3 c0، 3 -> 1/3 c0
+        static const float weights[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+        for (int iteration = 0; iteration < 2 && error > 0; iteration++)
+        {
+            float aa = 0.0f, bb = 0.0f, ab = 0.0f;
+            float ap[3] = {0.0f, 0.0f, 0.0f}, bp[3] = {0.0f, 0.0f, 0.0f};
+            for (int i = 0; i < 16; i++)
+            {
+                float a = weights[(indices >> (2 * i)) & 3];
+                float b = 1.0f - a;
+                aa += a * a;
+                bb += b * b;
+                ab += a * b;
+                for (int c = 0; c < 3; c++)
+                {
+                    ap[c] += a * rgba[i * 4 + c];
+                    bp[c] += b * rgba[i * 4 + c];
+                }
+            }
+
+            float determinant = aa * bb - ab * ab;
+            if (fabs(determinant) < 1e-6f)
+                break;
+            for (int c = 0; c < 3; c++)
+            {
+                end0[c] = (ap[c] * bb - bp[c] * ab) / determinant;
+                end1[c] = (bp[c] * aa - ap[c] * ab) / determinant;
+            }
+
+            uint16_t refined0 = pack_565(end0);
+            uint16_t refined1 = pack_565(end1);
+            int refined_error = 0;
+            uint32_t refined = color_indices(rgba, refined0, refined1, refined_error);
+            if (refined_error >= error)
+                break;
+            c0 = refined0;
+            c1 = refined1;
+            indices = refined;
+            error = refined_error;
+        }
+    }
+
+    if (c0 < c1)
+    {
+        // نفس النقط بالعكس: 0 <-> 1 و 2 <-> 3
+        swap(c0, c1);
+        indices ^= 0x55555555u;
+    }
+    else if (c0 == c1)
+    {
+        // 3-color mode: index 3 اسود، فالكل c0
+        indices = 0;
+    }
+
+    out[0] = (uint8_t)(c0 & 0xFF);
+    out[1] = (uint8_t)(c0 >> 8);
+    out[2] = (uint8_t)(c1 & 0xFF);
+    out[3] = (uint8_t)(c1 >> 8);
+    for (int i = 0; i < 4; i++)
+        out[4 + i] = (uint8_t)(indices >> (8 * i));
+}
+
+static void decode_color_block(const uint8_t *in, uint8_t *rgba)
+{
+    uint16_t c0 = (uint16_t)(in[0] | (in[1] << 8));
+    uint16_t c1 = (uint16_t)(in[2] | (in[3] << 8));
+    uint32_t indices = (uint32_t)in[4] | ((uint32_t)in[5] << 8) | ((uint32_t)in[6] << 16) | ((uint32_t)in[7] << 24);
+
+    int palette[4][3];
+    color_palette(c0, c1, palette);
+    if (c0 <= c1)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+    }
+
+    for (int i = 0; i < 16; i++)
+    {
+        const int *color = palette[(indices >> (2 * i)) & 3];
+        rgba[i * 4 + 0] = (uint8_t)color[0];
+        rgba[i * 4 + 1] = (uint8_t)color[1];
+        rgba[i * 4 + 2] = (uint8_t)color[2];
+    }
+}
+
+// ---- BC4 (قناة واحدة) ------------------------------------------------------
+
+// a0 > a1: a0، a1، و 6 نقط بينهم
+static void channel_palette(int a0, int a1, int palette[8])
+{
+    palette[0] = a0;
+    palette[1] = a1;
+    if (a0 > a1)
+    {
+        for (int i = 2; i < 8; i++)
+            palette[i] = ((8 - i) * a0 + (i - 1) * a1 + 3) / 7;
+    }
+    else
+    {
+        for (int i = 2; i < 6; i++)
+            palette[i] = ((6 - i) * a0 + (i - 1) * a1 + 2) / 5;
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+void encode_bc4_block(const uint8_t *rgba, int channel, uint8_t *out)
+{
+    int low = 255, high = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        low = min(low, (int)rgba[i * 4 + channel]);
+        high = max(high, (int)rgba[i * 4 + channel]);
+    }
+
+    // النقط متساوية علي الخط من low لـ high، فاقرب نقطة = القيمة مقربة لاقرب سبع
+    // مكانها علي الخط (0 = low، 7 = high) و ال index بتاعها: 7 -> 0، 0 -> 1، و الباقي 8 - مكانها
+    uint64_t indices = 0;
+    if (high > low)
+    {
+        int range = high - low;
+        for (int i = 0; i < 16; i++)
+        {
+            int position = ((rgba[i * 4 + channel] - low) * 7 + range / 2) / range;
+            uint64_t index = position == 7 ? 0 : position == 0 ? 1 : (uint64_t)(8 - position);
+            indices |= index << (3 * i);
+        }
+    }
+
+    out[0] = (uint8_t)high;
+    out[1] = (uint8_t)low;
+    for (int i = 0; i < 6; i++)
+        out[2 + i] = (uint8_t)(indices >> (8 * i));
+}
+
+static void decode_bc4_block(const uint8_t *in, int channel, uint8_t *rgba)
+{
+    int palette[8];
+    channel_palette(in[0], in[1], palette);
+
+    uint64_t indices = 0;
+    for (int i = 0; i < 6; i++)
+        indices |= (uint64_t)in[2 + i] << (8 * i);
+    for (int i = 0; i < 16; i++)
+        rgba[i * 4 + channel] = (uint8_t)palette[(indices >> (3 * i)) & 7];
+}
+
+void encode_bc1_block(const uint8_t *rgba, uint8_t *out)
+{
+    encode_color_block(rgba, out);
+}
+
+void encode_bc3_block(const uint8_t *rgba, uint8_t *out)
+{
+    encode_bc4_block(rgba, 3, out);
+    encode_color_block(rgba, out + 8);
+}
+
+// ---- الصورة كلها -----------------------------------------------------------
+
+// ال 4x4 اللي عند (bx, by)، و برا الصورة بنكرر آخر صف و عمود
+static void fetch_block(int width, int height, const uint8_t *rgba, int bx, int by, uint8_t *block)
+{
+    for (int y = 0; y < 4; y++)
+    {
+        int sy = min(by * 4 + y, height - 1);
+        for (int x = 0; x < 4; x++)
+        {
+            int sx = min(bx * 4 + x, width - 1);
+            memcpy(block + (y * 4 + x) * 4, rgba + ((size_t)sy * width + sx) * 4, 4);
+        }
+    }
+}
+
+static void encode_block(TextureFormat format, const uint8_t *block, uint8_t *out)
+{
+    switch (format)
+    {
+    case TextureFormat::BC1:
+        encode_color_block(block, out);
+        break;
+    case TextureFormat::BC3:
+        encode_bc3_block(block, out);
+        break;
+    case TextureFormat::RGTC1:
+        encode_bc4_block(block, 0, out);
+        break;
+    case TextureFormat::RGTC2:
+        encode_bc4_block(block, 0, out);
+        encode_bc4_block(block, 1, out + 8);
+        break;
+    case TextureFormat::RGBA8:
+        break;
+    }
+}
+
+void encode_texture(TextureFormat format, int width, int height, const uint8_t *rgba, vector<uint8_t> &out,
+                    ThreadPool *pool)
+{
+    out.resize(texture_data_size(format, width, height));
+    if (out.empty())
+        return;
+    if (format == TextureFormat::RGBA8)
+    {
+        memcpy(out.data(), rgba, out.size());
+        return;
+    }
+
+    int blocks_x = (width + 3) / 4;
+    int blocks_y = (height + 3) / 4;
+    size_t row_bytes = (size_t)blocks_x * block_bytes(format);
+    auto encode_row = [&](size_t by)
+    {
+        uint8_t block[64];
+        uint8_t *dst = out.data() + by * row_bytes;
+        for (int bx = 0; bx < blocks_x; bx++, dst += block_bytes(format))
+        {
+            fetch_block(width, height, rgba, bx, (int)by, block);
+            encode_block(format, block, dst);
+        }
+    };
+
+    // كل chunk حوالي 256 block عشان ال scheduling ميبقاش اغلي من الشغل
+    if (pool && blocks_y > 1)
+    {
+        pool->parallelFor((size_t)blocks_y, encode_row, (size_t)max(1, 256 / blocks_x));
+    }
+    else
+    {
+        for (int by = 0; by < blocks_y; by++)
+            encode_row((size_t)by);
+    }
+}
+
+void decode_texture(TextureFormat format, int width, int height, const uint8_t *data, vector<uint8_t> &rgba)
+{
+    rgba.assign((size_t)max(width, 0) * max(height, 0) * 4, 0);
+    if (rgba.empty())
+        return;
+    if (format == TextureFormat::RGBA8)
+    {
+        memcpy(rgba.data(), data, rgba.size());
+        return;
+    }
+
+    int blocks_x = (width + 3) / 4;
+    int blocks_y = (height + 3) / 4;
+    const uint8_t *in = data;
+    for (int by = 0; by < blocks_y; by++)
+    {
+        for (int bx = 0; bx < blocks_x; bx++, in += block_bytes(format))
+        {
+            // زي ما ال GPU بيقراهم: R بس = (r, 0, 0, 1)، RG = (r, g, 0, 1)
+            uint8_t block[64] = {};
+            for (int i = 0; i < 16; i++)
+                block[i * 4 + 3] = 255;
+
+            switch (format)
+            {
+            case TextureFormat::BC1:
+                decode_color_block(in, block);
+                break;
+            case TextureFormat::BC3:
+                decode_bc4_block(in, 3, block);
+                decode_color_block(in + 8, block);
+                break;
+            case TextureFormat::RGTC1:
+                decode_bc4_block(in, 0, block);
+                break;
+            case TextureFormat::RGTC2:
+                decode_bc4_block(in, 0, block);
+                decode_bc4_block(in + 8, 1, block);
+                break;
+            case TextureFormat::RGBA8:
+                break;
+            }
+
+            for (int y = 0; y < 4 && by * 4 + y < height; y++)
+            {
+                for (int x = 0; x < 4 && bx * 4 + x < width; x++)
+                    memcpy(&rgba[((size_t)(by * 4 + y) * width + bx * 4 + x) * 4], block + (y * 4 + x) * 4, 4);
+            }
+        }
+    }
+}
+
+// ---- TextureEncoder --------------------------------------------------------
+
+// لو ال encoder اتغير (جودة او شكل) لازم الرقم يزيد عشان ال cache القديم ميتحملش
+static const uint32_t TEXTURE_CACHE_VERSION = 1;
+
+struct TextureCacheHeader
+{
+    char magic[4]; // "TXCE"
+    uint32_t version;
+    uint32_t format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t reserved;
+    uint64_t size;
+};
+
+static double elapsed_ms(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+TextureEncoder::TextureEncoder()
+    : pool(nullptr), cache_hits(0), cache_misses(0), pixels_encoded(0), encode_ms(0.0), load_ms(0.0)
+{
+}
+
+string TextureEncoder::cachePath(TextureFormat format, int width, int height, const uint8_t *rgba) const
+{
+    // FNV-1a زي مفتاح ال shader cache
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](const void *data, size_t length)
+    {
+        const unsigned char *bytes = (const unsigned char *)data;
+        for (size_t i = 0; i < length; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    uint32_t key[4] = {TEXTURE_CACHE_VERSION, (uint32_t)format, (uint32_t)width, (uint32_t)height};
+    mix(key, sizeof(key));
+    mix(rgba, (size_t)width * height * 4);
+
+    char name[48];
+    snprintf(name, sizeof(name), "%016llx.%s", (unsigned long long)hash, texture_format_name(format));
+    return (filesystem::path(cache_directory) / name).string();
+}
+
+bool TextureEncoder::encode(TextureFormat format, int width, int height, const uint8_t *rgba, vector<uint8_t> &out)
+{
+    if (width <= 0 || height <= 0)
+    {
+        cerr << "Can't encode an empty " << width << "x" << height << " texture\n";
+        return false;
+    }
+
+    auto start = chrono::steady_clock::now();
+    size_t size = texture_data_size(format, width, height);
+    string path = cache_directory.empty() ? string() : cachePath(format, width, height, rgba);
+    if (!path.empty())
+    {
+        ifstream file(path, ios::binary);
+        TextureCacheHeader header;
+        if (file && file.read((char *)&header, sizeof(header)) && memcmp(header.magic, "TXCE", 4) == 0 &&
+            header.version == TEXTURE_CACHE_VERSION && header.format == (uint32_t)format &&
+            header.width == (uint32_t)width && header.height == (uint32_t)height && header.size == size)
+        {
+            out.resize(size);
+            if (file.read((char *)out.data(), (streamsize)size))
+            {
+                cache_hits++;
+                load_ms += elapsed_ms(start);
+                return true;
+            }
+        }
+    }
+
+    encode_texture(format, width, height, rgba, out, pool);
+    cache_misses++;
+    pixels_encoded += (size_t)width * height;
+    encode_ms += elapsed_ms(start);
+
+    if (path.empty())
+        return true;
+
+    // ال cache مش لازم: لو الكتابة فشلت بنكمل بال output اللي معانا
+    error_code ec;
+    filesystem::create_directories(cache_directory, ec);
+    string temp_path = path + ".tmp" + to_string(chrono::steady_clock::now().time_since_epoch().count());
+    {
+        TextureCacheHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, "TXCE", 4);
+        header.version = TEXTURE_CACHE_VERSION;
+        header.format = (uint32_t)format;
+        header.width = (uint32_t)width;
+        header.height = (uint32_t)height;
+        header.size = size;
+
+        ofstream file(temp_path, ios::binary | ios::trunc);
+        file.write((const char *)&header, sizeof(header));
+        file.write((const char *)out.data(), (streamsize)out.size());
+        if (!file)
+        {
+            cerr << "Can't write texture cache " << temp_path << "\n";
+            file.close();
+            filesystem::remove(temp_path, ec);
+            return true;
+        }
+    }
+    filesystem::rename(temp_path, path, ec);
+    if (ec)
+        filesystem::remove(temp_path, ec);
+    return true;
+}
+
+void TextureEncoder::printStats(ostream &out) const
+{
+    double megapixels = pixels_encoded / 1e6;
+    out << "Texture encoder: " << cache_misses << " encoded (" << megapixels << " MP in " << encode_ms << " ms, "
+        << (encode_ms > 0.0 ? megapixels / (encode_ms / 1000.0) : 0.0) << " MP/s), " << cache_hits
+        << " from cache (" << load_ms << " ms)\n";
+}
@@ -0,0 +1,247 @@
+#include "thread_pool.h"
+
+#include <utility>
+
+using namespace std;
+
+// الثريد ده worker في انهي pool و رقمه ايه
+static thread_local const ThreadPool *current_pool = nullptr;
+static thread_local size_t current_index = 0;
+
+ThreadPool::ThreadPool(size_t threads)
+    : waiters(0), queued(0), steal_count(0), next_queue(0), stopping(false)
+{
+    start(threads);
+}
+
+ThreadPool::~ThreadPool()
+{
+    stop();
+}
+
+static size_t &shared_threads()
+{
+    static size_t threads = 0;
+    return threads;
+}
+
+void ThreadPool::setSharedThreads(size_t threads)
+{
+    shared_threads() = threads;
+}
+
+ThreadPool &ThreadPool::shared()
+{
+    static ThreadPool pool(shared_threads());
+    return pool;
+}
+
+void ThreadPool::start(size_t threads)
+{
+    stop();
+
+    if (threads == 0)
+        threads = thread::hardware_concurrency();
+    size_t worker_count = threads > 1 ? threads - 1 : 0;
+
+    queues.clear();
+    for (size_t i = 0; i < worker_count + 1; i++)
+        queues.push_back(unique_ptr<WorkQueue>(new WorkQueue()));
+
+    stopping = false;
+    for (size_t i = 0; i < worker_count; i++)
+        workers.push_back(thread(&ThreadPool::run, this, i));
+}
+
+void ThreadPool::stop()
+{
+    {
+        lock_guard<mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (thread &worker : workers)
+        worker.join();
+    workers.clear();
+
+    // اللي فضل في ال queues بنشغله هنا عشان محدش يستني task اتنسي
+    for (size_t i = 0; i < queues.size(); i++)
+    {
+        while (runOne(i))
+        {
+        }
+    }
+}
+
+size_t ThreadPool::currentQueue()
+{
+    if (current_pool == this)
+        return current_index;
+
+    // اللي بيبعت من برا ال pool بيستخدم آخر queue
+    return queues.size() - 1;
+}
+
+void ThreadPool::submit(Task task)
+{
+    if (queues.empty())
+    {
+        task();
+        return;
+    }
+
+    WorkQueue &queue = *queues[currentQueue()];
+    {
+        lock_guard<mutex> lock(queue.mutex);
+        queue.tasks.push_back(move(task));
+    }
+
+    {
+        lock_guard<mutex> lock(sleep_mutex);
+        queued++;
+        // اللي مستني في wait ممكن يساعد في ال task الجديدة
+        if (waiters > 0)
+            task_done.notify_all();
+    }
+    wake.notify_one();
+}
+
+bool ThreadPool::runOne(size_t self)
+{
+    Task task;
+
+    // الاول من آخر ال queue بتاعنا (آخر حاجة حطيناها لسه في ال cache)
+    {
+        WorkQueue &own = *queues[self];
+        lock_guard<mutex> lock(own.mutex);
+        if (!own.tasks.empty())
+        {
+            task = move(own.tasks.back());
+            own.tasks.pop_back();
+        }
+    }
+
+    // مفيش: نسرق من اول queue تاني (اقدم task فيه)
+    for (size_t i = 1; !task && i < queues.size(); i++)
+    {
+        WorkQueue &victim = *queues[(self + i) % queues.size()];
+        lock_guard<mutex> lock(victim.mutex);
+        if (!victim.tasks.empty())
+        {
+            task = move(victim.tasks.front());
+            victim.tasks.pop_front();
+            steal_count++;
+        }
+    }
+
+    if (!task)
+        return false;
+
+    queued--;
+    task();
+
+    // ال task ممكن تكون آخر واحدة حد مستنيها في wait
+    // (تحت ال lock عشان ميفوتهوش لو لسه داخل ينام)
+    lock_guard<mutex> lock(sleep_mutex);
+    if (waiters > 0)
+        task_done.notify_all();
+    return true;
+}
+
+void ThreadPool::run(size_t self)
+{
+    current_pool = this;
+    current_index = self;
+
+    while (true)
+    {
+        if (runOne(self))
+            continue;
+
+        unique_lock<mutex> lock(sleep_mutex);
+        wake.wait(lock, [this] { return stopping || queued.load() > 0; });
+        if (stopping && queued.load() == 0)
+            return;
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const function<void(size_t index)> &body, size_t grain)
+{
+    if (count == 0)
+        return;
+    if (grain == 0)
+        grain = 1;
+
+    // مفيش workers او الشغل صغير: نعمله هنا علي طول
+    if (workers.empty() || count <= grain)
+    {
+        for (size_t i = 0; i < count; i++)
+            body(i);
+        return;
+    }
+
+    // chunks اكتر من ال threads بكتير عشان اللي يخلص بدري يسرق
+    size_t chunks = concurrency() * 4;
+    size_t chunk_size = (count + chunks - 1) / chunks;
+    if (chunk_size < grain)
+        chunk_size = grain;
+    chunks = (count + chunk_size - 1) / chunk_size;
+
+    atomic<size_t> remaining(chunks);
+    for (size_t chunk = 0; chunk < chunks; chunk++)
+    {
+        size_t begin = chunk * chunk_size;
+        size_t end = begin + chunk_size < count ? begin + chunk_size : count;
+        submit([&body, &remaining, begin, end]
+        {
+            for (size_t i = begin; i < end; i++)
+                body(i);
+            remaining--;
+        });
+    }
+
+    // بنساعد لحد ما الكل يخلص
+    wait(remaining);
+}
+
+void ThreadPool::wait(const atomic<size_t> &remaining)
+{
+    size_t self = currentQueue();
+    while (remaining.load() > 0)
+    {
+        if (runOne(self))
+            continue;
+
+        // كل اللي فاضل شغال في threads تانية (مثلا قراية ملفات وقت ال startup)
+        unique_lock<mutex> lock(sleep_mutex);
+        waiters++;
+        task_done.wait(lock, [&] { return remaining.load() == 0 || queued.load() > 0; });
+        waiters--;
+    }
+}
+
+TaskGroup::TaskGroup(ThreadPool &pool)
+    : pool(pool), remaining(0)
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+    wait();
+}
+
+void TaskGroup::run(ThreadPool::Task task)
+{
+    remaining++;
+    pool.submit([this, task]
+    {
+        task();
+        remaining--;
+    });
+}
+
+void TaskGroup::wait()
+{
+    pool.wait(remaining);
+}
@@ -0,0 +1,181 @@
+#include "vertex_layout.h"
+
+#include <cmath>
+#include <cstring>
+
+using namespace std;
+
+static const VertexLayout layouts[] = {
+    {VertexFormat::Pos3F_Col3F, 24, 2, {{0, 3, GL_FLOAT, GL_FALSE, 0}, {1, 3, GL_FLOAT, GL_FALSE, 12}}},
+    {VertexFormat::Pos2F_Col4U8, 12, 2, {{0, 2, GL_FLOAT, GL_FALSE, 0}, {1, 4, GL_UNSIGNED_BYTE, GL_TRUE, 8}}},
+    {VertexFormat::Pos2Half_Col4U8, 8, 2, {{0, 2, GL_HALF_FLOAT, GL_FALSE, 0}, {1, 4, GL_UNSIGNED_BYTE, GL_TRUE, 4}}},
+    {VertexFormat::Pos2Snorm16_Col4U8, 8, 2, {{0, 2, GL_SHORT, GL_TRUE, 0}, {1, 4, GL_UNSIGNED_BYTE, GL_TRUE, 4}}},
+    {VertexFormat::Pos2F_Col4U8_Tex3F, 24, 3,
+     {{0, 2, GL_FLOAT, GL_FALSE, 0}, {1, 4, GL_UNSIGNED_BYTE, GL_TRUE, 8}, {6, 3, GL_FLOAT, GL_FALSE, 12}}},
+};
+
+static const char *format_names[] = {
+    "pos3f_col3f",
+    "pos2f_col4u8",
+    "pos2h_col4u8",
+    "pos2s16_col4u8",
+    "pos2f_col4u8_tex3f",
+};
+
+const VertexLayout &VertexLayout::get(VertexFormat format)
+{
+    return layouts[(int)format];
+}
+
+void VertexLayout::apply(size_t base_offset) const
+{
+    for (int i = 0; i < attribute_count; i++)
+    {
+        const VertexAttribute &attribute = attributes[i];
+        glVertexAttribPointer(attribute.index, attribute.size, attribute.type, attribute.normalized,
+                              stride, (void *)(base_offset + attribute.offset));
+        glEnableVertexAttribArray(attribute.index);
+    }
+}
+
+const char *vertex_format_name(VertexFormat format)
+{
+    return format_names[(int)format];
+}
+
+bool vertex_format_has_texture(VertexFormat format)
+{
+    return format == VertexFormat::Pos2F_Col4U8_Tex3F;
+}
+
+bool parse_vertex_format(const char *name, VertexFormat &format)
+{
+    for (int i = 0; i < (int)(sizeof(format_names) / sizeof(format_names[0])); i++)
+    {
+        if (strcmp(name, format_names[i]) == 0)
+        {
+            format = (VertexFormat)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// تحويل float (32 bit) ل half (16 bit) مع التقريب لأقرب قيمة
+uint16_t float_to_half(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000;
+    int32_t exponent = (int32_t)((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    // NaN و Inf
+    if (((bits >> 23) & 0xFF) == 0xFF)
+        return (uint16_t)(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+
+    // اكبر من اكبر half: Inf
+    if (exponent >= 31)
+        return (uint16_t)(sign | 0x7C00);
+
+    // اصغر من اصغر half طبيعي: denormal او صفر
+    if (exponent <= 0)
+    {
+        if (exponent < -10)
+            return (uint16_t)sign;
+
+        mantissa |= 0x800000;
+        uint32_t shift = (uint32_t)(14 - exponent);
+        uint32_t half_mantissa = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half_mantissa & 1)))
+            half_mantissa++;
+        return (uint16_t)(sign | half_mantissa);
+    }
+
+    uint32_t half = sign | ((uint32_t)exponent << 10) | (mantissa >> 13);
+    uint32_t remainder = mantissa & 0x1FFF;
+    // round to nearest even، و لو المانتيسا فاضت بتزود ال exponent لوحدها
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+        half++;
+    return (uint16_t)half;
+}
+
+static uint8_t pack_unorm8(float value)
+{
+    if (!(value > 0.0f))
+        return 0;
+    if (value >= 1.0f)
+        return 255;
+    return (uint8_t)lrintf(value * 255.0f);
+}
+
+static int16_t pack_snorm16(float value)
+{
+    if (!(value > -1.0f))
+        return -32767;
+    if (value >= 1.0f)
+        return 32767;
+    return (int16_t)lrintf(value * 32767.0f);
+}
+
+void pack_vertices(VertexFormat format, const Vertex *vertices, size_t count, void *out)
+{
+    unsigned char *dst = (unsigned char *)out;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const Vertex &v = vertices[i];
+
+        switch (format)
+        {
+        case VertexFormat::Pos3F_Col3F:
+        {
+            float packed[6] = {v.x, v.y, 0.0f, v.r, v.g, v.b};
+            memcpy(dst, packed, sizeof(packed));
+            dst += sizeof(packed);
+            break;
+        }
+        case VertexFormat::Pos2F_Col4U8:
+        {
+            uint8_t color[4] = {pack_unorm8(v.r), pack_unorm8(v.g), pack_unorm8(v.b), pack_unorm8(v.a)};
+            memcpy(dst, &v.x, sizeof(float));
+            memcpy(dst + 4, &v.y, sizeof(float));
+            memcpy(dst + 8, color, sizeof(color));
+            dst += 12;
+            break;
+        }
+        case VertexFormat::Pos2Half_Col4U8:
+        {
+            uint16_t position[2] = {float_to_half(v.x), float_to_half(v.y)};
+            uint8_t color[4] = {pack_unorm8(v.r), pack_unorm8(v.g), pack_unorm8(v.b), pack_unorm8(v.a)};
+            memcpy(dst, position, sizeof(position));
+            memcpy(dst + 4, color, sizeof(color));
+            dst += 8;
+            break;
+        }
+        case VertexFormat::Pos2Snorm16_Col4U8:
+        {
+            int16_t position[2] = {pack_snorm16(v.x), pack_snorm16(v.y)};
+            uint8_t color[4] = {pack_unorm8(v.r), pack_unorm8(v.g), pack_unorm8(v.b), pack_unorm8(v.a)};
+            memcpy(dst, position, sizeof(position));
+            memcpy(dst + 4, color, sizeof(color));
+            dst += 8;
+            break;
+        }
+        case VertexFormat::Pos2F_Col4U8_Tex3F:
+        {
+            uint8_t color[4] = {pack_unorm8(v.r), pack_unorm8(v.g), pack_unorm8(v.b), pack_unorm8(v.a)};
+            float texture[3] = {v.u, v.v, v.layer};
+            memcpy(dst, &v.x, sizeof(float));
+            memcpy(dst + 4, &v.y, sizeof(float));
+            memcpy(dst + 8, color, sizeof(color));
+            memcpy(dst + 12, texture, sizeof(texture));
+            dst += 24;
+            break;
+        }
+        }
+    }
+}
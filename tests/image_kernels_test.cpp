@@ -0,0 +1,181 @@
+// image kernels (image_kernels.h): كل SIMD level لازم يطلع نفس بايتات ال scalar بالظبط
+// (مقاسات فردية و زوجية، من غير pool و علي ال pool)، و linear -> sRGB8 قدام powf (اكبر فرق درجة)
+// و ال 256 قيمة sRGB8 ترجع زي ما هي. بيرجع غير صفر لو في اختلاف
+// السرعة في bench/image_bench.cpp
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "image_kernels.h"
+#include "thread_pool.h"
+
+using namespace std;
+
+// نفس صورة texture_bench: تدرج + دواير + noise، و alpha متدرج
+static vector<uint8_t> make_image(int width, int height)
+{
+    vector<uint8_t> rgba((size_t)width * height * 4);
+    uint32_t noise = 12345;
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            noise = noise * 1664525u + 1013904223u;
+            float u = (float)x / width, v = (float)y / height;
+            float ring = sinf(sqrtf((u - 0.5f) * (u - 0.5f) + (v - 0.5f) * (v - 0.5f)) * 40.0f);
+            int grain = (int)(noise >> 28) - 8;
+
+            uint8_t *pixel = &rgba[((size_t)y * width + x) * 4];
+            pixel[0] = (uint8_t)min(max((int)(u * 255.0f) + grain, 0), 255);
+            pixel[1] = (uint8_t)min(max((int)(128.0f + ring * 100.0f) + grain, 0), 255);
+            pixel[2] = (uint8_t)min(max((int)(v * 255.0f) + grain, 0), 255);
+            pixel[3] = (uint8_t)(ring > 0.0f ? 255 : (int)(v * 255.0f));
+        }
+    }
+    return rgba;
+}
+
+// كل اللي بيطلع من ال kernels لصورة واحدة، عشان نقارن ال levels ببعض
+struct KernelOutputs
+{
+    vector<float> linear;
+    vector<float> premultiplied;
+    vector<uint8_t> encoded;
+    vector<float> resized;
+    vector<float> downsampled;
+    vector<ImageLevel> levels;
+};
+
+static void run_kernels(const vector<uint8_t> &image, int width, int height, ThreadPool *pool, KernelOutputs &out)
+{
+    size_t pixels = (size_t)width * height;
+    out.linear.resize(pixels * 4);
+    srgb_to_linear(image.data(), out.linear.data(), pixels, pool);
+
+    out.premultiplied = out.linear;
+    premultiply_alpha(out.premultiplied.data(), pixels, pool);
+
+    out.encoded.resize(pixels * 4);
+    linear_to_srgb(out.premultiplied.data(), out.encoded.data(), pixels, pool);
+
+    // تصغير بنسبة مش صحيحة و تكبير في الاتجاه التاني
+    int resized_width = max(1, width * 2 / 3), resized_height = height + height / 2;
+    out.resized.resize((size_t)resized_width * resized_height * 4);
+    resize_image(out.linear.data(), width, height, out.resized.data(), resized_width, resized_height, pool);
+
+    downsample_image(out.linear.data(), width, height, out.downsampled, pool);
+    build_image_levels(image.data(), width, height, max(width, height) - 1, true, true, out.levels, pool);
+}
+
+template <typename T>
+static bool same(const vector<T> &a, const vector<T> &b)
+{
+    return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+}
+
+static bool compare(const KernelOutputs &a, const KernelOutputs &b, string &what)
+{
+    if (!same(a.linear, b.linear))
+        what = "srgb_to_linear";
+    else if (!same(a.premultiplied, b.premultiplied))
+        what = "premultiply_alpha";
+    else if (!same(a.encoded, b.encoded))
+        what = "linear_to_srgb";
+    else if (!same(a.resized, b.resized))
+        what = "resize_image";
+    else if (!same(a.downsampled, b.downsampled))
+        what = "downsample_image";
+    else if (a.levels.size() != b.levels.size())
+        what = "build_image_levels";
+    else
+    {
+        for (size_t i = 0; i < a.levels.size(); i++)
+        {
+            if (!same(a.levels[i].rgba, b.levels[i].rgba))
+                what = "build_image_levels";
+        }
+    }
+    return what.empty();
+}
+
+// الغلط بتاع ال table قدام powf علي قيم كتير بين 0 و 1، و ال round trip لل 256 قيمة
+static bool check_srgb()
+{
+    const size_t samples = 1 << 20;
+    vector<float> linear(samples);
+    for (size_t i = 0; i < samples; i++)
+        linear[i] = (float)i / (samples - 1);
+    vector<uint8_t> encoded(samples);
+    linear_to_srgb(linear.data(), encoded.data(), samples / 4);
+
+    int max_error = 0;
+    for (size_t i = 0; i < samples; i++)
+    {
+        if (i % 4 == 3)
+            continue; // alpha
+        float x = linear[i];
+        float srgb = x <= 0.0031308f ? x * 12.92f : 1.055f * powf(x, 1.0f / 2.4f) - 0.055f;
+        max_error = max(max_error, abs((int)encoded[i] - (int)(srgb * 255.0f + 0.5f)));
+    }
+
+    uint8_t values[256 * 4];
+    for (int i = 0; i < 256 * 4; i++)
+        values[i] = (uint8_t)(i / 4);
+    float decoded[256 * 4];
+    uint8_t round_trip[256 * 4];
+    srgb_to_linear(values, decoded, 256);
+    linear_to_srgb(decoded, round_trip, 256);
+    bool exact = memcmp(values, round_trip, sizeof(values)) == 0;
+
+    cout << "  sRGB encode max error " << max_error << ", round trip " << (exact ? "exact" : "DIFFERS") << "\n";
+    return max_error <= 1 && exact;
+}
+
+int main()
+{
+    ThreadPool &pool = ThreadPool::shared();
+    SimdLevel best = simd_detect();
+    cout << "Image kernels (best " << simd_level_name(best) << ", " << pool.concurrency() << " threads):\n";
+
+    int exit_code = 0;
+    simd_set_level(SimdLevel::Scalar);
+    if (!check_srgb())
+        exit_code = -1;
+
+    // المقاسات الصغيرة الفردية بتختبر الاطراف و ال tails بتاعة ال SIMD
+    const int sizes[][2] = {{1, 1}, {3, 5}, {17, 9}, {64, 64}, {257, 130}};
+    for (const auto &dimensions : sizes)
+    {
+        int width = dimensions[0], height = dimensions[1];
+        vector<uint8_t> image = make_image(width, height);
+        KernelOutputs reference;
+        simd_set_level(SimdLevel::Scalar);
+        run_kernels(image, width, height, nullptr, reference);
+
+        for (int level = (int)SimdLevel::Scalar; level <= (int)best; level++)
+        {
+            simd_set_level((SimdLevel)level);
+            for (ThreadPool *threads : {(ThreadPool *)nullptr, &pool})
+            {
+                KernelOutputs outputs;
+                run_kernels(image, width, height, threads, outputs);
+                string what;
+                if (!compare(reference, outputs, what))
+                {
+                    cerr << simd_level_name((SimdLevel)level) << (threads ? " (pool)" : "") << ": " << what
+                         << " differs from scalar at " << width << "x" << height << "\n";
+                    exit_code = -1;
+                }
+            }
+        }
+    }
+    simd_set_level(best);
+    if (exit_code == 0)
+        cout << "  all levels match scalar\n";
+    return exit_code;
+}
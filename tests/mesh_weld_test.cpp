@@ -0,0 +1,104 @@
+// MeshBuilder: المثلثات بعد ال welding لازم تغطي نفس اللي كان بيترسم قبلها
+// بنفك ال indices تاني لمثلثات و نقارنها بال array الاصلي بتاع علم الغابون (18 نقطة، glDrawArrays)
+// مبيعملش اي GL، بيرجع غير صفر لو في اختلاف
+
+#include <iostream>
+#include <cstring>
+#include <vector>
+
+#include "flag.h"
+#include "mesh.h"
+
+using namespace std;
+
+static const float width = 0.8f;
+static const float height_top = 0.75f;
+static const float height_middle1 = 0.25f;
+static const float height_middle2 = -0.25f;
+static const float height_bottom = -0.75f;
+
+// ال array زي ما كان في main قبل ال MeshBuilder
+// الترتيب: X, Y, Z (Position) | R, G, B (Color)
+static const float original_vertices[] = {
+    // === 1. الشريط العلوي (أخضر) ===
+    -width, height_middle1, 0.0f,   0.0f, 0.6f, 0.3f, // BL
+     width, height_middle1, 0.0f,   0.0f, 0.6f, 0.3f, // BR
+    -width, height_top,  0.0f,   0.0f, 0.6f, 0.3f, // TL
+     width, height_top,  0.0f,   0.0f, 0.6f, 0.3f, // TR
+    -width, height_top,  0.0f,   0.0f, 0.6f, 0.3f, // TL
+     width, height_middle1, 0.0f,   0.0f, 0.6f, 0.3f, // BR
+
+    // === 2. الشريط الأوسط (أصفر) ===
+    -width, height_middle2, 0.0f,   1.0f, 0.8f, 0.0f, // BL
+     width, height_middle2, 0.0f,   1.0f, 0.8f, 0.0f, // BR
+    -width, height_middle1, 0.0f,   1.0f, 0.8f, 0.0f, // TL
+     width, height_middle1, 0.0f,   1.0f, 0.8f, 0.0f, // TR
+    -width, height_middle1, 0.0f,   1.0f, 0.8f, 0.0f, // TL
+     width, height_middle2, 0.0f,   1.0f, 0.8f, 0.0f, // BR
+
+    // === 3. الشريط السفلي (أزرق) ===
+    -width, height_bottom,  0.0f,   0.0f, 0.3f, 0.7f, // BL
+     width, height_bottom,  0.0f,   0.0f, 0.3f, 0.7f, // BR
+    -width, height_middle2, 0.0f,   0.0f, 0.3f, 0.7f, // TL
+     width, height_middle2, 0.0f,   0.0f, 0.3f, 0.7f, // TR
+    -width, height_middle2, 0.0f,   0.0f, 0.3f, 0.7f, // TL
+     width, height_bottom,  0.0f,   0.0f, 0.3f, 0.7f, // BR
+};
+
+static const size_t original_count = sizeof(original_vertices) / (6 * sizeof(float));
+
+static vector<Vertex> original_triangles()
+{
+    vector<Vertex> triangles;
+    for (size_t i = 0; i < original_count; i++)
+    {
+        const float *v = original_vertices + i * 6;
+        triangles.push_back({v[0], v[1], v[3], v[4], v[5], 1.0f});
+    }
+    return triangles;
+}
+
+// كل index بيرجع النقطة بتاعته، فالناتج triangle list زي اللي دخل
+static vector<Vertex> expand(const MeshBuilder &builder)
+{
+    vector<Vertex> triangles;
+    for (uint32_t index : builder.indices())
+        triangles.push_back(builder.vertices()[index]);
+    return triangles;
+}
+
+static bool check(const char *name, const MeshBuilder &builder, const vector<Vertex> &expected)
+{
+    vector<Vertex> triangles = expand(builder);
+    bool ok = builder.vertices().size() == 12 && builder.indices().size() == expected.size() &&
+              memcmp(triangles.data(), expected.data(), expected.size() * sizeof(Vertex)) == 0;
+    if (!ok)
+    {
+        cerr << name << ": " << builder.vertices().size() << " vertices and " << builder.indices().size()
+             << " indices don't reproduce the original " << expected.size() << "-vertex triangle array\n";
+    }
+    return ok;
+}
+
+int main()
+{
+    vector<Vertex> expected = original_triangles();
+
+    // نفس ال array داخل زي ما هو
+    MeshBuilder from_array;
+    from_array.addTriangles(expected.data(), expected.size());
+
+    // و العلم زي ما main بيبنيه
+    MeshBuilder from_flag;
+    from_flag.addFlag(make_gabon_flag(width, height_top, height_middle1, height_middle2, height_bottom), 0.0f, 0.0f,
+                      1.0f);
+
+    bool ok = check("addTriangles", from_array, expected);
+    ok = check("addFlag", from_flag, expected) && ok;
+    if (!ok)
+        return -1;
+
+    cout << "Gabon flag: " << expected.size() << " vertices welded to " << from_flag.vertices().size()
+         << " + " << from_flag.indices().size() << " indices, same triangles\n";
+    return 0;
+}
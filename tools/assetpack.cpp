@@ -0,0 +1,197 @@
+// assetpack: بيجمع meshes و textures في asset pack واحد (asset_pack.h) يتحمل بـ AssetLoader
+//     ./assetpack -o assets.pak [--format pos2f_col4u8] [--texture-format bc1] [--mips] assets/flags logo.ppm ...
+// ملف .flag (او directory فيه ملفات .flag): mesh لكل علم باسمه
+// صورة .ppm: texture باسم الملف من غير ال extension
+// ال textures المضغوطة بتتعمل encode علي كل ال cores و بتتحفظ في --texture-cache (texture_cache)
+// فالصور اللي متغيرتش مبتتعملش encode تاني
+// --max-size و --mips و --premultiply بيجهزوا الصورة الاول (image_kernels.h، SIMD و علي كل ال cores)
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "asset_pack.h"
+#include "flag_format.h"
+#include "image_kernels.h"
+#include "image_writer.h"
+#include "texture_compression.h"
+#include "thread_pool.h"
+#include "vertex_layout.h"
+
+using namespace std;
+
+static void usage(const char *program)
+{
+    cerr << "Usage: " << program << " -o OUTPUT"
+         << " [--format pos3f_col3f|pos2f_col4u8|pos2h_col4u8|pos2s16_col4u8|pos2f_col4u8_tex3f]"
+         << " [--texture-format rgba8|bc1|bc3|rgtc1|rgtc2] [--texture-cache DIR]"
+         << " [--max-size N] [--mips] [--premultiply]"
+         << " (DIR | FILE.flag | FILE.ppm)...\n";
+}
+
+// تجهيز الصورة قبل ال encoding
+struct ImageOptions
+{
+    int max_size = 0;
+    bool mips = false;
+    bool premultiply = false;
+};
+
+// كل level بيتعمله encode لوحده (و ليه cache لوحده) و ال levels ورا بعض في asset واحد
+static bool add_texture(AssetPackWriter &writer, const string &path, TextureFormat texture_format,
+                        const ImageOptions &options, TextureEncoder &encoder)
+{
+    int width = 0, height = 0;
+    vector<uint8_t> rgba;
+    if (!read_ppm(path, width, height, rgba))
+        return false;
+
+    vector<ImageLevel> levels;
+    build_image_levels(rgba.data(), width, height, options.max_size, options.mips, options.premultiply, levels,
+                       &ThreadPool::shared());
+
+    vector<uint8_t> data, level_data;
+    for (const ImageLevel &level : levels)
+    {
+        if (!encoder.encode(texture_format, level.width, level.height, level.rgba.data(), level_data))
+            return false;
+        data.insert(data.end(), level_data.begin(), level_data.end());
+    }
+    return writer.addTexture(filesystem::path(path).stem().string(), levels[0].width, levels[0].height, data.data(),
+                             texture_format, (int)levels.size());
+}
+
+static bool add_file(AssetPackWriter &writer, const string &path, VertexFormat format, TextureFormat texture_format,
+                     const ImageOptions &options, TextureEncoder &encoder)
+{
+    filesystem::path file(path);
+    if (file.extension() == ".flag")
+    {
+        vector<FlagDescription> flags;
+        if (!parse_flag_file(path, flags))
+            return false;
+        for (const FlagDescription &flag : flags)
+        {
+            if (!writer.addMesh(flag.name, flag.mesh, format))
+                return false;
+        }
+        return true;
+    }
+
+    if (file.extension() == ".ppm")
+        return add_texture(writer, path, texture_format, options, encoder);
+
+    cerr << path << ": unknown asset type (expected .flag or .ppm)\n";
+    return false;
+}
+
+int main(int argc, char **argv)
+{
+    string output;
+    VertexFormat format = VertexFormat::Pos2F_Col4U8;
+    TextureFormat texture_format = TextureFormat::RGBA8;
+    string texture_cache = "texture_cache";
+    ImageOptions image_options;
+    vector<string> sources;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (arg == "--format" && i + 1 < argc)
+        {
+            if (!parse_vertex_format(argv[++i], format))
+            {
+                usage(argv[0]);
+                return -1;
+            }
+        }
+        else if (arg == "--texture-format" && i + 1 < argc)
+        {
+            if (!parse_texture_format(argv[++i], texture_format))
+            {
+                usage(argv[0]);
+                return -1;
+            }
+        }
+        else if (arg == "--texture-cache" && i + 1 < argc)
+        {
+            texture_cache = argv[++i];
+        }
+        else if (arg == "--max-size" && i + 1 < argc)
+        {
+            image_options.max_size = atoi(argv[++i]);
+            if (image_options.max_size <= 0)
+            {
+                usage(argv[0]);
+                return -1;
+            }
+        }
+        else if (arg == "--mips")
+        {
+            image_options.mips = true;
+        }
+        else if (arg == "--premultiply")
+        {
+            image_options.premultiply = true;
+        }
+        else if (!arg.empty() && arg[0] != '-')
+        {
+            // directory: كل ال .flag و ال .ppm اللي فيه مترتبين بالاسم
+            error_code ec;
+            if (filesystem::is_directory(arg, ec))
+            {
+                vector<string> files;
+                for (filesystem::directory_iterator it(arg, ec), end; !ec && it != end; it.increment(ec))
+                {
+                    string extension = it->path().extension().string();
+                    if (extension == ".flag" || extension == ".ppm")
+                        files.push_back(it->path().string());
+                }
+                sort(files.begin(), files.end());
+                sources.insert(sources.end(), files.begin(), files.end());
+            }
+            else
+            {
+                sources.push_back(arg);
+            }
+        }
+        else
+        {
+            usage(argv[0]);
+            return -1;
+        }
+    }
+
+    if (output.empty() || sources.empty())
+    {
+        usage(argv[0]);
+        return -1;
+    }
+
+    // RGBA8 مفيهوش encoding فمش محتاج cache
+    TextureEncoder encoder;
+    encoder.setThreadPool(&ThreadPool::shared());
+    if (texture_format_compressed(texture_format))
+        encoder.setCacheDirectory(texture_cache);
+
+    AssetPackWriter writer;
+    for (const string &source : sources)
+    {
+        if (!add_file(writer, source, format, texture_format, image_options, encoder))
+            return -1;
+    }
+    if (!writer.write(output))
+        return -1;
+
+    cout << "Packed " << writer.count() << " assets from " << sources.size() << " files to " << output << "\n";
+    if (texture_format_compressed(texture_format) && encoder.hits() + encoder.misses() > 0)
+        encoder.printStats(cout);
+    return 0;
+}
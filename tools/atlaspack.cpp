@@ -0,0 +1,92 @@
+// atlaspack: بيرص صور .ppm في TextureAtlas (texture_atlas.h) قبل التشغيل
+// بيكتب ملف .atlas و PPM لكل layer جنبه، و ال app بيقراهم بـ --emblems من غير ما يرص تاني
+//     ./atlaspack -o emblems.atlas [--size 1024] [--padding 2] assets/emblems logo.ppm ...
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "image_writer.h"
+#include "texture_atlas.h"
+
+using namespace std;
+
+static void usage(const char *program)
+{
+    cerr << "Usage: " << program << " -o OUTPUT.atlas [--size N] [--padding P] (DIR | FILE.ppm)...\n";
+}
+
+int main(int argc, char **argv)
+{
+    string output;
+    int layer_size = 1024;
+    int padding = 2;
+    vector<string> sources;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (arg == "--size" && i + 1 < argc)
+        {
+            layer_size = atoi(argv[++i]);
+        }
+        else if (arg == "--padding" && i + 1 < argc)
+        {
+            padding = atoi(argv[++i]);
+        }
+        else if (!arg.empty() && arg[0] != '-')
+        {
+            // directory: كل ال .ppm اللي فيه مترتبين بالاسم
+            error_code ec;
+            if (filesystem::is_directory(arg, ec))
+            {
+                vector<string> files;
+                for (filesystem::directory_iterator it(arg, ec), end; !ec && it != end; it.increment(ec))
+                {
+                    if (it->path().extension() == ".ppm")
+                        files.push_back(it->path().string());
+                }
+                sort(files.begin(), files.end());
+                sources.insert(sources.end(), files.begin(), files.end());
+            }
+            else
+            {
+                sources.push_back(arg);
+            }
+        }
+        else
+        {
+            usage(argv[0]);
+            return -1;
+        }
+    }
+
+    if (output.empty() || sources.empty() || layer_size <= 0 || padding < 0)
+    {
+        usage(argv[0]);
+        return -1;
+    }
+
+    vector<AtlasImage> images(sources.size());
+    for (size_t i = 0; i < sources.size(); i++)
+    {
+        images[i].name = filesystem::path(sources[i]).stem().string();
+        if (!read_ppm(sources[i], images[i].width, images[i].height, images[i].rgba))
+            return -1;
+    }
+
+    TextureAtlas atlas;
+    if (!atlas.pack(images, layer_size, padding) || !atlas.write(output))
+        return -1;
+
+    cout << "Packed " << images.size() << " images in " << atlas.layerCount() << " layers of " << layer_size << "x"
+         << layer_size << " (" << atlas.occupancy() * 100.0f << "% used) to " << output << "\n";
+    return 0;
+}
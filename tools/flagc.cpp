@@ -0,0 +1,91 @@
+// flagc: بيترجم ملفات .flag لـ flag blob واحد (flag_format.h) قبل التشغيل
+// نفس اللي FlagLibrary::load بيعمله لوحده في flag_cache، بس offline (مثلا في ال build او ال packaging)
+//     ./flagc -o flags.bin [--format pos2f_col4u8] assets/flags
+//     ./flagc -o flags.bin gabon.flag france.flag ...
+
+#include <iostream>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "flag_format.h"
+#include "vertex_layout.h"
+
+using namespace std;
+
+static void usage(const char *program)
+{
+    cerr << "Usage: " << program << " -o OUTPUT"
+         << " [--format pos3f_col3f|pos2f_col4u8|pos2h_col4u8|pos2s16_col4u8|pos2f_col4u8_tex3f]"
+         << " (DIR | FILE.flag)...\n";
+}
+
+int main(int argc, char **argv)
+{
+    string output;
+    VertexFormat format = VertexFormat::Pos2F_Col4U8;
+    vector<string> sources;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (arg == "--format" && i + 1 < argc)
+        {
+            if (!parse_vertex_format(argv[++i], format))
+            {
+                usage(argv[0]);
+                return -1;
+            }
+        }
+        else if (!arg.empty() && arg[0] != '-')
+        {
+            // directory: كل ال .flag اللي فيه
+            error_code ec;
+            if (filesystem::is_directory(arg, ec))
+            {
+                vector<string> files = list_flag_files(arg);
+                sources.insert(sources.end(), files.begin(), files.end());
+            }
+            else
+            {
+                sources.push_back(arg);
+            }
+        }
+        else
+        {
+            usage(argv[0]);
+            return -1;
+        }
+    }
+
+    if (output.empty() || sources.empty())
+    {
+        usage(argv[0]);
+        return -1;
+    }
+
+    vector<FlagDescription> flags;
+    for (const string &source : sources)
+    {
+        if (!parse_flag_file(source, flags))
+            return -1;
+    }
+
+    // نفس المفتاح اللي FlagLibrary::load بيقارنه، فال blob ده ينفع cache لنفس ال directory
+    if (!write_flag_blob(output, flags, format, flag_sources_key(sources)))
+        return -1;
+
+    size_t vertices = 0, indices = 0;
+    for (const FlagDescription &flag : flags)
+    {
+        vertices += flag.mesh.vertices().size();
+        indices += flag.mesh.indices().size();
+    }
+    cout << "Compiled " << flags.size() << " flags (" << vertices << " vertices, " << indices << " indices, "
+         << vertex_format_name(format) << ") to " << output << "\n";
+    return 0;
+}